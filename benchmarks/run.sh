@@ -0,0 +1,47 @@
+#!/bin/sh
+# Compare execution engines on the programs in this directory.
+#
+#   sh benchmarks/run.sh [repeats]
+#
+# Each program reads its problem size n from stdin and is run for several
+# n under --tree-walk, the default TIR path and --old-ir.  The table shows
+# the best wall time in milliseconds over [repeats] runs (default 3);
+# "err" marks a run that failed.  Small n shows startup cost, large n
+# per-operation speed — where the tree-walk column stops winning is the
+# crossover point.
+
+cd "$(dirname "$0")" || exit 1
+TL=../tinylang
+REPEATS=${1:-3}
+
+[ -x "$TL" ] || { echo "build tinylang first (make)"; exit 1; }
+
+# best_ms <file> <n> [flags...]
+best_ms() {
+    file=$1; n=$2; shift 2
+    best=
+    r=0
+    while [ "$r" -lt "$REPEATS" ]; do
+        t0=$(date +%s%N)
+        echo "$n" | "$TL" "$file" "$@" > /dev/null 2>&1 || { echo err; return; }
+        t1=$(date +%s%N)
+        ms=$(( (t1 - t0) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+        r=$((r + 1))
+    done
+    echo "$best"
+}
+
+row() {
+    file=$1; n=$2
+    printf "%-12s %8s %10s %10s %10s\n" "$file" "$n" \
+        "$(best_ms "$file" "$n" --tree-walk)" \
+        "$(best_ms "$file" "$n")" \
+        "$(best_ms "$file" "$n" --old-ir)"
+}
+
+printf "%-12s %8s %10s %10s %10s\n" program n tree-walk tir old-ir
+row startup.tl 0
+for n in 10 1000 10000 100000; do row loop.tl "$n"; done
+for n in 5 10 15 20;            do row fib.tl "$n"; done
+for n in 10 1000 10000 100000; do row objects.tl "$n"; done
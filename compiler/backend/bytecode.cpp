@@ -1,205 +1,874 @@
 #include "bytecode.hpp"
+#include "irresolve.hpp"
 #include <fstream>
 #include <unordered_map>
+#include <unordered_set>
 #include <stdexcept>
 #include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // ─────────────────────────────────────────────────────────────────────────────
-// File format: TinyLang Bytecode (.tlc)
+// File format: TinyLang Bytecode (.tlc), version 2
 //
-//   [4] magic  = 0x544C4243  ("TLBC")
-//   [2] version = 1
-//   [string pool]
-//   [class table]
-//   [function table]
-//   [main instructions]
+//   Header (16 bytes)
+//     [4] magic     = 0x544C4243  ("TLBC")
+//     [2] version   = 2
+//     [2] IR kind   = 0 stack IR (IRVM) · 1 TIR (TIRVM)
+//     [4] nsections
+//     [4] checksum  — FNV-1a 32 of every byte after the header
+//   Section table: nsections × { [4] id  [4] offset  [4] size }
+//     offsets are from the start of the file
+//   Sections
+//     STRS  string pool:  count, then (len, bytes) per string
+//     CLAS  classes:      count, then name, base, nfields, (type, name)…
+//     FUNC  functions:    count, then per function
+//             name, class, nparams, (type, name)…,
+//             numSlots, paramSlots…, nfieldSlots, fieldSlots…,
+//             code offset (into CODE), instruction count
+//     MAIN  main:         numSlots, code offset, instruction count
+//     CODE  instruction streams, one per function plus main
 //
-// All multi-byte integers are little-endian.
-// Each IRInstr on disk:
-//   [1] opcode   [4] sval_pool_idx  [4] ival  [8] dval  [1] cval  = 18 bytes
+// Integers inside sections are LEB128 varints (signed values zigzag-encoded);
+// strings are referenced by pool index everywhere.  Code is stored in the
+// form IRVM executes — after resolveForVM: slot-indexed locals, LABELs
+// stripped, jump targets as instruction indices — so loading is a single
+// decode pass with no resolution work.  Each instruction is
+//   [1] opcode  [1] operand mask  [operands present in the mask]
+// mask bit 0: sidx (varint)  bit 1: ival (zigzag)  bit 2: dval (8 bytes)
+//      bit 3: cval (1 byte)
+//
+// A TIR file has STRS, CLAS, FUNC and MAIN sections in the same framing but
+// with TIR records (see encodeTIRFunc); its code is the register-based
+// TIR::Program exactly as TIRGen produced it.
+//
+// Files are read through mmap.  Version 1 files (fixed 18-byte instruction
+// records, name-based code) are still accepted; the driver resolves them
+// after loading.
 // ─────────────────────────────────────────────────────────────────────────────
 
-static constexpr uint32_t MAGIC   = 0x544C4243u; // "TLBC"
-static constexpr uint16_t VERSION = 1;
-static constexpr uint32_t NO_STR  = 0xFFFFFFFFu; // sentinel for empty sval
+static constexpr uint32_t MAGIC      = 0x544C4243u; // "TLBC"
+static constexpr uint16_t VERSION    = 2;
+static constexpr uint16_t VERSION_V1 = 1;
+static constexpr uint32_t NO_STR     = 0xFFFFFFFFu; // v1 sentinel for empty sval
+static constexpr size_t   HEADER_SIZE = 16;
+static constexpr uint16_t KIND_STACK = 0;
+static constexpr uint16_t KIND_TIR   = 1;
+
+static constexpr uint32_t sectionId(const char (&s)[5]) {
+    return (uint32_t)(uint8_t)s[0]         | (uint32_t)(uint8_t)s[1] << 8 |
+           (uint32_t)(uint8_t)s[2] << 16   | (uint32_t)(uint8_t)s[3] << 24;
+}
+static constexpr uint32_t SEC_STRS = sectionId("STRS");
+static constexpr uint32_t SEC_CLAS = sectionId("CLAS");
+static constexpr uint32_t SEC_FUNC = sectionId("FUNC");
+static constexpr uint32_t SEC_MAIN = sectionId("MAIN");
+static constexpr uint32_t SEC_CODE = sectionId("CODE");
+
+enum : uint8_t { HAS_S = 1, HAS_I = 2, HAS_D = 4, HAS_C = 8, HAS_A = 16 };
+
+static uint32_t fnv1a(const uint8_t* p, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 16777619u; }
+    return h;
+}
 
-// ── low-level I/O ─────────────────────────────────────────────────────────────
+// ── Encoding ──────────────────────────────────────────────────────────────────
 
-static void wu8 (std::ofstream& f, uint8_t  v) { f.write(reinterpret_cast<char*>(&v), 1); }
-static void wu32(std::ofstream& f, uint32_t v) { f.write(reinterpret_cast<char*>(&v), 4); }
-static void wu16(std::ofstream& f, uint16_t v) { f.write(reinterpret_cast<char*>(&v), 2); }
-static void wf64(std::ofstream& f, double   v) { f.write(reinterpret_cast<char*>(&v), 8); }
-static void wstr(std::ofstream& f, const std::string& s) {
-    wu32(f, (uint32_t)s.size());
-    f.write(s.data(), (std::streamsize)s.size());
-}
+namespace {
 
-static uint8_t  ru8 (std::ifstream& f) { uint8_t  v; f.read(reinterpret_cast<char*>(&v), 1); return v; }
-static uint32_t ru32(std::ifstream& f) { uint32_t v; f.read(reinterpret_cast<char*>(&v), 4); return v; }
-static uint16_t ru16(std::ifstream& f) { uint16_t v; f.read(reinterpret_cast<char*>(&v), 2); return v; }
-static double   rf64(std::ifstream& f) { double   v; f.read(reinterpret_cast<char*>(&v), 8); return v; }
-static std::string rstr(std::ifstream& f) {
-    uint32_t len = ru32(f);
-    std::string s(len, '\0');
-    if (len > 0) f.read(s.data(), len);
-    return s;
-}
+struct Writer {
+    std::string buf;
 
-// ── String pool (constant pool for all string operands) ───────────────────────
+    void u8 (uint8_t v)  { buf.push_back((char)v); }
+    void u16(uint16_t v) { buf.append(reinterpret_cast<const char*>(&v), 2); }
+    void u32(uint32_t v) { buf.append(reinterpret_cast<const char*>(&v), 4); }
+    void f64(double v)   { buf.append(reinterpret_cast<const char*>(&v), 8); }
+    void var(uint64_t v) {
+        while (v >= 0x80) { u8((uint8_t)(v | 0x80)); v >>= 7; }
+        u8((uint8_t)v);
+    }
+    void svar(int64_t v) { var(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); }
+    void bytes(const std::string& s) { var(s.size()); buf.append(s); }
+};
 
+// Pool of the program's interned strings plus metadata names.
 struct StringPool {
-    std::vector<std::string>                    strs;
-    std::unordered_map<std::string, uint32_t>   idx;
+    std::vector<std::string>                  strs;
+    std::unordered_map<std::string, uint32_t> idx;
 
+    explicit StringPool(const std::vector<std::string>& base) : strs(base) {
+        for (uint32_t i = 0; i < strs.size(); ++i) idx.emplace(strs[i], i);
+    }
     uint32_t intern(const std::string& s) {
-        if (s.empty()) return NO_STR;
-        auto it = idx.find(s);
-        if (it != idx.end()) return it->second;
-        uint32_t i = (uint32_t)strs.size();
-        strs.push_back(s);
-        idx[s] = i;
-        return i;
+        auto [it, added] = idx.emplace(s, (uint32_t)strs.size());
+        if (added) strs.push_back(s);
+        return it->second;
     }
 };
 
-// ── Instruction encode / decode ───────────────────────────────────────────────
-
-static void writeInstr(std::ofstream& f, const IRInstr& ins, StringPool& pool) {
-    wu8 (f, (uint8_t)ins.op);
-    wu32(f, pool.intern(ins.sval));
-    wu32(f, (uint32_t)(int32_t)ins.ival);
-    wf64(f, ins.dval);
-    wu8 (f, (uint8_t)ins.cval);
+} // namespace
+
+static void encodeCode(Writer& w, const std::vector<IRInstr>& code) {
+    for (const IRInstr& ins : code) {
+        uint8_t mask = 0;
+        if (ins.sidx >= 0)     mask |= HAS_S;
+        if (ins.ival != 0)     mask |= HAS_I;
+        if (ins.dval != 0.0)   mask |= HAS_D;
+        if (ins.cval != 0)     mask |= HAS_C;
+        if (ins.aux != 0)      mask |= HAS_A;
+        w.u8((uint8_t)ins.op);
+        w.u8(mask);
+        if (mask & HAS_S) w.var((uint32_t)ins.sidx);
+        if (mask & HAS_I) w.svar(ins.ival);
+        if (mask & HAS_D) w.f64(ins.dval);
+        if (mask & HAS_C) w.u8((uint8_t)ins.cval);
+        if (mask & HAS_A) w.svar(ins.aux);
+    }
 }
 
-static IRInstr readInstr(std::ifstream& f, const std::vector<std::string>& pool) {
-    IRInstr ins;
-    ins.op   = (IROp)ru8(f);
-    uint32_t si = ru32(f);
-    ins.sval = (si == NO_STR || si >= pool.size()) ? "" : pool[si];
-    ins.ival = (int)(int32_t)ru32(f);
-    ins.dval = rf64(f);
-    ins.cval = (char)ru8(f);
-    return ins;
+static Writer encodePool(const StringPool& pool) {
+    Writer strs;
+    strs.var(pool.strs.size());
+    for (const std::string& s : pool.strs) strs.bytes(s);
+    return strs;
 }
 
-static void writeCode(std::ofstream& f, const std::vector<IRInstr>& code, StringPool& pool) {
-    wu32(f, (uint32_t)code.size());
-    for (const IRInstr& ins : code) writeInstr(f, ins, pool);
-}
+// Assembles header, section table and sections, and writes the file.
+static bool writeFile(const std::string& filename, uint16_t kind,
+                      const std::vector<std::pair<uint32_t, const Writer*>>& sections) {
+    const uint32_t nsec = (uint32_t)sections.size();
+
+    Writer body;
+    uint32_t offset = (uint32_t)(HEADER_SIZE + nsec * 12);
+    for (auto& [id, sec] : sections) {
+        body.u32(id);
+        body.u32(offset);
+        body.u32((uint32_t)sec->buf.size());
+        offset += (uint32_t)sec->buf.size();
+    }
+    for (auto& [id, sec] : sections) body.buf.append(sec->buf);
 
-static std::vector<IRInstr> readCode(std::ifstream& f, const std::vector<std::string>& pool) {
-    uint32_t n = ru32(f);
-    std::vector<IRInstr> code;
-    code.reserve(n);
-    for (uint32_t i = 0; i < n; ++i) code.push_back(readInstr(f, pool));
-    return code;
+    Writer header;
+    header.u32(MAGIC);
+    header.u16(VERSION);
+    header.u16(kind);
+    header.u32(nsec);
+    header.u32(fnv1a(reinterpret_cast<const uint8_t*>(body.buf.data()), body.buf.size()));
+
+    std::ofstream f(filename, std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) return false;
+    f.write(header.buf.data(), (std::streamsize)header.buf.size());
+    f.write(body.buf.data(), (std::streamsize)body.buf.size());
+    return f.good();
 }
 
 // ── Public: write ─────────────────────────────────────────────────────────────
 
-bool writeBytecode(const IRProgram& prog, const std::string& filename) {
-    std::ofstream f(filename, std::ios::binary | std::ios::trunc);
-    if (!f.is_open()) return false;
+bool writeBytecode(const IRProgram& input, const std::string& filename) {
+    // v2 stores the executable form; resolve a copy if the caller hasn't.
+    IRProgram resolved;
+    const IRProgram* progp = &input;
+    if (!input.slotsResolved || !input.jumpsResolved) {
+        resolved = input;
+        resolveForVM(resolved);
+        progp = &resolved;
+    }
+    const IRProgram& prog = *progp;
+    StringPool pool(prog.strings);
 
-    // Build string pool first (two-pass: scan then write)
-    StringPool pool;
-    auto scanCode = [&](const std::vector<IRInstr>& code) {
-        for (const IRInstr& ins : code) pool.intern(ins.sval);
-    };
+    Writer code, clas, func, mainSec;
+
+    clas.var(prog.classes.size());
+    for (auto& [key, cls] : prog.classes) {
+        clas.var(pool.intern(cls.name));
+        clas.var(pool.intern(cls.baseClass));
+        clas.var(cls.fields.size());
+        for (auto& [t, n] : cls.fields) { clas.var(pool.intern(t)); clas.var(pool.intern(n)); }
+    }
+
+    func.var(prog.functions.size());
     for (auto& [key, fn] : prog.functions) {
-        pool.intern(fn.name); pool.intern(fn.className);
-        for (auto& [t, n] : fn.params) { pool.intern(t); pool.intern(n); }
-        scanCode(fn.code);
+        func.var(pool.intern(fn.name));
+        func.var(pool.intern(fn.className));
+        func.var(fn.params.size());
+        for (auto& [t, n] : fn.params) { func.var(pool.intern(t)); func.var(pool.intern(n)); }
+        func.var(fn.numSlots);
+        for (int s : fn.paramSlots) func.var(s);
+        func.var(fn.fieldSlots.size());
+        for (int s : fn.fieldSlots) func.var(s);
+        func.var(code.buf.size());
+        func.var(fn.code.size());
+        encodeCode(code, fn.code);
     }
-    for (auto& [key, cls] : prog.classes) {
-        pool.intern(cls.name); pool.intern(cls.baseClass);
-        for (auto& [t, n] : cls.fields) { pool.intern(t); pool.intern(n); }
+
+    mainSec.var(prog.mainSlots);
+    mainSec.var(code.buf.size());
+    mainSec.var(prog.main.size());
+    encodeCode(code, prog.main);
+
+    Writer strs = encodePool(pool);
+    return writeFile(filename, KIND_STACK, {
+        {SEC_STRS, &strs}, {SEC_CLAS, &clas}, {SEC_FUNC, &func},
+        {SEC_MAIN, &mainSec}, {SEC_CODE, &code},
+    });
+}
+
+// ── Encoding: TIR ─────────────────────────────────────────────────────────────
+//
+//   Type   [1] base  name
+//   Val    [1] mask (1 reg · 2 ival · 4 dval · 8 cval · 16 sval)  type
+//          then reg, ival (zigzag), dval, cval, sval as present
+//   Instr  [1] op  [1] mask (1 dest · 2 name · 4 name2 · 8 ival · 16 args
+//          · 32 phi)  type  then dest, name, name2, ival, args, phi
+//   Term   [1] kind  then val | target | cond, true, false
+//   Func   name, class, retType, nparams (type, name)…, nextReg,
+//          nblocks, per block: label, sealed, ninstrs, instrs…, term
+
+namespace {
+
+enum : uint8_t { V_REG = 1, V_I = 2, V_D = 4, V_C = 8, V_S = 16 };
+enum : uint8_t { T_DEST = 1, T_NAME = 2, T_NAME2 = 4, T_IVAL = 8, T_ARGS = 16, T_PHI = 32 };
+
+struct TIREncoder {
+    Writer&     w;
+    StringPool& pool;
+
+    void str(const std::string& s) { w.var(pool.intern(s)); }
+
+    void type(const TIR::Type& t) {
+        w.u8((uint8_t)t.base);
+        str(t.name);
     }
-    scanCode(prog.main);
 
-    // Header
-    wu32(f, MAGIC);
-    wu16(f, VERSION);
+    void val(const TIR::Val& v) {
+        uint8_t mask = 0;
+        if (v.isReg())        mask |= V_REG;
+        if (v.ival != 0)      mask |= V_I;
+        if (v.dval != 0.0 || std::signbit(v.dval)) mask |= V_D;
+        if (v.cval != 0)      mask |= V_C;
+        if (!v.sval.empty())  mask |= V_S;
+        w.u8(mask);
+        type(v.type);
+        if (mask & V_REG) w.var(v.reg);
+        if (mask & V_I)   w.svar(v.ival);
+        if (mask & V_D)   w.f64(v.dval);
+        if (mask & V_C)   w.u8((uint8_t)v.cval);
+        if (mask & V_S)   str(v.sval);
+    }
+
+    void instr(const TIR::Instr& ins) {
+        uint8_t mask = 0;
+        if (ins.dest != TIR::NOREG) mask |= T_DEST;
+        if (!ins.name.empty())      mask |= T_NAME;
+        if (!ins.name2.empty())     mask |= T_NAME2;
+        if (ins.ival != 0)          mask |= T_IVAL;
+        if (!ins.args.empty())      mask |= T_ARGS;
+        if (!ins.phi.empty())       mask |= T_PHI;
+        w.u8((uint8_t)ins.op);
+        w.u8(mask);
+        type(ins.type);
+        if (mask & T_DEST)  w.var(ins.dest);
+        if (mask & T_NAME)  str(ins.name);
+        if (mask & T_NAME2) str(ins.name2);
+        if (mask & T_IVAL)  w.svar(ins.ival);
+        if (mask & T_ARGS) {
+            w.var(ins.args.size());
+            for (const TIR::Val& a : ins.args) val(a);
+        }
+        if (mask & T_PHI) {
+            w.var(ins.phi.size());
+            for (const TIR::PhiSrc& p : ins.phi) { val(p.val); str(p.predLabel); }
+        }
+    }
 
-    // String pool
-    wu32(f, (uint32_t)pool.strs.size());
-    for (const std::string& s : pool.strs) wstr(f, s);
+    void term(const TIR::Term& t) {
+        w.u8((uint8_t)t.kind);
+        switch (t.kind) {
+        case TIR::TermKind::Ret:    break;
+        case TIR::TermKind::RetVal: val(t.val); break;
+        case TIR::TermKind::Br:     str(t.target); break;
+        case TIR::TermKind::BrCond:
+            val(t.cond); str(t.trueTarget); str(t.falseTarget);
+            break;
+        }
+    }
+
+    void func(const TIR::Func& fn) {
+        str(fn.name);
+        str(fn.className);
+        type(fn.retType);
+        w.var(fn.params.size());
+        for (auto& [t, n] : fn.params) { type(t); str(n); }
+        w.var(fn.nextReg);
+        w.var(fn.blocks.size());
+        for (const TIR::Block& bb : fn.blocks) {
+            str(bb.label);
+            w.u8(bb.sealed ? 1 : 0);
+            w.var(bb.instrs.size());
+            for (const TIR::Instr& ins : bb.instrs) instr(ins);
+            term(bb.term);
+        }
+    }
+};
 
-    // Class table
-    wu32(f, (uint32_t)prog.classes.size());
+} // namespace
+
+bool writeTIRBytecode(const TIR::Program& prog, const std::string& filename) {
+    StringPool pool({});
+    Writer clas, func, mainSec;
+
+    TIREncoder ce{clas, pool};
+    clas.var(prog.classes.size());
     for (auto& [key, cls] : prog.classes) {
-        wu32(f, pool.intern(cls.name));
-        wu32(f, pool.intern(cls.baseClass));
-        wu32(f, (uint32_t)cls.fields.size());
-        for (auto& [t, n] : cls.fields) { wu32(f, pool.intern(t)); wu32(f, pool.intern(n)); }
+        ce.str(cls.name);
+        ce.str(cls.baseClass);
+        clas.var(cls.fields.size());
+        for (auto& [t, n] : cls.fields) { ce.type(t); ce.str(n); }
     }
 
-    // Function table
-    wu32(f, (uint32_t)prog.functions.size());
-    for (auto& [key, fn] : prog.functions) {
-        wu32(f, pool.intern(fn.name));
-        wu32(f, pool.intern(fn.className));
-        wu32(f, (uint32_t)fn.params.size());
-        for (auto& [t, n] : fn.params) { wu32(f, pool.intern(t)); wu32(f, pool.intern(n)); }
-        writeCode(f, fn.code, pool);
+    TIREncoder fe{func, pool};
+    func.var(prog.funcs.size());
+    for (auto& [key, fn] : prog.funcs) fe.func(fn);
+
+    TIREncoder me{mainSec, pool};
+    me.func(prog.globalInit);
+
+    Writer strs = encodePool(pool);
+    return writeFile(filename, KIND_TIR, {
+        {SEC_STRS, &strs}, {SEC_CLAS, &clas}, {SEC_FUNC, &func}, {SEC_MAIN, &mainSec},
+    });
+}
+
+// ── Decoding ──────────────────────────────────────────────────────────────────
+
+namespace {
+
+// Bounds-checked reader over a byte range of the mapped file.
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    void need(size_t n) const {
+        if ((size_t)(end - p) < n) throw std::runtime_error("Corrupt .tlc file: truncated");
+    }
+    uint8_t u8() { need(1); return *p++; }
+    uint16_t u16() { uint16_t v; need(2); std::memcpy(&v, p, 2); p += 2; return v; }
+    uint32_t u32() { uint32_t v; need(4); std::memcpy(&v, p, 4); p += 4; return v; }
+    double   f64() { double   v; need(8); std::memcpy(&v, p, 8); p += 8; return v; }
+    uint64_t var() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = u8();
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        throw std::runtime_error("Corrupt .tlc file: bad varint");
+    }
+    int64_t svar() { uint64_t v = var(); return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+    std::string bytes(size_t n) {
+        need(n);
+        std::string s(reinterpret_cast<const char*>(p), n);
+        p += n;
+        return s;
+    }
+};
+
+// The VMs collect fields by walking base classes recursively, so a class
+// map read from a file must not contain an inheritance cycle.
+template <class ClassMap>
+void rejectBaseCycles(const ClassMap& classes) {
+    for (const auto& entry : classes) {
+        size_t depth = 0;
+        for (auto it = classes.find(entry.second.baseClass); it != classes.end();
+             it = classes.find(it->second.baseClass))
+            if (++depth > classes.size())
+                throw std::runtime_error("Corrupt .tlc file: cyclic base class");
+    }
+}
+
+// Read-only mapping of the whole file, unmapped on scope exit.
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t         size = 0;
+
+    explicit MappedFile(const std::string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open: " + filename);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) { ::close(fd); throw std::runtime_error("Cannot stat: " + filename); }
+        size = (size_t)st.st_size;
+        if (size > 0) {
+            void* m = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m == MAP_FAILED) { ::close(fd); throw std::runtime_error("Cannot map: " + filename); }
+            data = static_cast<const uint8_t*>(m);
+        }
+        ::close(fd);
     }
+    ~MappedFile() { if (data) ::munmap(const_cast<uint8_t*>(data), size); }
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
 
-    // Main
-    writeCode(f, prog.main, pool);
+} // namespace
 
-    return true;
+// Decodes count instructions and validates every operand IRVM indexes or
+// allocates with (string pool, frame slots, jump targets, argument and
+// element counts), so a crafted file is rejected here rather than read
+// out of bounds at run time.
+static std::vector<IRInstr> decodeCode(Cursor c, uint64_t count,
+                                       size_t numStrings, int numSlots) {
+    auto bad = [](const char* what) {
+        return std::runtime_error(std::string("Corrupt .tlc file: bad ") + what);
+    };
+    // Every instruction is at least an opcode and a mask byte.
+    if (count > (uint64_t)(c.end - c.p) / 2) throw bad("instruction count");
+    auto slot = [&](int s) { if (s < 0 || s >= numSlots) throw bad("slot index"); };
+
+    std::vector<IRInstr> code(count);
+    for (IRInstr& ins : code) {
+        uint8_t op = c.u8();
+        if (op > (uint8_t)IROp::STORE_LOAD_SLOT) throw bad("opcode");
+        ins.op = (IROp)op;
+        uint8_t mask = c.u8();
+        if (mask & HAS_S) {
+            uint64_t si = c.var();
+            if (si >= numStrings) throw bad("string index");
+            ins.sidx = (int)si;
+        }
+        if (mask & HAS_I) ins.ival = (int)c.svar();
+        if (mask & HAS_D) ins.dval = c.f64();
+        if (mask & HAS_C) ins.cval = (char)c.u8();
+        if (mask & HAS_A) ins.aux  = (int)c.svar();
+
+        switch (ins.op) {
+            case IROp::LOAD_SLOT: case IROp::STORE_SLOT: case IROp::INC_SLOT:
+                slot(ins.ival);
+                break;
+            case IROp::LOAD_SLOT2: case IROp::MOVE_SLOT: case IROp::STORE_LOAD_SLOT:
+                slot(ins.ival);
+                slot(ins.aux);
+                break;
+            // -1 is an undefined label, reported by IRVM when taken.
+            case IROp::JUMP: case IROp::JUMP_FALSE:
+            case IROp::CMP_LT_JUMP_FALSE: case IROp::CMP_GT_JUMP_FALSE:
+            case IROp::CMP_EQ_JUMP_FALSE: case IROp::CMP_NEQ_JUMP_FALSE:
+                if (ins.ival < -1 || (ins.ival >= 0 && (uint64_t)ins.ival > count))
+                    throw bad("jump target");
+                break;
+            // Each argument or literal element was pushed by an earlier
+            // instruction of this unit, so count bounds them.
+            case IROp::CALL: case IROp::CALL_METHOD: case IROp::CALL_SUPER:
+            case IROp::NEW_OBJ:
+                if (ins.ival < 0 || (uint64_t)ins.ival > count) throw bad("argument count");
+                break;
+            // -1 takes the size from the stack.
+            case IROp::NEW_ARRAY:
+                if (ins.ival < -1 || (ins.ival >= 0 && (uint64_t)ins.ival > count))
+                    throw bad("element count");
+                break;
+            default:
+                break;
+        }
+    }
+    return code;
 }
 
-// ── Public: read ──────────────────────────────────────────────────────────────
+// Verified v2 file: checksum checked, section table parsed.
+struct Sections {
+    std::unordered_map<uint32_t, Cursor> sec;
+
+    explicit Sections(const MappedFile& file) {
+        Cursor hdr{file.data + 8, file.data + HEADER_SIZE};
+        uint32_t nsec     = hdr.u32();
+        uint32_t checksum = hdr.u32();
+        if (fnv1a(file.data + HEADER_SIZE, file.size - HEADER_SIZE) != checksum)
+            throw std::runtime_error("Corrupt .tlc file: checksum mismatch");
+
+        Cursor table{file.data + HEADER_SIZE, file.data + file.size};
+        for (uint32_t i = 0; i < nsec; ++i) {
+            uint32_t id = table.u32(), off = table.u32(), size = table.u32();
+            if (off > file.size || size > file.size - off)
+                throw std::runtime_error("Corrupt .tlc file: bad section bounds");
+            sec[id] = Cursor{file.data + off, file.data + off + size};
+        }
+    }
 
-IRProgram readBytecode(const std::string& filename) {
-    std::ifstream f(filename, std::ios::binary);
-    if (!f.is_open()) throw std::runtime_error("Cannot open: " + filename);
+    Cursor operator()(uint32_t id) const {
+        auto it = sec.find(id);
+        if (it == sec.end()) throw std::runtime_error("Corrupt .tlc file: missing section");
+        return it->second;
+    }
 
-    // Header
-    if (ru32(f) != MAGIC)   throw std::runtime_error("Not a .tlc file: bad magic");
-    if (ru16(f) != VERSION) throw std::runtime_error("Unsupported .tlc version");
+    std::vector<std::string> strings() const {
+        Cursor c = (*this)(SEC_STRS);
+        std::vector<std::string> pool(c.var());
+        for (std::string& s : pool) s = c.bytes(c.var());
+        return pool;
+    }
+};
 
-    // String pool
-    uint32_t poolSize = ru32(f);
+static IRProgram readV2(const MappedFile& file) {
+    Sections section(file);
+    IRProgram prog;
+
+    prog.strings = section.strings();
+    auto ps = [&](uint64_t i) -> const std::string& {
+        if (i >= prog.strings.size()) throw std::runtime_error("Corrupt .tlc file: bad string index");
+        return prog.strings[i];
+    };
+
+    const Cursor code = section(SEC_CODE);
+    auto codeAt = [&](uint64_t off, uint64_t count, int numSlots) {
+        if (off > (uint64_t)(code.end - code.p))
+            throw std::runtime_error("Corrupt .tlc file: bad code offset");
+        return decodeCode(Cursor{code.p + off, code.end}, count,
+                          prog.strings.size(), numSlots);
+    };
+    auto slotCount = [](uint64_t n) {
+        if (n > (uint64_t)INT32_MAX) throw std::runtime_error("Corrupt .tlc file: bad slot count");
+        return (int)n;
+    };
+    auto slotOf = [](uint64_t s, int numSlots) {
+        if (s >= (uint64_t)numSlots) throw std::runtime_error("Corrupt .tlc file: bad slot index");
+        return (int)s;
+    };
+
+    Cursor clas = section(SEC_CLAS);
+    for (uint64_t n = clas.var(); n > 0; --n) {
+        IRClass cls;
+        cls.name      = ps(clas.var());
+        cls.baseClass = ps(clas.var());
+        for (uint64_t nf = clas.var(); nf > 0; --nf) {
+            const std::string& t = ps(clas.var());
+            cls.fields.emplace_back(t, ps(clas.var()));
+        }
+        prog.classes[cls.name] = std::move(cls);
+    }
+    rejectBaseCycles(prog.classes);
+
+    Cursor func = section(SEC_FUNC);
+    for (uint64_t n = func.var(); n > 0; --n) {
+        IRFunction fn;
+        fn.name      = ps(func.var());
+        fn.className = ps(func.var());
+        for (uint64_t np = func.var(); np > 0; --np) {
+            const std::string& t = ps(func.var());
+            fn.params.emplace_back(t, ps(func.var()));
+        }
+        fn.numSlots = slotCount(func.var());
+        for (size_t i = 0; i < fn.params.size(); ++i)
+            fn.paramSlots.push_back(slotOf(func.var(), fn.numSlots));
+        for (uint64_t nf = func.var(); nf > 0; --nf)
+            fn.fieldSlots.push_back(slotOf(func.var(), fn.numSlots));
+        uint64_t off   = func.var();
+        uint64_t count = func.var();
+        fn.code = codeAt(off, count, fn.numSlots);
+        std::string key = fn.className.empty() ? fn.name : fn.className + "::" + fn.name;
+        prog.functions[key] = std::move(fn);
+    }
+
+    Cursor mainSec = section(SEC_MAIN);
+    prog.mainSlots = slotCount(mainSec.var());
+    uint64_t off   = mainSec.var();
+    uint64_t count = mainSec.var();
+    prog.main = codeAt(off, count, prog.mainSlots);
+
+    prog.slotsResolved = true;
+    prog.jumpsResolved = true;
+    return prog;
+}
+
+// Version 1: fixed-width records, name-based code (resolved by the driver).
+static IRProgram readV1(const MappedFile& file) {
+    Cursor c{file.data + 6, file.data + file.size};
+
+    uint32_t poolSize = c.u32();
     std::vector<std::string> pool(poolSize);
-    for (uint32_t i = 0; i < poolSize; ++i) pool[i] = rstr(f);
+    for (uint32_t i = 0; i < poolSize; ++i) pool[i] = c.bytes(c.u32());
 
     auto ps = [&](uint32_t idx) -> std::string {
         return (idx == NO_STR || idx >= pool.size()) ? "" : pool[idx];
     };
+    auto readCode = [&]() {
+        uint32_t n = c.u32();
+        std::vector<IRInstr> code;
+        code.reserve(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            IRInstr ins;
+            ins.op   = (IROp)c.u8();
+            ins.sval = ps(c.u32());
+            ins.ival = (int)(int32_t)c.u32();
+            ins.dval = c.f64();
+            ins.cval = (char)c.u8();
+            code.push_back(std::move(ins));
+        }
+        return code;
+    };
 
     IRProgram prog;
 
-    // Classes
-    uint32_t nc = ru32(f);
+    uint32_t nc = c.u32();
     for (uint32_t i = 0; i < nc; ++i) {
         IRClass cls;
-        cls.name      = ps(ru32(f));
-        cls.baseClass = ps(ru32(f));
-        uint32_t nf = ru32(f);
-        for (uint32_t j = 0; j < nf; ++j)
-            cls.fields.push_back({ps(ru32(f)), ps(ru32(f))});
+        cls.name      = ps(c.u32());
+        cls.baseClass = ps(c.u32());
+        uint32_t nf = c.u32();
+        for (uint32_t j = 0; j < nf; ++j) {
+            std::string t = ps(c.u32());
+            cls.fields.push_back({t, ps(c.u32())});
+        }
         prog.classes[cls.name] = std::move(cls);
     }
 
-    // Functions
-    uint32_t nfn = ru32(f);
+    uint32_t nfn = c.u32();
     for (uint32_t i = 0; i < nfn; ++i) {
         IRFunction fn;
-        fn.name      = ps(ru32(f));
-        fn.className = ps(ru32(f));
-        uint32_t np = ru32(f);
-        for (uint32_t j = 0; j < np; ++j)
-            fn.params.push_back({ps(ru32(f)), ps(ru32(f))});
-        fn.code = readCode(f, pool);
+        fn.name      = ps(c.u32());
+        fn.className = ps(c.u32());
+        uint32_t np = c.u32();
+        for (uint32_t j = 0; j < np; ++j) {
+            std::string t = ps(c.u32());
+            fn.params.push_back({t, ps(c.u32())});
+        }
+        fn.code = readCode();
         std::string key = fn.className.empty() ? fn.name : fn.className + "::" + fn.name;
         prog.functions[key] = std::move(fn);
     }
 
-    // Main
-    prog.main = readCode(f, pool);
+    prog.main = readCode();
+    return prog;
+}
+
+// ── Public: read ──────────────────────────────────────────────────────────────
+
+// Checks magic and version; returns the version.
+static uint16_t checkHeader(const MappedFile& file) {
+    if (file.size < HEADER_SIZE) throw std::runtime_error("Not a .tlc file: too short");
+    Cursor c{file.data, file.data + file.size};
+    if (c.u32() != MAGIC) throw std::runtime_error("Not a .tlc file: bad magic");
+    uint16_t version = c.u16();
+    if (version != VERSION && version != VERSION_V1)
+        throw std::runtime_error("Unsupported .tlc version");
+    return version;
+}
+
+static uint16_t irKind(const MappedFile& file, uint16_t version) {
+    if (version == VERSION_V1) return KIND_STACK;
+    Cursor c{file.data + 6, file.data + HEADER_SIZE};
+    return c.u16();
+}
+
+BytecodeKind bytecodeKind(const std::string& filename) {
+    MappedFile file(filename);
+    uint16_t kind = irKind(file, checkHeader(file));
+    if (kind == KIND_STACK) return BytecodeKind::StackIR;
+    if (kind == KIND_TIR)   return BytecodeKind::TIR;
+    throw std::runtime_error("Unsupported .tlc IR kind");
+}
+
+IRProgram readBytecode(const std::string& filename) {
+    MappedFile file(filename);
+    uint16_t version = checkHeader(file);
+    if (irKind(file, version) != KIND_STACK)
+        throw std::runtime_error("Not a stack-IR .tlc file (use readTIRBytecode)");
+    if (version == VERSION) return readV2(file);
+    return readV1(file);
+}
+
+// ── Decoding: TIR ─────────────────────────────────────────────────────────────
+
+namespace {
+
+struct TIRDecoder {
+    Cursor&                         c;
+    const std::vector<std::string>& pool;
+
+    const std::string& str() {
+        uint64_t i = c.var();
+        if (i >= pool.size()) throw std::runtime_error("Corrupt .tlc file: bad string index");
+        return pool[i];
+    }
+
+    TIR::Type type() {
+        uint8_t base = c.u8();
+        if (base > (uint8_t)TIR::BaseType::ArrRef)
+            throw std::runtime_error("Corrupt .tlc file: bad type");
+        return {(TIR::BaseType)base, str()};
+    }
+
+    TIR::Val val() {
+        TIR::Val v;
+        uint8_t mask = c.u8();
+        v.type = type();
+        if (mask & V_REG) v.reg  = (TIR::Reg)c.var();
+        if (mask & V_I)   v.ival = (int)c.svar();
+        if (mask & V_D)   v.dval = c.f64();
+        if (mask & V_C)   v.cval = (char)c.u8();
+        if (mask & V_S)   v.sval = str();
+        return v;
+    }
+
+    TIR::Instr instr() {
+        TIR::Instr ins;
+        uint8_t op = c.u8();
+        if (op > (uint8_t)TIR::Op::Nop) throw std::runtime_error("Corrupt .tlc file: bad opcode");
+        ins.op = (TIR::Op)op;
+        uint8_t mask = c.u8();
+        ins.type = type();
+        if (mask & T_DEST)  ins.dest  = (TIR::Reg)c.var();
+        if (mask & T_NAME)  ins.name  = str();
+        if (mask & T_NAME2) ins.name2 = str();
+        if (mask & T_IVAL)  ins.ival  = (int)c.svar();
+        if (mask & T_ARGS)
+            for (uint64_t n = c.var(); n > 0; --n) ins.args.push_back(val());
+        if (mask & T_PHI)
+            for (uint64_t n = c.var(); n > 0; --n) {
+                TIR::Val v = val();
+                ins.phi.push_back({std::move(v), str()});
+            }
+        return ins;
+    }
+
+    TIR::Term term() {
+        TIR::Term t;
+        uint8_t kind = c.u8();
+        if (kind > (uint8_t)TIR::TermKind::BrCond)
+            throw std::runtime_error("Corrupt .tlc file: bad terminator");
+        t.kind = (TIR::TermKind)kind;
+        switch (t.kind) {
+        case TIR::TermKind::Ret:    break;
+        case TIR::TermKind::RetVal: t.val = val(); break;
+        case TIR::TermKind::Br:     t.target = str(); break;
+        case TIR::TermKind::BrCond:
+            t.cond        = val();
+            t.trueTarget  = str();
+            t.falseTarget = str();
+            break;
+        }
+        return t;
+    }
+
+    TIR::Func func() {
+        TIR::Func fn;
+        fn.name      = str();
+        fn.className = str();
+        fn.retType   = type();
+        for (uint64_t n = c.var(); n > 0; --n) {
+            TIR::Type t = type();
+            fn.params.emplace_back(std::move(t), str());
+        }
+        fn.nextReg = (TIR::Reg)c.var();
+        for (uint64_t n = c.var(); n > 0; --n) {
+            TIR::Block bb;
+            bb.label  = str();
+            bb.sealed = c.u8() != 0;
+            for (uint64_t k = c.var(); k > 0; --k) bb.instrs.push_back(instr());
+            bb.term = term();
+            fn.blocks.push_back(std::move(bb));
+        }
+        validate(fn);
+        return fn;
+    }
+
+    // Operands TIRVM reads positionally for each op.
+    static size_t minArgs(const TIR::Instr& ins) {
+        using O = TIR::Op;
+        switch (ins.op) {
+        case O::Load: case O::Neg: case O::Not: case O::Print:
+        case O::CastI32: case O::CastF64: case O::CastChar: case O::CastI1: case O::CastStr:
+        case O::LoadField: case O::CallMethod:
+            return 1;
+        case O::Store: case O::Add: case O::Sub: case O::Mul: case O::Div:
+        case O::CmpEq: case O::CmpNe: case O::CmpLt: case O::CmpGt:
+        case O::And: case O::Or: case O::StoreField: case O::LoadArr:
+            return 2;
+        case O::StoreArr:
+            return 3;
+        case O::NewArray:
+            return ins.ival < 0 ? 1 : 0;
+        default:
+            return 0;
+        }
+    }
+
+    // Every register must be below fn.nextReg and every branch or phi label
+    // must name a block of fn, so a corrupt file is rejected at load time
+    // instead of reaching a register file or a missing block at run time.
+    static void validate(const TIR::Func& fn) {
+        auto bad = [](const char* what) {
+            return std::runtime_error(std::string("Corrupt .tlc file: bad ") + what);
+        };
+        std::unordered_set<std::string> labels;
+        for (const TIR::Block& bb : fn.blocks) labels.insert(bb.label);
+        auto reg = [&](TIR::Reg r) {
+            if (r != TIR::NOREG && r >= fn.nextReg) throw bad("register");
+        };
+        auto label = [&](const std::string& l) {
+            if (!labels.count(l)) throw bad("branch target");
+        };
+        for (const TIR::Block& bb : fn.blocks) {
+            for (const TIR::Instr& ins : bb.instrs) {
+                if (ins.args.size() < minArgs(ins)) throw bad("operand count");
+                reg(ins.dest);
+                for (const TIR::Val& v : ins.args) reg(v.reg);
+                for (const auto& [v, from] : ins.phi) { reg(v.reg); label(from); }
+            }
+            const TIR::Term& t = bb.term;
+            switch (t.kind) {
+            case TIR::TermKind::Ret:    break;
+            case TIR::TermKind::RetVal: reg(t.val.reg); break;
+            case TIR::TermKind::Br:     label(t.target); break;
+            case TIR::TermKind::BrCond:
+                reg(t.cond.reg);
+                label(t.trueTarget);
+                label(t.falseTarget);
+                break;
+            }
+        }
+    }
+};
+
+} // namespace
+
+TIR::Program readTIRBytecode(const std::string& filename) {
+    MappedFile file(filename);
+    uint16_t version = checkHeader(file);
+    if (irKind(file, version) != KIND_TIR)
+        throw std::runtime_error("Not a TIR .tlc file (use readBytecode)");
+
+    Sections section(file);
+    std::vector<std::string> pool = section.strings();
+    TIR::Program prog;
+
+    Cursor clas = section(SEC_CLAS);
+    TIRDecoder cd{clas, pool};
+    for (uint64_t n = clas.var(); n > 0; --n) {
+        TIR::Class cls;
+        cls.name      = cd.str();
+        cls.baseClass = cd.str();
+        for (uint64_t nf = clas.var(); nf > 0; --nf) {
+            TIR::Type t = cd.type();
+            cls.fields.emplace_back(std::move(t), cd.str());
+        }
+        prog.classes[cls.name] = std::move(cls);
+    }
+    rejectBaseCycles(prog.classes);
+
+    Cursor func = section(SEC_FUNC);
+    TIRDecoder fd{func, pool};
+    for (uint64_t n = func.var(); n > 0; --n) {
+        TIR::Func fn = fd.func();
+        std::string key = fn.className.empty() ? fn.name : fn.className + "::" + fn.name;
+        prog.funcs[key] = std::move(fn);
+    }
 
+    Cursor mainSec = section(SEC_MAIN);
+    TIRDecoder md{mainSec, pool};
+    prog.globalInit = md.func();
     return prog;
 }
@@ -1,11 +1,24 @@
 #pragma once
 #include "ir.hpp"
+#include "tir.hpp"
 #include <string>
 
 // Write an IRProgram to a .tlc binary file (compile once, run many times).
 // Returns true on success.
 bool writeBytecode(const IRProgram& prog, const std::string& filename);
 
+// Write a TIR::Program to a .tlc binary file that runs on TIRVM.
+// Returns true on success.
+bool writeTIRBytecode(const TIR::Program& prog, const std::string& filename);
+
+// Which IR a .tlc file holds (recorded in its header).
+enum class BytecodeKind { StackIR, TIR };
+BytecodeKind bytecodeKind(const std::string& filename);
+
 // Read a .tlc binary file back into an IRProgram.
 // Throws std::runtime_error on bad magic or version mismatch.
 IRProgram readBytecode(const std::string& filename);
+
+// Read a TIR .tlc file back into a TIR::Program.
+// Throws std::runtime_error on bad magic, version or IR kind.
+TIR::Program readTIRBytecode(const std::string& filename);
@@ -72,8 +72,17 @@ TIR::Type LLVMGen::effectiveType(const TIR::Val& v) const {
 TIR::Type LLVMGen::inferRetType(const TIR::Func& fn) const {
     if (!fn.retType.isVoid()) return fn.retType;
     for (auto& blk : fn.blocks) {
-        if (blk.term.kind == TIR::TermKind::RetVal)
-            return blk.term.val.type;
+        if (blk.term.kind != TIR::TermKind::RetVal) continue;
+        const TIR::Val& v = blk.term.val;
+        if (!v.type.isVoid() || !v.isReg()) return v.type;
+        // TIRGen types native calls as void; stdlib wrappers that return a
+        // native result (`return __tl_file_read_all(p);`) take the native's
+        // return type instead.
+        for (auto& b : fn.blocks)
+            for (auto& ins : b.instrs)
+                if (ins.dest == v.reg && ins.op == TIR::Op::Call)
+                    return callRetType(ins.name);
+        return v.type;
     }
     return TIR::Type::void_();
 }
@@ -120,7 +129,74 @@ std::string LLVMGen::funcSym(const std::string& name,
     auto sep = name.find("::");
     if (sep != std::string::npos)
         return "_TL_" + name.substr(0, sep) + "__" + name.substr(sep + 2);
-    return name;
+    // Runtime builtins keep their C names; user functions are prefixed so
+    // that e.g. stdlib's exp() cannot bind libm's exp, which LLVM itself
+    // calls when it lowers @llvm.exp.f64.
+    if (name.compare(0, 5, "__tl_") == 0) return name;
+    return "_TL_" + name;
+}
+
+// "type value" for argument i of a call to key, widening an int-like value
+// passed to a float parameter with sitofp (emitted before the call).
+std::string LLVMGen::callArg(const std::string& key, size_t i, const TIR::Val& a) {
+    TIR::Type at = effectiveType(a);
+    if (at.isVoid()) at = a.type;
+    auto fit = prog_->funcs.find(key);
+    if (fit != prog_->funcs.end() && i < fit->second.params.size() &&
+        fit->second.params[i].first.isF64() &&
+        (at.isI32() || at.isI1() || at.isChar()))
+        return "double " + asF64(a);
+    return llvmType(at) + " " + llvmVal(a);
+}
+
+// v as a double operand; int-like values are widened (emitted here).
+std::string LLVMGen::asF64(const TIR::Val& v) {
+    TIR::Type t = effectiveType(v);
+    if (!t.isI32() && !t.isI1() && !t.isChar()) return llvmVal(v);
+    if (v.isConst()) return hexFloat(t.isChar() ? (unsigned char)v.cval : v.ival);
+    std::string cv = tmp("fcv");
+    out_ << "  " << cv << " = " << (t.isI1() ? "uitofp " : "sitofp ") << llvmType(t)
+         << " " << llvmVal(v) << " to double\n";
+    return cv;
+}
+
+// Element type of an int/float/char/bool array, or void for any other.
+TIR::Type LLVMGen::primElemType(const TIR::Val& arr) const {
+    TIR::Type at = effectiveType(arr);
+    if (!at.isArr()) return TIR::Type::void_();
+    if (at.name == "float")                   return TIR::Type::f64();
+    if (at.name == "int")                     return TIR::Type::i32();
+    if (at.name == "char")                    return TIR::Type::char_();
+    if (at.name == "bool")                    return TIR::Type::i1();
+    return TIR::Type::void_();
+}
+
+// Address of the 8-byte slot arr[idx], after the same null and bounds
+// checks __tl_load_arr makes.  The checks split the current block; no
+// successor names it, since LLVMGen never emits phis.
+std::string LLVMGen::arrSlot(const TIR::Val& arr, const TIR::Val& idx) {
+    std::string a   = llvmVal(arr);
+    std::string lbl = tmp("ab").substr(1);
+    std::string ix  = tmp("aix"), nul = tmp("anul"), lenp = tmp("alenp"),
+                len = tmp("alen"), ok = tmp("aok"), data = tmp("adata"),
+                slot = tmp("aslot");
+    TIR::Type ity = effectiveType(idx);
+    out_ << "  " << ix << " = " << (ity.isI1() ? "zext i1 " : "sext i32 ")
+         << llvmVal(idx) << " to i64\n";
+    out_ << "  " << nul << " = icmp eq ptr " << a << ", null\n";
+    out_ << "  br i1 " << nul << ", label %" << lbl << "_oob, label %" << lbl << "_nn\n";
+    out_ << lbl << "_nn:\n";
+    out_ << "  " << lenp << " = getelementptr inbounds i8, ptr " << a << ", i64 8\n";
+    out_ << "  " << len << " = load i64, ptr " << lenp << ", align 8\n";
+    out_ << "  " << ok << " = icmp ult i64 " << ix << ", " << len << "\n";
+    out_ << "  br i1 " << ok << ", label %" << lbl << "_ok, label %" << lbl << "_oob\n";
+    out_ << lbl << "_oob:\n";
+    out_ << "  call void @__tl_arr_oob(ptr " << a << ", i64 " << ix << ")\n";
+    out_ << "  unreachable\n";
+    out_ << lbl << "_ok:\n";
+    out_ << "  " << data << " = getelementptr inbounds i8, ptr " << a << ", i64 16\n";
+    out_ << "  " << slot << " = getelementptr inbounds i64, ptr " << data << ", i64 " << ix << "\n";
+    return slot;
 }
 
 // Unique temporary name that cannot collide with %rN register names.
@@ -143,6 +219,8 @@ static const std::unordered_map<std::string, TIR::Type>& nativeRetTypes() {
         {"__tl_print_char",   TIR::Type::void_()},
         // input
         {"__tl_input_i32",    TIR::Type::i32()},
+        {"__tl_read_ints",    TIR::Type::arr("int")},
+        {"__tl_read_line",    TIR::Type::str()},
         // string → string
         {"__tl_str_concat",   TIR::Type::str()},
         {"__tl_i32_to_str",   TIR::Type::str()},
@@ -153,6 +231,7 @@ static const std::unordered_map<std::string, TIR::Type>& nativeRetTypes() {
         {"__tl_str_lower",    TIR::Type::str()},
         {"__tl_str_trim",     TIR::Type::str()},
         {"__tl_str_replace",  TIR::Type::str()},
+        {"__tl_str_join",     TIR::Type::str()},
         // string → int
         {"__tl_str_len",        TIR::Type::i32()},
         {"__tl_str_eq",         TIR::Type::i32()},
@@ -164,18 +243,103 @@ static const std::unordered_map<std::string, TIR::Type>& nativeRetTypes() {
         {"__tl_str_to_int",     TIR::Type::i32()},
         // string → float
         {"__tl_str_to_float",   TIR::Type::f64()},
+        // string → array
+        {"__tl_str_split",       TIR::Type::arr("string")},
+        {"__tl_str_split_lines", TIR::Type::arr("string")},
+        // string builders (handles are opaque pointers)
+        {"__tl_sb_new",         TIR::Type::arr("any")},
+        {"__tl_sb_append",      TIR::Type::void_()},
+        {"__tl_sb_append_int",  TIR::Type::void_()},
+        {"__tl_sb_append_char", TIR::Type::void_()},
+        {"__tl_sb_len",         TIR::Type::i32()},
+        {"__tl_sb_to_str",      TIR::Type::str()},
         // array
         {"__tl_alloc_arr",  TIR::Type::arr("any")},
         {"__tl_arr_len",    TIR::Type::i32()},
         {"__tl_load_arr",   TIR::Type::i32()},   // raw i64 → i32 for int arrays
         {"__tl_store_arr",  TIR::Type::void_()},
         {"__tl_arr_resize", TIR::Type::arr("any")},
+        {"__tl_arr_sort_i32",    TIR::Type::void_()},
+        {"__tl_arr_sort_f64",    TIR::Type::void_()},
+        {"__tl_arr_sort_str",    TIR::Type::void_()},
+        {"__tl_arr_bsearch",     TIR::Type::i32()},
+        {"__tl_arr_bsearch_str", TIR::Type::i32()},
+        {"__tl_arr_partition",   TIR::Type::i32()},
         // file
         {"__tl_file_exists",    TIR::Type::i32()},
         {"__tl_file_read_all",  TIR::Type::str()},
         {"__tl_file_write_all", TIR::Type::i32()},
         {"__tl_file_append",    TIR::Type::i32()},
         {"__tl_file_delete",    TIR::Type::i32()},
+        {"__tl_file_map",       TIR::Type::str()},
+        // streaming readers (handles are i32)
+        {"__tl_reader_open",       TIR::Type::i32()},
+        {"__tl_reader_read_line",  TIR::Type::str()},
+        {"__tl_reader_read_chunk", TIR::Type::str()},
+        {"__tl_reader_eof",        TIR::Type::i32()},
+        {"__tl_reader_close",      TIR::Type::void_()},
+        // async file I/O (handles are i32)
+        {"__tl_file_read_async",   TIR::Type::i32()},
+        {"__tl_file_write_async",  TIR::Type::i32()},
+        {"__tl_file_append_async", TIR::Type::i32()},
+        {"__tl_async_poll",        TIR::Type::i32()},
+        {"__tl_async_await_str",   TIR::Type::str()},
+        {"__tl_async_await_i32",   TIR::Type::i32()},
+        // math (scalars lower to intrinsics, see mathIntrinsics())
+        {"__tl_math_sqrt",      TIR::Type::f64()},
+        {"__tl_math_pow",       TIR::Type::f64()},
+        {"__tl_math_exp",       TIR::Type::f64()},
+        {"__tl_math_log",       TIR::Type::f64()},
+        {"__tl_math_sin",       TIR::Type::f64()},
+        {"__tl_math_cos",       TIR::Type::f64()},
+        {"__tl_math_floor",     TIR::Type::f64()},
+        {"__tl_math_abs",       TIR::Type::f64()},
+        {"__tl_math_min",       TIR::Type::f64()},
+        {"__tl_math_max",       TIR::Type::f64()},
+        {"__tl_math_map_sqrt",  TIR::Type::arr("float")},
+        {"__tl_math_map_exp",   TIR::Type::arr("float")},
+        {"__tl_math_map_log",   TIR::Type::arr("float")},
+        {"__tl_math_map_sin",   TIR::Type::arr("float")},
+        {"__tl_math_map_cos",   TIR::Type::arr("float")},
+        {"__tl_math_map_floor", TIR::Type::arr("float")},
+        {"__tl_math_map_abs",   TIR::Type::arr("float")},
+        // SPSC queues (handles are i32)
+        {"__tl_spsc_new",       TIR::Type::i32()},
+        {"__tl_spsc_push",      TIR::Type::i32()},
+        {"__tl_spsc_pop_or",    TIR::Type::i32()},
+        {"__tl_spsc_take",      TIR::Type::i32()},
+        {"__tl_spsc_len",       TIR::Type::i32()},
+        {"__tl_spsc_closed",    TIR::Type::i32()},
+        {"__tl_spsc_close",     TIR::Type::void_()},
+        {"__tl_spsc_free",      TIR::Type::void_()},
+        // directories (iterator handles are i32)
+        {"__tl_dir_exists",     TIR::Type::i32()},
+        {"__tl_dir_create",     TIR::Type::i32()},
+        {"__tl_dir_delete",     TIR::Type::i32()},
+        {"__tl_dir_list_count", TIR::Type::i32()},
+        {"__tl_dir_list_entry", TIR::Type::str()},
+        {"__tl_dir_list_all",   TIR::Type::arr("string")},
+        {"__tl_dir_open",       TIR::Type::i32()},
+        {"__tl_dir_next",       TIR::Type::str()},
+        {"__tl_dir_close",      TIR::Type::void_()},
+    };
+    return t;
+}
+
+// Scalar __tl_math_* builtins emitted as LLVM intrinsic calls, so the
+// optimizer can fold, vectorize or inline them.  All take and return double.
+static const std::unordered_map<std::string, const char*>& mathIntrinsics() {
+    static const std::unordered_map<std::string, const char*> t = {
+        {"__tl_math_sqrt",  "llvm.sqrt.f64"},
+        {"__tl_math_pow",   "llvm.pow.f64"},
+        {"__tl_math_exp",   "llvm.exp.f64"},
+        {"__tl_math_log",   "llvm.log.f64"},
+        {"__tl_math_sin",   "llvm.sin.f64"},
+        {"__tl_math_cos",   "llvm.cos.f64"},
+        {"__tl_math_floor", "llvm.floor.f64"},
+        {"__tl_math_abs",   "llvm.fabs.f64"},
+        {"__tl_math_min",   "llvm.minnum.f64"},
+        {"__tl_math_max",   "llvm.maxnum.f64"},
     };
     return t;
 }
@@ -225,6 +389,8 @@ void LLVMGen::emitRuntimeDecls() {
     out_ << "declare void @__tl_print_char(i32)\n";
     out_ << "declare void @__tl_print_str(ptr)\n";
     out_ << "declare i32  @__tl_input_i32()\n";
+    out_ << "declare ptr  @__tl_read_ints(i32)\n";
+    out_ << "declare ptr  @__tl_read_line()\n";
     out_ << "declare ptr  @__tl_str_concat(ptr, ptr)\n";
     out_ << "declare ptr  @__tl_i32_to_str(i32)\n";
     out_ << "declare ptr  @__tl_f64_to_str(double)\n";
@@ -238,8 +404,14 @@ void LLVMGen::emitRuntimeDecls() {
     out_ << "declare i32  @__tl_arr_len(ptr)\n";
     out_ << "declare i64  @__tl_load_arr(ptr, i32)\n";
     out_ << "declare void @__tl_store_arr(ptr, i32, i64)\n";
+    out_ << "declare void @__tl_arr_oob(ptr, i64) noreturn cold\n";
     out_ << "declare ptr  @__tl_arr_resize(ptr, i32)\n";
-    out_ << "declare i32  @__tl_str_len(ptr)\n";
+    out_ << "declare void @__tl_arr_sort_i32(ptr, i32)\n";
+    out_ << "declare void @__tl_arr_sort_f64(ptr, i32)\n";
+    out_ << "declare void @__tl_arr_sort_str(ptr, i32)\n";
+    out_ << "declare i32  @__tl_arr_bsearch(ptr, i32, i32)\n";
+    out_ << "declare i32  @__tl_arr_bsearch_str(ptr, i32, ptr)\n";
+    out_ << "declare i32  @__tl_arr_partition(ptr, i32, i32)\n";
     out_ << "declare ptr  @__tl_str_sub(ptr, i32, i32)\n";
     out_ << "declare ptr  @__tl_str_upper(ptr)\n";
     out_ << "declare ptr  @__tl_str_lower(ptr)\n";
@@ -252,11 +424,66 @@ void LLVMGen::emitRuntimeDecls() {
     out_ << "declare i32  @__tl_str_to_int(ptr)\n";
     out_ << "declare double @__tl_str_to_float(ptr)\n";
     out_ << "declare i32  @__tl_str_char_at(ptr, i32)\n";
+    out_ << "declare ptr  @__tl_str_split(ptr, ptr)\n";
+    out_ << "declare ptr  @__tl_str_split_lines(ptr)\n";
+    out_ << "declare ptr  @__tl_str_join(ptr, ptr)\n";
+    out_ << "declare ptr  @__tl_sb_new(i32)\n";
+    out_ << "declare void @__tl_sb_append(ptr, ptr)\n";
+    out_ << "declare void @__tl_sb_append_int(ptr, i32)\n";
+    out_ << "declare void @__tl_sb_append_char(ptr, i32)\n";
+    out_ << "declare i32  @__tl_sb_len(ptr)\n";
+    out_ << "declare ptr  @__tl_sb_to_str(ptr)\n";
     out_ << "declare i32  @__tl_file_exists(ptr)\n";
     out_ << "declare ptr  @__tl_file_read_all(ptr)\n";
     out_ << "declare i32  @__tl_file_write_all(ptr, ptr)\n";
     out_ << "declare i32  @__tl_file_append(ptr, ptr)\n";
     out_ << "declare i32  @__tl_file_delete(ptr)\n";
+    out_ << "declare ptr  @__tl_file_map(ptr)\n";
+    out_ << "declare i32  @__tl_reader_open(ptr)\n";
+    out_ << "declare ptr  @__tl_reader_read_line(i32)\n";
+    out_ << "declare ptr  @__tl_reader_read_chunk(i32, i32)\n";
+    out_ << "declare i32  @__tl_reader_eof(i32)\n";
+    out_ << "declare void @__tl_reader_close(i32)\n";
+    out_ << "declare i32  @__tl_file_read_async(ptr)\n";
+    out_ << "declare i32  @__tl_file_write_async(ptr, ptr)\n";
+    out_ << "declare i32  @__tl_file_append_async(ptr, ptr)\n";
+    out_ << "declare i32  @__tl_async_poll(i32)\n";
+    out_ << "declare ptr  @__tl_async_await_str(i32)\n";
+    out_ << "declare i32  @__tl_async_await_i32(i32)\n";
+    out_ << "declare double @llvm.sqrt.f64(double)\n";
+    out_ << "declare double @llvm.pow.f64(double, double)\n";
+    out_ << "declare double @llvm.exp.f64(double)\n";
+    out_ << "declare double @llvm.log.f64(double)\n";
+    out_ << "declare double @llvm.sin.f64(double)\n";
+    out_ << "declare double @llvm.cos.f64(double)\n";
+    out_ << "declare double @llvm.floor.f64(double)\n";
+    out_ << "declare double @llvm.fabs.f64(double)\n";
+    out_ << "declare double @llvm.minnum.f64(double, double)\n";
+    out_ << "declare double @llvm.maxnum.f64(double, double)\n";
+    out_ << "declare ptr  @__tl_math_map_sqrt(ptr)\n";
+    out_ << "declare ptr  @__tl_math_map_exp(ptr)\n";
+    out_ << "declare ptr  @__tl_math_map_log(ptr)\n";
+    out_ << "declare ptr  @__tl_math_map_sin(ptr)\n";
+    out_ << "declare ptr  @__tl_math_map_cos(ptr)\n";
+    out_ << "declare ptr  @__tl_math_map_floor(ptr)\n";
+    out_ << "declare ptr  @__tl_math_map_abs(ptr)\n";
+    out_ << "declare i32  @__tl_dir_exists(ptr)\n";
+    out_ << "declare i32  @__tl_dir_create(ptr)\n";
+    out_ << "declare i32  @__tl_dir_delete(ptr)\n";
+    out_ << "declare i32  @__tl_dir_list_count(ptr)\n";
+    out_ << "declare ptr  @__tl_dir_list_entry(ptr, i32)\n";
+    out_ << "declare ptr  @__tl_dir_list_all(ptr)\n";
+    out_ << "declare i32  @__tl_dir_open(ptr)\n";
+    out_ << "declare ptr  @__tl_dir_next(i32)\n";
+    out_ << "declare i32  @__tl_spsc_new(i32)\n";
+    out_ << "declare i32  @__tl_spsc_push(i32, i32)\n";
+    out_ << "declare i32  @__tl_spsc_pop_or(i32, i32)\n";
+    out_ << "declare i32  @__tl_spsc_take(i32, i32)\n";
+    out_ << "declare i32  @__tl_spsc_len(i32)\n";
+    out_ << "declare i32  @__tl_spsc_closed(i32)\n";
+    out_ << "declare void @__tl_spsc_close(i32)\n";
+    out_ << "declare void @__tl_spsc_free(i32)\n";
+    out_ << "declare void @__tl_dir_close(i32)\n";
     out_ << "\n";
 }
 
@@ -278,16 +505,16 @@ void LLVMGen::emitFunc(const TIR::Func& fn, bool isMain) {
 
     out_ << "define " << llvmType(retTy) << " @" << sym << "(";
 
+    // `this` is named %arg_this, so declared params keep the 0-based
+    // numbering that ParamRef (and regRef) use.
     bool hasThis = !fn.className.empty() && !isMain;
-    int  argOffset = 0;
     if (hasThis) {
         out_ << "ptr %arg_this";
-        argOffset = 1;
         if (!fn.params.empty()) out_ << ", ";
     }
     for (int i = 0; i < (int)fn.params.size(); ++i) {
         if (i > 0) out_ << ", ";
-        out_ << llvmType(fn.params[i].first) << " %arg" << (i + argOffset);
+        out_ << llvmType(fn.params[i].first) << " %arg" << i;
     }
     out_ << ") {\n";
 
@@ -359,15 +586,24 @@ void LLVMGen::emitInstr(const TIR::Instr& ins) {
         const TIR::Val& r = ins.args[1];
         TIR::Type ty = effectiveType(l);
         if (ty.isVoid()) ty = ins.type;
-        bool fp = ty.isF64();
+        if (ins.op == Op::Add && ty.isStr()) {
+            out_ << "  " << regRef(ins.dest) << " = call ptr @__tl_str_concat(ptr "
+                 << llvmVal(l) << ", ptr " << llvmVal(r) << ")\n";
+            regTypes_[ins.dest] = ty;
+            break;
+        }
+        // int op float promotes the int side, as in TIRVM.
+        bool fp = ty.isF64() || effectiveType(r).isF64();
+        if (fp) ty = TIR::Type::f64();
+        std::string lv = fp ? asF64(l) : llvmVal(l);
+        std::string rv = fp ? asF64(r) : llvmVal(r);
         const char* llop =
             ins.op == Op::Add ? (fp ? "fadd" : "add")  :
             ins.op == Op::Sub ? (fp ? "fsub" : "sub")  :
             ins.op == Op::Mul ? (fp ? "fmul" : "mul")  :
                                 (fp ? "fdiv" : "sdiv");
         out_ << "  " << regRef(ins.dest) << " = " << llop
-             << " " << llvmType(ty) << " " << llvmVal(l)
-             << ", " << llvmVal(r) << "\n";
+             << " " << llvmType(ty) << " " << lv << ", " << rv << "\n";
         regTypes_[ins.dest] = ty;
         break;
     }
@@ -390,15 +626,17 @@ void LLVMGen::emitInstr(const TIR::Instr& ins) {
         const TIR::Val& r = ins.args[1];
         TIR::Type ty = effectiveType(l);
         if (ty.isVoid()) ty = ins.type;
-        bool fp = ty.isF64();
+        bool fp = ty.isF64() || effectiveType(r).isF64();
+        if (fp) ty = TIR::Type::f64();
+        std::string lv = fp ? asF64(l) : llvmVal(l);
+        std::string rv = fp ? asF64(r) : llvmVal(r);
         const char* llop =
             ins.op == Op::CmpEq ? (fp ? "fcmp oeq" : "icmp eq")  :
             ins.op == Op::CmpNe ? (fp ? "fcmp one" : "icmp ne")  :
             ins.op == Op::CmpLt ? (fp ? "fcmp olt" : "icmp slt") :
                                   (fp ? "fcmp ogt" : "icmp sgt");
         out_ << "  " << regRef(ins.dest) << " = " << llop
-             << " " << llvmType(ty) << " " << llvmVal(l)
-             << ", " << llvmVal(r) << "\n";
+             << " " << llvmType(ty) << " " << lv << ", " << rv << "\n";
         regTypes_[ins.dest] = TIR::Type::i1();
         break;
     }
@@ -492,7 +730,10 @@ void LLVMGen::emitInstr(const TIR::Instr& ins) {
             std::string ext = tmp("pext");
             out_ << "  " << ext << " = zext i1 " << val << " to i32\n";
             out_ << "  call void @__tl_print_i32(i32 " << ext << ")\n";
-        } else if (ty.isI32() || ty.isChar()) {
+        } else if (ty.isChar()) {
+            // TIRVM prints chars as characters, not codes.
+            out_ << "  call void @__tl_print_char(i32 " << val << ")\n";
+        } else if (ty.isI32()) {
             out_ << "  call void @__tl_print_i32(i32 " << val << ")\n";
         } else if (ty.isF64()) {
             out_ << "  call void @__tl_print_f64(double " << val << ")\n";
@@ -511,19 +752,41 @@ void LLVMGen::emitInstr(const TIR::Instr& ins) {
 
     // ── free-function call ─────────────────────────────────────────────────
     case Op::Call: {
+        // Math builtins become intrinsic calls; int arguments widen to double.
+        auto mi = mathIntrinsics().find(ins.name);
+        if (mi != mathIntrinsics().end()) {
+            std::vector<std::string> ops;
+            for (auto& a : ins.args) {
+                TIR::Type at = effectiveType(a);
+                if (at.isVoid()) at = a.type;
+                if (at.isF64()) { ops.push_back(llvmVal(a)); continue; }
+                std::string cv = tmp("mcv");
+                out_ << "  " << cv << " = sitofp i32 " << llvmVal(a) << " to double\n";
+                ops.push_back(cv);
+            }
+            std::string dest = tmp("math");
+            if (ins.dest != TIR::NOREG) {
+                dest = regRef(ins.dest);
+                regTypes_[ins.dest] = TIR::Type::f64();
+            }
+            out_ << "  " << dest << " = call double @" << mi->second << "(";
+            for (size_t i = 0; i < ops.size(); ++i)
+                out_ << (i ? ", " : "") << "double " << ops[i];
+            out_ << ")\n";
+            break;
+        }
+
         TIR::Type retTy = callRetType(ins.name);
         std::string sym  = funcSym(ins.name, "");
         bool hasRet = !retTy.isVoid() && ins.dest != TIR::NOREG;
 
+        std::vector<std::string> ops;
+        for (size_t i = 0; i < ins.args.size(); ++i)
+            ops.push_back(callArg(ins.name, i, ins.args[i]));
         out_ << "  ";
         if (hasRet) { out_ << regRef(ins.dest) << " = "; regTypes_[ins.dest] = retTy; }
         out_ << "call " << llvmType(retTy) << " @" << sym << "(";
-        for (int i = 0; i < (int)ins.args.size(); ++i) {
-            if (i > 0) out_ << ", ";
-            TIR::Type at = effectiveType(ins.args[i]);
-            if (at.isVoid()) at = ins.args[i].type;
-            out_ << llvmType(at) << " " << llvmVal(ins.args[i]);
-        }
+        for (size_t i = 0; i < ops.size(); ++i) out_ << (i ? ", " : "") << ops[i];
         out_ << ")\n";
         break;
     }
@@ -548,11 +811,11 @@ void LLVMGen::emitInstr(const TIR::Instr& ins) {
 
         std::string ctorKey = cls + "::init";
         if (prog_->funcs.count(ctorKey)) {
+            std::vector<std::string> ops;
+            for (size_t i = 0; i < ins.args.size(); ++i)
+                ops.push_back(callArg(ctorKey, i, ins.args[i]));
             out_ << "  call void @_TL_" << cls << "__init(ptr " << regRef(ins.dest);
-            for (auto& a : ins.args) {
-                TIR::Type at = effectiveType(a);
-                out_ << ", " << llvmType(at) << " " << llvmVal(a);
-            }
+            for (auto& op : ops) out_ << ", " << op;
             out_ << ")\n";
         }
         break;
@@ -600,14 +863,14 @@ void LLVMGen::emitInstr(const TIR::Instr& ins) {
         std::string key = cls + "::" + ins.name;
         TIR::Type retTy = callRetType(key);
         bool hasRet = !retTy.isVoid() && ins.dest != TIR::NOREG;
+        std::vector<std::string> ops;
+        for (size_t i = 1; i < ins.args.size(); ++i)
+            ops.push_back(callArg(key, i - 1, ins.args[i]));
         out_ << "  ";
         if (hasRet) { out_ << regRef(ins.dest) << " = "; regTypes_[ins.dest] = retTy; }
         out_ << "call " << llvmType(retTy) << " @_TL_" << cls << "__" << ins.name
              << "(ptr " << llvmVal(ins.args[0]);
-        for (int i = 1; i < (int)ins.args.size(); ++i) {
-            TIR::Type at = effectiveType(ins.args[i]);
-            out_ << ", " << llvmType(at) << " " << llvmVal(ins.args[i]);
-        }
+        for (auto& op : ops) out_ << ", " << op;
         out_ << ")\n";
         break;
     }
@@ -617,14 +880,14 @@ void LLVMGen::emitInstr(const TIR::Instr& ins) {
         std::string key = cls + "::" + ins.name;
         TIR::Type retTy = callRetType(key);
         bool hasRet = !retTy.isVoid() && ins.dest != TIR::NOREG;
+        std::vector<std::string> ops;
+        for (size_t i = 0; i < ins.args.size(); ++i)
+            ops.push_back(callArg(key, i, ins.args[i]));
         out_ << "  ";
         if (hasRet) { out_ << regRef(ins.dest) << " = "; regTypes_[ins.dest] = retTy; }
         out_ << "call " << llvmType(retTy) << " @_TL_" << cls << "__" << ins.name
              << "(ptr %arg_this";
-        for (auto& a : ins.args) {
-            TIR::Type at = effectiveType(a);
-            out_ << ", " << llvmType(at) << " " << llvmVal(a);
-        }
+        for (auto& op : ops) out_ << ", " << op;
         out_ << ")\n";
         break;
     }
@@ -647,6 +910,22 @@ void LLVMGen::emitInstr(const TIR::Instr& ins) {
     case Op::LoadArr: {
         const TIR::Val& arr = ins.args[0];
         const TIR::Val& idx = ins.args[1];
+        // Primitive arrays (including @soa columns) are read in place, so
+        // a loop over one compiles to plain loads LLVM can optimise.
+        TIR::Type ety = primElemType(arr);
+        if (!ety.isVoid()) {
+            std::string slot = arrSlot(arr, idx);
+            if (ety.isF64()) {
+                out_ << "  " << regRef(ins.dest) << " = load double, ptr " << slot << ", align 8\n";
+            } else {
+                std::string raw = tmp("arrl");
+                out_ << "  " << raw << " = load i64, ptr " << slot << ", align 8\n";
+                out_ << "  " << regRef(ins.dest) << (ety.isI1() ? " = icmp ne i64 " : " = trunc i64 ")
+                     << raw << (ety.isI1() ? ", 0\n" : " to i32\n");
+            }
+            regTypes_[ins.dest] = ety;
+            break;
+        }
         TIR::Type ity = effectiveType(idx);
         std::string raw = tmp("arrl");
         out_ << "  " << raw << " = call i64 @__tl_load_arr(ptr "
@@ -659,7 +938,14 @@ void LLVMGen::emitInstr(const TIR::Instr& ins) {
             regTypes_[ins.dest] = TIR::Type::f64();
         } else {
             out_ << "  " << regRef(ins.dest) << " = inttoptr i64 " << raw << " to ptr\n";
-            regTypes_[ins.dest] = ins.type;
+            // Pointer elements keep the array's element type for later uses.
+            TIR::Type at = effectiveType(arr);
+            if (ins.type.isVoid() && at.isArr() && at.name == "string")
+                regTypes_[ins.dest] = TIR::Type::str();
+            else if (ins.type.isVoid() && at.isArr() && prog_->classes.count(at.name))
+                regTypes_[ins.dest] = TIR::Type::obj(at.name);
+            else
+                regTypes_[ins.dest] = ins.type;
         }
         break;
     }
@@ -670,6 +956,19 @@ void LLVMGen::emitInstr(const TIR::Instr& ins) {
         const TIR::Val& arr = ins.args[1];
         const TIR::Val& idx = ins.args[2];
         TIR::Type vty = effectiveType(val);
+        TIR::Type ety = primElemType(arr);
+        if (ety.isF64() || (!ety.isVoid() && !vty.isF64())) {
+            std::string v = ety.isF64() ? asF64(val) : llvmVal(val);
+            std::string slot = arrSlot(arr, idx);
+            if (ety.isF64()) {
+                out_ << "  store double " << v << ", ptr " << slot << ", align 8\n";
+            } else {
+                std::string raw = tmp("arsv");
+                out_ << "  " << raw << " = zext " << (vty.isI1() ? "i1 " : "i32 ") << v << " to i64\n";
+                out_ << "  store i64 " << raw << ", ptr " << slot << ", align 8\n";
+            }
+            break;
+        }
         TIR::Type ity = effectiveType(idx);
         std::string raw = tmp("arsv");
         if (vty.isI32() || vty.isChar() || vty.isI1())
@@ -789,7 +1088,7 @@ std::string LLVMGen::emit(const TIR::Program& prog) {
     buildRetTypeMap();
 
     out_ << "; Generated by TinyLang LLVM backend (Phase 4.5)\n";
-    out_ << "; Compile: clang <this.ll> runtime/native/tinyrt.c -o program\n";
+    out_ << "; Compile: clang <this.ll> runtime/native/tinyrt.c -lpthread -lm -o program\n";
     out_ << "source_filename = \"tinylang\"\n";
     out_ << "target triple = \"arm64-apple-macosx15.0.0\"\n\n";
 
@@ -88,6 +88,17 @@ private:
     std::string regRef(TIR::Reg r) const;
     // LLVM symbol name for a TinyLang function.
     std::string funcSym(const std::string& name, const std::string& cls = "") const;
+    // "type value" for argument i of a call to key; int → float params
+    // are widened with sitofp.
+    std::string callArg(const std::string& key, size_t i, const TIR::Val& a);
+    // v as a double operand, widening int-like values with sitofp.
+    std::string asF64(const TIR::Val& v);
+
+    // ── Arrays ────────────────────────────────────────────────────────────
+    // Element type of a primitive (int/float/char/bool) array, else void.
+    TIR::Type primElemType(const TIR::Val& arr) const;
+    // Emits the null/bounds check for arr[idx]; returns the slot's address.
+    std::string arrSlot(const TIR::Val& arr, const TIR::Val& idx);
     // Exact hex float literal for a double (avoids decimal rounding).
     static std::string hexFloat(double d);
 };
@@ -11,9 +11,12 @@
 #include "cfg.hpp"
 #include "bytecode.hpp"
 #include "irvm.hpp"
+#include "irresolve.hpp"
+#include "prune.hpp"
 // New register-based TIR pipeline
 #include "tirgen.hpp"
 #include "tirvm.hpp"
+#include "treewalk.hpp"
 // LLVM backend
 #include "llvmgen.hpp"
 #include <unordered_set>
@@ -45,8 +48,9 @@ std::vector<std::unique_ptr<Statement>> parseFile(const std::string& filepath) {
 static void prescanForClassNames(const std::vector<Token>& tokens,
                                   const std::string& base_dir) {
     for (size_t i = 0; i < tokens.size(); ++i) {
-        // Register class names defined in this file.
-        if (tokens[i].type == TokenType::CLASS &&
+        // Register class and struct names defined in this file.
+        if ((tokens[i].type == TokenType::CLASS ||
+             tokens[i].type == TokenType::STRUCT) &&
             i + 1 < tokens.size() &&
             tokens[i + 1].type == TokenType::IDENTIFIER) {
             g_class_names.insert(tokens[i + 1].value);
@@ -89,7 +93,7 @@ std::vector<std::unique_ptr<Statement>> processImports(
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         std::cerr << "Usage: tinylang <file.tl|file.tlc> "
-                     "[--compile] [--dump-ir] [--dump-cfg] [--old-ir] "
+                     "[--compile [--tir]] [--tree-walk] [--dump-ir] [--dump-cfg] [--old-ir] [--opt-stats] "
                      "[--emit-llvm [out.ll]]\n";
         return 1;
     }
@@ -114,11 +118,27 @@ int main(int argc, char* argv[]) {
                       filepath.compare(filepath.size()-4, 4, ".tlc") == 0;
 
     try {
+        // ── Pre-compiled TIR bytecode: use TIRVM ──────────────────────────
+        if (isBytecode && bytecodeKind(filepath) == BytecodeKind::TIR) {
+            TIR::Program tir = readTIRBytecode(filepath);
+            if (hasFlag("--dump-ir") || hasFlag("-ir")) dumpTIR(tir);
+            if (hasFlag("--dump-cfg"))
+                std::cerr << "--dump-cfg: not available for TIR .tlc files; "
+                             "run it on the source file\n";
+            runTIR(tir);
+            return 0;
+        }
+
         // ── Pre-compiled bytecode: use legacy VM ──────────────────────────
         if (isBytecode) {
             IRProgram ir = readBytecode(filepath);
             if (hasFlag("--dump-ir") || hasFlag("-ir")) dumpIR(ir);
-            if (hasFlag("--dump-cfg")) {
+            // v2 files hold label-free, slot-resolved code; the CFG needs
+            // the label-based form, so dump it from the source instead.
+            if (hasFlag("--dump-cfg") && ir.jumpsResolved) {
+                std::cerr << "--dump-cfg: not available for TLBC v2 files; "
+                             "run it on the source file\n";
+            } else if (hasFlag("--dump-cfg")) {
                 auto dumpOne = [](const std::string& name,
                                   const std::vector<IRInstr>& code) {
                     CFG cfg = CFG::build(name, code);
@@ -130,6 +150,7 @@ int main(int argc, char* argv[]) {
                 dumpOne("[main]", ir.main);
                 for (auto& [k, fn] : ir.functions) dumpOne(k, fn.code);
             }
+            resolveForVM(ir);
             runIR(ir);
             return 0;
         }
@@ -150,23 +171,52 @@ int main(int argc, char* argv[]) {
         statements      = processImports(std::move(statements), base_dir);
         semanticAnalyze(statements);
 
+        // --tree-walk: run the AST directly, skipping all lowering
+        if (hasFlag("--tree-walk")) {
+            runTreeWalk(statements);
+            return 0;
+        }
+
+        std::string tlcOut = filepath.substr(
+            0, filepath.rfind('.') != std::string::npos
+               ? filepath.rfind('.') : filepath.size()) + ".tlc";
+
+        // --compile --tir: write register-based TIR bytecode, then exit
+        if (hasFlag("--compile") && hasFlag("--tir")) {
+            TIR::Program tir = generateTIR(statements);
+            pruneUnreachable(tir);
+            if (writeTIRBytecode(tir, tlcOut))
+                std::cerr << "Compiled to " << tlcOut << "\n";
+            else
+                std::cerr << "Failed to write " << tlcOut << "\n";
+            return 0;
+        }
+
         // ── Legacy path: --compile, --dump-cfg, or --old-ir ──────────────
         bool needOldIR = hasFlag("--compile") || hasFlag("--dump-cfg") || hasFlag("--old-ir");
         IRProgram ir;
         if (needOldIR) {
             ir = generateIR(statements);
-            ir = runOptimizationPasses(ir);
+            pruneUnreachable(ir);
+            OptStats stats;
+            ir = runOptimizationPasses(ir, &stats);
+            if (hasFlag("--opt-stats")) {
+                std::cerr << "=== Optimization passes (runs / changes) ===\n";
+                for (const auto& p : stats.passes)
+                    std::cerr << "  " << p.name << ": " << p.runs
+                              << " / " << p.changes << "\n";
+                if (stats.budgetExhausted)
+                    std::cerr << "  budget exhausted in " << stats.budgetExhausted
+                              << " code unit(s)\n";
+            }
         }
 
         // --compile: write .tlc bytecode using legacy IR, then exit
         if (hasFlag("--compile")) {
-            std::string out = filepath.substr(
-                0, filepath.rfind('.') != std::string::npos
-                   ? filepath.rfind('.') : filepath.size()) + ".tlc";
-            if (writeBytecode(ir, out))
-                std::cerr << "Compiled to " << out << "\n";
+            if (writeBytecode(ir, tlcOut))
+                std::cerr << "Compiled to " << tlcOut << "\n";
             else
-                std::cerr << "Failed to write " << out << "\n";
+                std::cerr << "Failed to write " << tlcOut << "\n";
             return 0;
         }
 
@@ -185,12 +235,14 @@ int main(int argc, char* argv[]) {
                 dumpOne("[main]", ir.main);
                 for (auto& [k, fn] : ir.functions) dumpOne(k, fn.code);
             }
+            resolveForVM(ir);
             runIR(ir);
             return 0;
         }
 
         // ── Default: generate TIR and execute with TIRVM ──────────────────
         TIR::Program tir = generateTIR(statements);
+        pruneUnreachable(tir);
 
         if (hasFlag("--dump-ir") || hasFlag("-ir")) dumpTIR(tir);
 
@@ -213,7 +265,7 @@ int main(int argc, char* argv[]) {
             out << llvmIR;
             std::cerr << "LLVM IR written to " << llvmOut << "\n";
             std::cerr << "To compile: clang " << llvmOut
-                      << " runtime/native/tinyrt.c -o program\n";
+                      << " runtime/native/tinyrt.c -lpthread -lm -o program\n";
             return 0;
         }
 
@@ -33,8 +33,8 @@ enum class IROp {
     AND, OR, NOT,
 
     // Control flow
-    JUMP,            // sval = label name
-    JUMP_FALSE,      // pop; if 0/false → jump to sval
+    JUMP,            // sval = label name  (after resolveJumps: ival = target index)
+    JUMP_FALSE,      // pop; if 0/false → jump to sval  (ditto)
     LABEL,           // sval = label name  (no-op at runtime, marks position)
 
     // Functions
@@ -55,6 +55,7 @@ enum class IROp {
     NEW_OBJ,         // sval = className, ival = argc;
                      //   pop argc args → create object → call init if argc>0 → push handle
     LOAD_FIELD,      // sval = fieldName;  pop obj handle → push field value
+                     //   (aux = field index + 1 once resolveForVM knows it)
     STORE_FIELD,     // sval = fieldName;  pop value, pop obj handle → store field
     CALL_METHOD,     // sval = methodName, ival = argc;
                      //   stack (bottom→top): obj_handle, arg0 … argN-1
@@ -71,6 +72,24 @@ enum class IROp {
     EXIT_SCOPE,
 
     NOP,
+
+    // ── Ops added after TLBC v1 (appended so v1 opcode numbers stay stable) ──
+
+    // Slot-resolved variable access (produced by resolveSlots, never by IRGen)
+    LOAD_SLOT,       // ival = frame slot  →  push value      (sval keeps the name)
+    STORE_SLOT,      // ival = frame slot  ←  pop value       (DECLARE and STORE)
+
+    // Superinstructions (produced by fuseSuperinstructions on slot-resolved code)
+    INC_SLOT,        // ival = slot, aux = k:  slot += k
+                     //   (LOAD_SLOT x; PUSH_INT k; ADD|SUB; STORE_SLOT x)
+    CMP_LT_JUMP_FALSE,   // CMP_xx; JUMP_FALSE L  —  pop r, pop l; jump unless l xx r
+    CMP_GT_JUMP_FALSE,   //   sval = label (after resolveJumps: ival = target index)
+    CMP_EQ_JUMP_FALSE,
+    CMP_NEQ_JUMP_FALSE,
+    LOAD_FIELD_THIS, // sval = fieldName:  PUSH_THIS; LOAD_FIELD f  (aux as LOAD_FIELD)
+    LOAD_SLOT2,      // ival = a, aux = b:  LOAD_SLOT a; LOAD_SLOT b
+    MOVE_SLOT,       // ival = dst, aux = src:  LOAD_SLOT src; STORE_SLOT dst
+    STORE_LOAD_SLOT, // ival = dst, aux = src:  STORE_SLOT dst; LOAD_SLOT src
 };
 
 // ---------------------------------------------------------------------------
@@ -82,6 +101,10 @@ struct IRInstr {
     int         ival = 0;    // integer operand or literal value
     double      dval = 0.0;  // float literal
     char        cval = 0;    // char literal
+    int         aux  = 0;    // second integer operand (superinstructions)
+    int         sidx = -1;   // sval as an index into IRProgram::strings
+                             //   (set by resolveForVM / the TLBC v2 loader;
+                             //   IRVM reads names only through it)
 };
 
 // ---------------------------------------------------------------------------
@@ -92,6 +115,11 @@ struct IRFunction {
     std::string className;   // non-empty for class methods
     std::vector<std::pair<std::string, std::string>> params; // (type, paramName)
     std::vector<IRInstr> code;
+
+    // Filled by resolveSlots (irresolve.hpp):
+    int              numSlots = 0;   // frame size
+    std::vector<int> paramSlots;     // slot of each parameter
+    std::vector<int> fieldSlots;     // slot of each field of className, in layout order
 };
 
 // ---------------------------------------------------------------------------
@@ -110,4 +138,12 @@ struct IRProgram {
     std::vector<IRInstr>                         main;       // top-level code
     std::unordered_map<std::string, IRFunction>  functions;  // name → function
     std::unordered_map<std::string, IRClass>     classes;    // name → class
+
+    int  mainSlots     = 0;      // frame size of main (set by resolveSlots)
+    bool slotsResolved = false;
+    bool jumpsResolved = false;  // LABELs stripped, jump targets in ival
+
+    // String pool for IRInstr::sidx.  A program loaded from TLBC v2 has
+    // only the pool: its instructions' sval is left empty.
+    std::vector<std::string> strings;
 };
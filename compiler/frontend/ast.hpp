@@ -176,6 +176,9 @@ struct ClassDef : Statement {
     std::string baseClass; // empty if no inheritance
     std::vector<std::pair<std::string, std::string>> fields; // (type, name)
     std::vector<std::unique_ptr<FunctionDef>> methods;
+    std::vector<std::string> typeParams; // class Vec<T> { ... }; empty if not generic
+    bool isStruct = false;               // struct Point { ... }: value type, fields only
+    bool soa      = false;               // @soa struct: arrays keep one array per field
     ClassDef(std::string n,
              std::string base,
              std::vector<std::pair<std::string, std::string>> f,
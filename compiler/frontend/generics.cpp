@@ -0,0 +1,289 @@
+#include "generics.hpp"
+
+#include <deque>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// ── Deep copy of the AST ────────────────────────────────────────────────────
+
+std::vector<std::unique_ptr<Expr>> cloneExprs(const std::vector<std::unique_ptr<Expr>>& v) {
+    std::vector<std::unique_ptr<Expr>> out;
+    for (auto& e : v) out.push_back(cloneExpr(e.get()));
+    return out;
+}
+
+std::vector<std::unique_ptr<Statement>> cloneBody(const std::vector<std::unique_ptr<Statement>>& v) {
+    std::vector<std::unique_ptr<Statement>> out;
+    for (auto& s : v) out.push_back(cloneStmt(s.get()));
+    return out;
+}
+
+std::unique_ptr<Expr> cloneExprNode(const Expr* e) {
+    if (auto n = dynamic_cast<const Number*>(e))        return std::make_unique<Number>(n->value);
+    if (auto n = dynamic_cast<const FloatLiteral*>(e))  return std::make_unique<FloatLiteral>(n->value);
+    if (auto n = dynamic_cast<const BoolLiteral*>(e))   return std::make_unique<BoolLiteral>(n->value);
+    if (auto n = dynamic_cast<const CharLiteral*>(e))   return std::make_unique<CharLiteral>(n->value);
+    if (auto n = dynamic_cast<const StringLiteral*>(e)) return std::make_unique<StringLiteral>(n->value);
+    if (auto n = dynamic_cast<const Variable*>(e))      return std::make_unique<Variable>(n->name);
+    if (dynamic_cast<const InputExpr*>(e))              return std::make_unique<InputExpr>();
+    if (auto n = dynamic_cast<const ReadExpr*>(e))      return std::make_unique<ReadExpr>(n->filename);
+    if (auto n = dynamic_cast<const BinaryExpr*>(e))
+        return std::make_unique<BinaryExpr>(cloneExpr(n->left.get()), n->op, cloneExpr(n->right.get()));
+    if (auto n = dynamic_cast<const UnaryExpr*>(e))
+        return std::make_unique<UnaryExpr>(n->op, cloneExpr(n->operand.get()));
+    if (auto n = dynamic_cast<const CallExpr*>(e))
+        return std::make_unique<CallExpr>(n->callee, cloneExprs(n->arguments));
+    if (auto n = dynamic_cast<const ArrayLiteral*>(e))
+        return std::make_unique<ArrayLiteral>(cloneExprs(n->elements));
+    if (auto n = dynamic_cast<const ArrayAccess*>(e))
+        return std::make_unique<ArrayAccess>(n->arrayName, cloneExpr(n->index.get()));
+    if (auto n = dynamic_cast<const ObjectMemberAccess*>(e))
+        return std::make_unique<ObjectMemberAccess>(cloneExpr(n->object.get()), n->member);
+    if (auto n = dynamic_cast<const ObjectMethodCall*>(e))
+        return std::make_unique<ObjectMethodCall>(cloneExpr(n->object.get()), n->method,
+                                                  cloneExprs(n->arguments));
+    if (auto n = dynamic_cast<const CastExpr*>(e))
+        return std::make_unique<CastExpr>(n->targetType, cloneExpr(n->operand.get()));
+    throw std::runtime_error("Generic instantiation: unsupported expression");
+}
+
+} // namespace
+
+std::unique_ptr<Expr> cloneExpr(const Expr* e) {
+    if (!e) return nullptr;
+    auto out = cloneExprNode(e);
+    out->line = e->line;
+    return out;
+}
+
+namespace {
+
+std::unique_ptr<FunctionDef> cloneFunction(const FunctionDef* fn) {
+    auto out = std::make_unique<FunctionDef>(fn->name, fn->params, cloneBody(fn->body));
+    out->line = fn->line;
+    return out;
+}
+
+std::unique_ptr<Statement> cloneStmtNode(const Statement* s) {
+    if (auto n = dynamic_cast<const Assignment*>(s))
+        return std::make_unique<Assignment>(n->name, cloneExpr(n->value.get()), n->type);
+    if (auto n = dynamic_cast<const Print*>(s))
+        return std::make_unique<Print>(cloneExpr(n->value.get()));
+    if (auto n = dynamic_cast<const FunctionDef*>(s))
+        return cloneFunction(n);
+    if (auto n = dynamic_cast<const Return*>(s))
+        return std::make_unique<Return>(cloneExpr(n->value.get()));
+    if (auto n = dynamic_cast<const IfStatement*>(s))
+        return std::make_unique<IfStatement>(cloneExpr(n->condition.get()),
+                                             cloneBody(n->thenBranch), cloneBody(n->elseBranch));
+    if (auto n = dynamic_cast<const WhileStatement*>(s))
+        return std::make_unique<WhileStatement>(cloneExpr(n->condition.get()), cloneBody(n->body));
+    if (auto n = dynamic_cast<const ForStatement*>(s))
+        return std::make_unique<ForStatement>(cloneStmt(n->initializer.get()),
+                                              cloneExpr(n->condition.get()),
+                                              cloneStmt(n->increment.get()), cloneBody(n->body));
+    if (auto n = dynamic_cast<const ExprStatement*>(s))
+        return std::make_unique<ExprStatement>(cloneExpr(n->expr.get()));
+    if (auto n = dynamic_cast<const ArrayAssignment*>(s))
+        return std::make_unique<ArrayAssignment>(n->arrayName, cloneExpr(n->index.get()),
+                                                 cloneExpr(n->value.get()));
+    if (auto n = dynamic_cast<const ObjectInstantiation*>(s))
+        return std::make_unique<ObjectInstantiation>(n->className, n->varName,
+                                                     cloneExprs(n->arguments));
+    if (auto n = dynamic_cast<const ImportStatement*>(s))
+        return std::make_unique<ImportStatement>(n->filename);
+    if (auto n = dynamic_cast<const ClassDef*>(s)) {
+        std::vector<std::unique_ptr<FunctionDef>> methods;
+        for (auto& m : n->methods) methods.push_back(cloneFunction(m.get()));
+        auto out = std::make_unique<ClassDef>(n->name, n->baseClass, n->fields, std::move(methods));
+        out->typeParams = n->typeParams;
+        out->isStruct   = n->isStruct;
+        out->soa        = n->soa;
+        return out;
+    }
+    throw std::runtime_error("Generic instantiation: unsupported statement");
+}
+
+} // namespace
+
+std::unique_ptr<Statement> cloneStmt(const Statement* s) {
+    if (!s) return nullptr;
+    auto out = cloneStmtNode(s);
+    out->line = s->line;
+    return out;
+}
+
+namespace {
+
+using Subst = std::unordered_map<std::string, std::string>;   // T -> concrete
+
+// Cap on instantiations, so `class Node<T> { ... Node<Node<T>> ... }` stops
+// with an error instead of expanding forever.
+constexpr size_t kMaxInstances = 1000;
+
+// ── Type strings ────────────────────────────────────────────────────────────
+//
+// The parser spells generic uses as "Name<arg,...>" (args nest), with an
+// optional "[]" suffix for arrays of objects.
+
+struct TypeRef {
+    std::string          name;
+    std::vector<TypeRef> args;
+};
+
+TypeRef parseTypeRef(const std::string& s, size_t& i) {
+    TypeRef t;
+    while (i < s.size() && s[i] != '<' && s[i] != ',' && s[i] != '>') t.name += s[i++];
+    if (i < s.size() && s[i] == '<') {
+        do {
+            ++i;   // '<' or ','
+            t.args.push_back(parseTypeRef(s, i));
+        } while (i < s.size() && s[i] == ',');
+        ++i;       // '>'
+    }
+    return t;
+}
+
+class Instantiator {
+public:
+    void run(std::vector<std::unique_ptr<Statement>>& program) {
+        // Take the templates out; a null slot marks where their
+        // instantiations go, so they keep the template's position.
+        for (auto& s : program) {
+            auto cd = dynamic_cast<ClassDef*>(s.get());
+            if (!cd || cd->typeParams.empty()) continue;
+            if (templates_.count(cd->name))
+                throw std::runtime_error("Generic class '" + cd->name + "' defined twice");
+            slotNames_.push_back(cd->name);
+            templates_[cd->name].def.reset(static_cast<ClassDef*>(s.release()));
+        }
+
+        const Subst none;
+        for (auto& s : program)
+            if (s) rewrite(s.get(), none);
+
+        while (!pending_.empty()) {
+            Pending p = std::move(pending_.front());
+            pending_.pop_front();
+            Template& tpl = templates_[p.templateName];
+            auto inst = cloneStmt(tpl.def.get());
+            auto* cd  = static_cast<ClassDef*>(inst.get());
+            Subst sub;
+            for (size_t i = 0; i < cd->typeParams.size(); ++i)
+                sub[cd->typeParams[i]] = p.args[i];
+            cd->name = p.mangled;
+            cd->typeParams.clear();
+            rewrite(cd, sub);
+            tpl.instances.push_back(std::move(inst));
+        }
+
+        std::vector<std::unique_ptr<Statement>> out;
+        size_t next = 0;
+        for (auto& s : program) {
+            if (s) { out.push_back(std::move(s)); continue; }
+            Template& tpl = templates_[slotNames_[next++]];
+            for (auto& inst : tpl.instances) out.push_back(std::move(inst));
+        }
+        program = std::move(out);
+    }
+
+private:
+    std::string resolve(const std::string& type, const Subst& sub) {
+        if (type.empty()) return type;
+        std::string base = type, suffix;
+        if (base.size() > 2 && base.compare(base.size() - 2, 2, "[]") == 0) {
+            suffix = "[]";
+            base.resize(base.size() - 2);
+        }
+        size_t i = 0;
+        return resolveRef(parseTypeRef(base, i), sub) + suffix;
+    }
+
+    struct Template {
+        std::unique_ptr<ClassDef>               def;
+        std::vector<std::unique_ptr<Statement>> instances;
+    };
+    struct Pending {
+        std::string              templateName, mangled;
+        std::vector<std::string> args;
+    };
+
+    std::unordered_map<std::string, Template> templates_;
+    std::vector<std::string>                  slotNames_;   // template per null slot
+    std::unordered_set<std::string>           made_;        // mangled names queued
+    std::deque<Pending>                       pending_;
+
+    std::string resolveRef(const TypeRef& t, const Subst& sub) {
+        if (t.args.empty()) {
+            auto s = sub.find(t.name);
+            if (s != sub.end()) return s->second;
+            if (templates_.count(t.name))
+                throw std::runtime_error("Generic class '" + t.name +
+                                         "' used without type arguments");
+            return t.name;
+        }
+        auto it = templates_.find(t.name);
+        if (it == templates_.end())
+            throw std::runtime_error("'" + t.name + "' is not a generic class");
+        const auto& params = it->second.def->typeParams;
+        if (params.size() != t.args.size())
+            throw std::runtime_error("Generic class '" + t.name + "' expects " +
+                                     std::to_string(params.size()) + " type argument(s), got " +
+                                     std::to_string(t.args.size()));
+        Pending p;
+        p.templateName = t.name;
+        p.mangled      = t.name;
+        for (auto& a : t.args) {
+            p.args.push_back(resolveRef(a, sub));
+            p.mangled += "$" + p.args.back();
+        }
+        std::string mangled = p.mangled;
+        if (!made_.count(mangled)) {
+            if (made_.size() == kMaxInstances)
+                throw std::runtime_error("Too many instantiations of generic class '" +
+                                         t.name + "' (recursive type arguments?)");
+            made_.insert(mangled);
+            pending_.push_back(std::move(p));
+        }
+        return mangled;
+    }
+
+    void rewriteBody(std::vector<std::unique_ptr<Statement>>& body, const Subst& sub) {
+        for (auto& s : body) rewrite(s.get(), sub);
+    }
+
+    void rewriteFunction(FunctionDef* fn, const Subst& sub) {
+        for (auto& p : fn->params) p.first = resolve(p.first, sub);
+        rewriteBody(fn->body, sub);
+    }
+
+    void rewrite(Statement* s, const Subst& sub) {
+        if (!s) return;
+        if (auto n = dynamic_cast<Assignment*>(s))               n->type = resolve(n->type, sub);
+        else if (auto n = dynamic_cast<ObjectInstantiation*>(s)) n->className = resolve(n->className, sub);
+        else if (auto n = dynamic_cast<FunctionDef*>(s))         rewriteFunction(n, sub);
+        else if (auto n = dynamic_cast<IfStatement*>(s)) {
+            rewriteBody(n->thenBranch, sub);
+            rewriteBody(n->elseBranch, sub);
+        } else if (auto n = dynamic_cast<WhileStatement*>(s)) {
+            rewriteBody(n->body, sub);
+        } else if (auto n = dynamic_cast<ForStatement*>(s)) {
+            rewrite(n->initializer.get(), sub);
+            rewrite(n->increment.get(), sub);
+            rewriteBody(n->body, sub);
+        } else if (auto n = dynamic_cast<ClassDef*>(s)) {
+            n->baseClass = resolve(n->baseClass, sub);
+            for (auto& f : n->fields) f.first = resolve(f.first, sub);
+            for (auto& m : n->methods) rewriteFunction(m.get(), sub);
+        }
+    }
+};
+
+} // namespace
+
+void instantiateGenerics(std::vector<std::unique_ptr<Statement>>& program) {
+    Instantiator().run(program);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "ast.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Generic class instantiation (monomorphization).
+//
+// `class Vec<T> { T buf[]; ... }` is a template: every distinct use such as
+// `Vec<int> v(4);` gets its own copy of the class with T substituted,
+// renamed to a mangled name ("Vec$int", "Pair$string$Vec$int").  The
+// templates themselves are removed, so semantic analysis, TIRGen, the tree
+// walker and the LLVM backend only ever see ordinary concrete classes —
+// each instantiation gets typed fields, locals and parameters instead of
+// sharing one erased implementation.
+//
+// Throws std::runtime_error for an unknown generic, a wrong number of type
+// arguments or a generic class used without type arguments.
+// ---------------------------------------------------------------------------
+
+void instantiateGenerics(std::vector<std::unique_ptr<Statement>>& program);
+
+// Deep copies of AST subtrees (nullptr in, nullptr out).
+std::unique_ptr<Expr>      cloneExpr(const Expr* e);
+std::unique_ptr<Statement> cloneStmt(const Statement* s);
@@ -74,6 +74,7 @@ std::vector<Token> tokenize(const std::string& input) {
             else if (id == "read") type = TokenType::READ;
             else if (id == "input") type = TokenType::INPUT;
             else if (id == "class") type = TokenType::CLASS;
+            else if (id == "struct") type = TokenType::STRUCT;
             else if (id == "import") type = TokenType::IMPORT;
             else if (id == "true" || id == "false") type = TokenType::BOOLEAN_LITERAL;
             else type = TokenType::IDENTIFIER;
@@ -185,6 +186,7 @@ std::vector<Token> tokenize(const std::string& input) {
                     break;
                 case '.': type = TokenType::DOT; val = "."; break;
                 case ':': type = TokenType::COLON; val = ":"; break;
+                case '@': type = TokenType::AT; val = "@"; break;
                 default:
                     std::cerr << "Unknown character: " << c << " at line " << line << ", column " << col << "\n";
                     valid = false;
@@ -45,8 +45,10 @@ enum class TokenType {
     OR,              // ||
     NOT,             // !
     CLASS,           // class keyword
+    STRUCT,          // struct keyword (value type)
     DOT,             // . operator for member access
     COLON,           // : for inheritance
+    AT,              // @ before an annotation (@soa)
     IMPORT,          // import keyword
 };
 
@@ -8,11 +8,15 @@ static std::vector<Token> tokens;
 static std::unique_ptr<Statement> parseFunction();
 static std::unique_ptr<Expr> parseExpression();
 static std::vector<std::pair<std::string, std::string>> parseParameterList();
-static std::unique_ptr<Statement> parseClass();
+static std::unique_ptr<Statement> parseClass(bool isStruct = false);
 
 // Forward declaration for class name lookup
 extern std::unordered_set<std::string> g_class_names;
 
+// Type parameters of the generic class being parsed (class Vec<T> { ... });
+// inside its body they are accepted wherever a primitive type is.
+static std::unordered_set<std::string> classTypeParams;
+
 // Helper to format error messages with line/column
 static std::string errorMsg(const std::string& msg, const Token& token) {
     return msg + " at line " + std::to_string(token.line) + ", column " + std::to_string(token.column);
@@ -38,6 +42,59 @@ static bool match(TokenType type) {
     return false;
 }
 
+// True at "T name" where T is a type parameter of the enclosing class.
+static bool atTypeParamDecl() {
+    return peek().type == TokenType::IDENTIFIER &&
+           classTypeParams.count(peek().value) &&
+           current + 1 < tokens.size() &&
+           tokens[current + 1].type == TokenType::IDENTIFIER;
+}
+
+// Parses "<arg, ...>" after a generic class name and returns the type
+// spelled "Name<arg,...>"; generics.cpp turns it into a concrete class.
+static std::string parseTypeArgs(const std::string& name) {
+    if (!match(TokenType::LESSTHEN))
+        throw std::runtime_error(errorMsg("Expected '<' after generic class name", peek()));
+    std::string ty = name + "<";
+    do {
+        Token t = advance();
+        std::string arg;
+        switch (t.type) {
+            case TokenType::INT: arg = "int"; break;
+            case TokenType::FLOAT: arg = "float"; break;
+            case TokenType::CHAR: arg = "char"; break;
+            case TokenType::BOOL: arg = "bool"; break;
+            case TokenType::STRING_TYPE: arg = "string"; break;
+            case TokenType::IDENTIFIER:
+                arg = t.value;
+                if (check(TokenType::LESSTHEN)) arg = parseTypeArgs(arg);
+                break;
+            default:
+                throw std::runtime_error(errorMsg("Expected type argument", t));
+        }
+        if (ty.back() != '<') ty += ",";
+        ty += arg;
+    } while (match(TokenType::COMMA));
+    if (!match(TokenType::GREATERTHEN))
+        throw std::runtime_error(errorMsg("Expected '>' after type arguments", peek()));
+    return ty + ">";
+}
+
+// True at "Name var" / "Name<args> var" where Name is a class or struct.
+static bool atClassTypeDecl() {
+    if (peek().type != TokenType::IDENTIFIER || !g_class_names.count(peek().value) ||
+        current + 1 >= tokens.size())
+        return false;
+    TokenType next = tokens[current + 1].type;
+    return next == TokenType::IDENTIFIER || next == TokenType::LESSTHEN;
+}
+
+static std::string parseClassType() {
+    std::string name = advance().value;
+    if (check(TokenType::LESSTHEN)) name = parseTypeArgs(name);
+    return name;
+}
+
 static std::unique_ptr<Expr> parseArrayLiteral() {
     std::vector<std::unique_ptr<Expr>> elements;
     if (!match(TokenType::RBRACE)) {
@@ -282,6 +339,9 @@ static std::unique_ptr<Statement> parseSimpleAssignment() {
                 target += chain[i];
             }
             return std::make_unique<Assignment>(target, std::move(expr));
+        } else if (auto arr = dynamic_cast<ArrayAccess*>(lhs.get())) {
+            return std::make_unique<ArrayAssignment>(arr->arrayName, std::move(arr->index),
+                                                     std::move(expr));
         } else {
             throw std::runtime_error("Unsupported assignment target");
         }
@@ -299,8 +359,21 @@ static std::unique_ptr<Statement> parseStatement() {
             throw std::runtime_error(errorMsg("Expected ';' after import", peek()));
         return std::make_unique<ImportStatement>(filename);
     }
-    if (match(TokenType::CLASS)) {
-        auto classDef = parseClass();
+    // Annotations:  @soa struct Particle { ... }
+    if (match(TokenType::AT)) {
+        if (peek().type != TokenType::IDENTIFIER || peek().value != "soa")
+            throw std::runtime_error(errorMsg("Unknown annotation", peek()));
+        advance();
+        if (!match(TokenType::STRUCT))
+            throw std::runtime_error(errorMsg("@soa applies to struct declarations", peek()));
+        auto structDef = parseClass(true);
+        auto cd = static_cast<ClassDef*>(structDef.get());
+        cd->soa = true;
+        g_class_names.insert(cd->name);
+        return structDef;
+    }
+    if (match(TokenType::CLASS) || match(TokenType::STRUCT)) {
+        auto classDef = parseClass(tokens[current - 1].type == TokenType::STRUCT);
         if (auto cd = dynamic_cast<ClassDef*>(classDef.get())) {
             g_class_names.insert(cd->name);
         }
@@ -375,9 +448,9 @@ static std::unique_ptr<Statement> parseStatement() {
             std::move(elseBlock)
         );
     }
+    std::string typeStr;
     if (match(TokenType::INT) || match(TokenType::FLOAT) || match(TokenType::CHAR) || match(TokenType::BOOL) || match(TokenType::STRING_TYPE)) {
         TokenType varType = tokens[current - 1].type;
-        std::string typeStr;
         switch (varType) {
             case TokenType::INT: typeStr = "int"; break;
             case TokenType::FLOAT: typeStr = "float"; break;
@@ -386,6 +459,10 @@ static std::unique_ptr<Statement> parseStatement() {
             case TokenType::STRING_TYPE: typeStr = "string"; break;
             default: typeStr = "int"; break;
         }
+    } else if (atTypeParamDecl()) {
+        typeStr = advance().value;   // T x; inside class Vec<T>
+    }
+    if (!typeStr.empty()) {
         if (peek().type != TokenType::IDENTIFIER)
             throw std::runtime_error(errorMsg("Expected identifier after type", peek()));
         std::string name = advance().value;
@@ -413,8 +490,9 @@ static std::unique_ptr<Statement> parseStatement() {
                     throw std::runtime_error(errorMsg("Expected ']' after array size", peek()));
                 if (!match(TokenType::SEMICOLON))
                     throw std::runtime_error(errorMsg("Expected ';' after array declaration", peek()));
-                // Assignment node for fixed-size array (sizeExpr as value)
-                return std::make_unique<Assignment>(name, std::move(sizeExpr), typeStr);
+                // Fixed-size array: allocate a T[] of sizeExpr elements,
+                // the same form as object and struct arrays
+                return std::make_unique<Assignment>(name, std::move(sizeExpr), typeStr + "[]");
             }
         }
         // Normal variable assignment
@@ -475,9 +553,11 @@ static std::unique_ptr<Statement> parseStatement() {
                         std::string arrTarget = innerArr->arrayName + "[";
                         if (auto num = dynamic_cast<Number*>(innerArr->index.get())) {
                             arrTarget += std::to_string(num->value);
+                        } else if (auto idxVar = dynamic_cast<Variable*>(innerArr->index.get())) {
+                            arrTarget += idxVar->name;
                         } else {
-                            // For now, only support constant index
-                            throw std::runtime_error("Only constant indices supported in assignment target");
+                            // Constant or plain-variable index only
+                            throw std::runtime_error("Only constant or variable indices supported in assignment target");
                         }
                         arrTarget += "]";
                         chain.push_back(arrTarget);
@@ -495,14 +575,8 @@ static std::unique_ptr<Statement> parseStatement() {
                 }
                 return std::make_unique<Assignment>(target, std::move(expr));
             } else if (auto arr = dynamic_cast<ArrayAccess*>(lhs.get())) {
-                // Serialize as arr[idx]
-                std::string target = arr->arrayName + "[";
-                if (auto num = dynamic_cast<Number*>(arr->index.get()))
-                    target += std::to_string(num->value);
-                else
-                    target += "?"; // fallback for non-const index
-                target += "]";
-                return std::make_unique<Assignment>(target, std::move(expr));
+                return std::make_unique<ArrayAssignment>(arr->arrayName, std::move(arr->index),
+                                                         std::move(expr));
             } else {
                 throw std::runtime_error("Unsupported assignment target");
             }
@@ -515,6 +589,7 @@ static std::unique_ptr<Statement> parseStatement() {
         std::string typeName = peek().value;
         if (g_class_names.count(typeName)) {
             advance(); // consume type name
+            if (check(TokenType::LESSTHEN)) typeName = parseTypeArgs(typeName);
             if (peek().type != TokenType::IDENTIFIER)
                 throw std::runtime_error(errorMsg("Expected variable name after class type", peek()));
             std::string varName = advance().value;
@@ -529,6 +604,13 @@ static std::unique_ptr<Statement> parseStatement() {
                     throw std::runtime_error(errorMsg("Expected ';' after object array declaration", peek()));
                 }
             }
+            // Copy-initialisation:  Point q = p;
+            if (match(TokenType::ASSIGN)) {
+                auto init = parseExpression();
+                if (!match(TokenType::SEMICOLON))
+                    throw std::runtime_error(errorMsg("Expected ';' after object declaration", peek()));
+                return std::make_unique<Assignment>(varName, std::move(init), typeName);
+            }
             // ... existing constructor and default instantiation logic ...
             std::vector<std::unique_ptr<Expr>> args;
             if (match(TokenType::LPAREN)) {
@@ -583,6 +665,8 @@ static std::vector<std::pair<std::string, std::string>> parseParameterList() {
             else if (peek().type == TokenType::CHAR)        { advance(); typeStr = "char"; }
             else if (peek().type == TokenType::BOOL)        { advance(); typeStr = "bool"; }
             else if (peek().type == TokenType::STRING_TYPE) { advance(); typeStr = "string"; }
+            else if (atTypeParamDecl())                     { typeStr = advance().value; }
+            else if (atClassTypeDecl())                     { typeStr = parseClassType(); }
             if (peek().type != TokenType::IDENTIFIER)
                 throw std::runtime_error(errorMsg("Expected parameter name", peek()));
             params.push_back({typeStr, advance().value});
@@ -615,15 +699,30 @@ static std::unique_ptr<Statement> parseFunction() {
     );
 }
 
-static std::unique_ptr<Statement> parseClass() {
+static std::unique_ptr<Statement> parseClass(bool isStruct) {
     if (peek().type != TokenType::IDENTIFIER)
         throw std::runtime_error(errorMsg("Expected class name after 'class'", peek()));
     std::string className = advance().value;
+    std::vector<std::string> typeParams;
+    if (match(TokenType::LESSTHEN)) {
+        do {
+            if (peek().type != TokenType::IDENTIFIER)
+                throw std::runtime_error(errorMsg("Expected type parameter name", peek()));
+            typeParams.push_back(advance().value);
+        } while (match(TokenType::COMMA));
+        if (!match(TokenType::GREATERTHEN))
+            throw std::runtime_error(errorMsg("Expected '>' after type parameters", peek()));
+    }
+    classTypeParams.clear();
+    classTypeParams.insert(typeParams.begin(), typeParams.end());
     std::string baseClass;
     if (match(TokenType::COLON)) {
         if (peek().type != TokenType::IDENTIFIER)
             throw std::runtime_error(errorMsg("Expected base class name after ':'", peek()));
         baseClass = advance().value;
+        if (check(TokenType::LESSTHEN)) baseClass = parseTypeArgs(baseClass);
+        if (isStruct)
+            throw std::runtime_error(errorMsg("Structs cannot inherit", peek()));
     }
     if (!match(TokenType::LBRACE))
         throw std::runtime_error(errorMsg("Expected '{' after class name", peek()));
@@ -631,9 +730,9 @@ static std::unique_ptr<Statement> parseClass() {
     std::vector<std::unique_ptr<FunctionDef>> methods;
     while (!check(TokenType::RBRACE)) {
         // Parse field: <type> <name>;
+        std::string typeStr;
         if (match(TokenType::INT) || match(TokenType::FLOAT) || match(TokenType::CHAR) || match(TokenType::BOOL) || match(TokenType::STRING_TYPE)) {
             TokenType typeTok = tokens[current - 1].type;
-            std::string typeStr;
             switch (typeTok) {
                 case TokenType::INT: typeStr = "int"; break;
                 case TokenType::FLOAT: typeStr = "float"; break;
@@ -642,6 +741,12 @@ static std::unique_ptr<Statement> parseClass() {
                 case TokenType::STRING_TYPE: typeStr = "string"; break;
                 default: typeStr = "int"; break;
             }
+        } else if (atTypeParamDecl()) {
+            typeStr = advance().value;
+        } else if (atClassTypeDecl()) {
+            typeStr = parseClassType();   // struct fields are stored inline
+        }
+        if (!typeStr.empty()) {
             if (peek().type != TokenType::IDENTIFIER)
                 throw std::runtime_error(errorMsg("Expected field name after type in class", peek()));
             std::string fieldName = advance().value;
@@ -654,6 +759,8 @@ static std::unique_ptr<Statement> parseClass() {
             if (!match(TokenType::SEMICOLON))
                 throw std::runtime_error(errorMsg("Expected ';' after field declaration in class", peek()));
             fields.emplace_back(typeStr, fieldName);
+        } else if (isStruct && check(TokenType::COMEANDDO)) {
+            throw std::runtime_error(errorMsg("Structs hold fields only; methods belong in a class", peek()));
         } else if (match(TokenType::COMEANDDO)) {
             // Parse method (reuse function parser)
             if (peek().type != TokenType::IDENTIFIER)
@@ -677,5 +784,9 @@ static std::unique_ptr<Statement> parseClass() {
     }
     if (!match(TokenType::RBRACE))
         throw std::runtime_error(errorMsg("Expected '}' after class body", peek()));
-    return std::make_unique<ClassDef>(className, baseClass, std::move(fields), std::move(methods));
+    classTypeParams.clear();
+    auto cd = std::make_unique<ClassDef>(className, baseClass, std::move(fields), std::move(methods));
+    cd->typeParams = std::move(typeParams);
+    cd->isStruct   = isStruct;
+    return cd;
 }
@@ -1,4 +1,6 @@
 #include "semantic.hpp"
+#include "generics.hpp"
+#include "structs.hpp"
 #include <iostream>
 #include <unordered_set>
 
@@ -714,6 +716,9 @@ std::string SemanticAnalyzer::analyzeExpr(const Expr* expr) {
 // ===========================================================================
 
 void semanticAnalyze(std::vector<std::unique_ptr<Statement>>& stmts) {
+    instantiateGenerics(stmts);   // class Vec<T> -> one concrete class per use
+    lowerStructs(stmts);          // struct values -> scalars and flat arrays
+
     SemanticAnalyzer analyzer;
     auto errors = analyzer.analyze(stmts);
 
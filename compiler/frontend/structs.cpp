@@ -0,0 +1,643 @@
+#include "structs.hpp"
+#include "generics.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+using ExprPtr = std::unique_ptr<Expr>;
+using StmtPtr = std::unique_ptr<Statement>;
+using Body    = std::vector<StmtPtr>;
+
+bool isArrayType(const std::string& t) {
+    return t.size() > 2 && t.compare(t.size() - 2, 2, "[]") == 0;
+}
+
+// One scalar of a flattened struct: its type and field path ("min$x").
+struct Leaf {
+    std::string type;
+    std::string path;
+};
+
+// Where a (possibly struct-typed) value lives after lowering.
+struct Place {
+    enum Kind { Local, Field, Elem, Column } kind = Local;
+    std::string name;              // Local: scalar name prefix; Elem/Column: array name
+    const Expr* object = nullptr;  // Field: the object expression
+    std::string path;              // Field/Column: flattened field name prefix
+    const Expr* index  = nullptr;  // Elem/Column: element index
+    int         stride = 1;        // Elem: slots per element
+    int         offset = 0;        // Elem: slot of this value within the element
+    std::string type;              // struct name or primitive leaf type
+};
+
+class StructLowering {
+public:
+    void run(Body& program) {
+        for (auto& s : program) {
+            auto cd = dynamic_cast<ClassDef*>(s.get());
+            if (!cd) continue;
+            if (cd->isStruct) structDefs_[cd->name] = cd;
+            else              classDefs_[cd->name]  = {cd->baseClass, cd->fields};
+        }
+        if (structDefs_.empty()) return;
+        for (auto& [name, cd] : structDefs_) (void)cd, layout(name);
+
+        scopes_.emplace_back();
+        Body out;
+        for (auto& s : program) {
+            auto cd = dynamic_cast<ClassDef*>(s.get());
+            if (cd && cd->isStruct) continue;       // fully inlined at every use
+            lowerStmt(std::move(s), out);
+        }
+        program = std::move(out);
+    }
+
+private:
+    std::unordered_map<std::string, const ClassDef*>  structDefs_;
+    struct ClassInfo {
+        std::string                                      base;
+        std::vector<std::pair<std::string, std::string>> fields;   // as declared
+    };
+    std::unordered_map<std::string, ClassInfo>         classDefs_;
+    std::unordered_map<std::string, std::vector<Leaf>> layouts_;
+    std::unordered_set<std::string>                    inProgress_;
+
+    // Declared type of every variable in scope, innermost scope last.
+    std::vector<std::unordered_map<std::string, std::string>> scopes_;
+    std::string curClass_;
+
+    // Index temporaries that pinned Places point at (see pinIndex).
+    std::vector<ExprPtr> pinned_;
+
+    [[noreturn]] static void fail(const std::string& msg) {
+        throw std::runtime_error(msg);
+    }
+
+    bool isStruct(const std::string& t) const { return structDefs_.count(t) > 0; }
+    bool isSoA(const std::string& t) const {
+        auto it = structDefs_.find(t);
+        return it != structDefs_.end() && it->second->soa;
+    }
+
+    // Column array holding field `path` of every element of SoA array `arr`.
+    static std::string column(const std::string& arr, const std::string& path) {
+        return arr + "$" + path;
+    }
+
+    // ── Layout ──────────────────────────────────────────────────────────────
+
+    const std::vector<Leaf>& layout(const std::string& name) {
+        auto it = layouts_.find(name);
+        if (it != layouts_.end()) return it->second;
+        if (!inProgress_.insert(name).second)
+            fail("Struct '" + name + "' contains itself");
+        std::vector<Leaf> leaves;
+        for (auto& [ty, fname] : structDefs_.at(name)->fields) {
+            if (isArrayType(ty))
+                fail("Struct '" + name + "': array field '" + fname + "' is not supported");
+            if (isStruct(ty)) {
+                for (auto& l : layout(ty)) leaves.push_back({l.type, fname + "$" + l.path});
+            } else if (classDefs_.count(ty)) {
+                fail("Struct '" + name + "': field '" + fname + "' cannot hold an object");
+            } else {
+                leaves.push_back({ty, fname});
+            }
+        }
+        if (leaves.empty()) fail("Struct '" + name + "' has no fields");
+        inProgress_.erase(name);
+        return layouts_[name] = std::move(leaves);
+    }
+
+    // Type of field `member` of struct `s` and the slot it starts at.
+    std::string structField(const std::string& s, const std::string& member, int& offset) {
+        offset = 0;
+        for (auto& [ty, fname] : structDefs_.at(s)->fields) {
+            if (fname == member) return ty;
+            offset += isStruct(ty) ? (int)layout(ty).size() : 1;
+        }
+        fail("Struct '" + s + "' has no field '" + member + "'");
+    }
+
+    // Declared type of field `member` in class `cls` or its bases ("" if none).
+    std::string classField(const std::string& cls, const std::string& member) const {
+        for (std::string c = cls; !c.empty();) {
+            auto it = classDefs_.find(c);
+            if (it == classDefs_.end()) break;
+            for (auto& [ty, fname] : it->second.fields)
+                if (fname == member) return ty;
+            c = it->second.base;
+        }
+        return "";
+    }
+
+    // Declared element type of the flat array for struct `s`.  Every slot
+    // shares the array's element type, so a struct mixing field types
+    // (string name; int age;) cannot be interleaved; @soa gives each field
+    // its own typed column instead.
+    std::string flatElemType(const std::string& s) {
+        const auto& leaves = layout(s);
+        for (auto& l : leaves)
+            if (l.type != leaves[0].type)
+                fail("Struct '" + s + "' mixes field types ('" + leaves[0].type + "' and '" +
+                     l.type + "'); declare it @soa to make arrays of it");
+        return leaves[0].type;
+    }
+
+    // ── Scopes ──────────────────────────────────────────────────────────────
+
+    void declare(const std::string& name, const std::string& type) {
+        scopes_.back()[name] = type;
+    }
+
+    std::string typeOf(const std::string& name) const {
+        for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
+            auto f = it->find(name);
+            if (f != it->end()) return f->second;
+        }
+        return "";
+    }
+
+    // ── Places ──────────────────────────────────────────────────────────────
+
+    // Class of an object-valued expression, when it is known statically.
+    std::string classOf(const Expr* e) const {
+        if (auto v = dynamic_cast<const Variable*>(e)) {
+            if (v->name == "this") return curClass_;
+            std::string t = typeOf(v->name);
+            return classDefs_.count(t) ? t : "";
+        }
+        if (auto a = dynamic_cast<const ArrayAccess*>(e)) {
+            std::string t = typeOf(a->arrayName);
+            if (!isArrayType(t)) return "";
+            t.resize(t.size() - 2);
+            return classDefs_.count(t) ? t : "";
+        }
+        return "";
+    }
+
+    // Resolves e to a place holding a struct or one of its fields.
+    bool resolve(const Expr* e, Place& p) {
+        if (auto v = dynamic_cast<const Variable*>(e)) {
+            std::string t = typeOf(v->name);
+            if (!isStruct(t)) return false;
+            p = Place{};
+            p.kind = Place::Local;
+            p.name = v->name;
+            p.type = t;
+            return true;
+        }
+        if (auto a = dynamic_cast<const ArrayAccess*>(e)) {
+            std::string t = typeOf(a->arrayName);
+            if (!isArrayType(t) || !isStruct(t.substr(0, t.size() - 2))) return false;
+            p = Place{};
+            p.kind   = Place::Elem;
+            p.name   = a->arrayName;
+            p.index  = a->index.get();
+            p.type   = t.substr(0, t.size() - 2);
+            p.stride = (int)layout(p.type).size();
+            if (isSoA(p.type)) p.kind = Place::Column;
+            return true;
+        }
+        auto m = dynamic_cast<const ObjectMemberAccess*>(e);
+        if (!m) return false;
+        if (resolve(m->object.get(), p)) {
+            if (!isStruct(p.type)) return false;
+            int off = 0;
+            std::string ft = structField(p.type, m->member, off);
+            if (p.kind == Place::Local)       p.name += "$" + m->member;
+            else if (p.kind == Place::Field)  p.path += "$" + m->member;
+            else if (p.kind == Place::Column) p.path += (p.path.empty() ? "" : "$") + m->member;
+            else                              p.offset += off;
+            p.type = ft;
+            return true;
+        }
+        std::string cls = classOf(m->object.get());
+        if (cls.empty()) return false;
+        std::string ft = classField(cls, m->member);
+        if (!isStruct(ft)) return false;
+        p = Place{};
+        p.kind   = Place::Field;
+        p.object = m->object.get();
+        p.path   = m->member;
+        p.type   = ft;
+        return true;
+    }
+
+    // The place of one leaf (path relative to p's struct) inside p.
+    Place leafOf(const Place& p, const Leaf& leaf, int slot) const {
+        Place q = p;
+        q.type = leaf.type;
+        if (q.kind == Place::Local)       q.name += "$" + leaf.path;
+        else if (q.kind == Place::Field)  q.path += "$" + leaf.path;
+        else if (q.kind == Place::Column) q.path += (q.path.empty() ? "" : "$") + leaf.path;
+        else                              q.offset += slot;
+        return q;
+    }
+
+    ExprPtr slotIndex(const Place& p) {
+        if (auto n = dynamic_cast<const Number*>(p.index))
+            return std::make_unique<Number>(n->value * p.stride + p.offset);
+        ExprPtr idx = lowered(p.index);
+        if (p.stride != 1)
+            idx = std::make_unique<BinaryExpr>(std::move(idx), TokenType::MULTIPLICATION,
+                                               std::make_unique<Number>(p.stride));
+        if (p.offset != 0)
+            idx = std::make_unique<BinaryExpr>(std::move(idx), TokenType::PLUS,
+                                               std::make_unique<Number>(p.offset));
+        return idx;
+    }
+
+    // True when evaluating e more than once cannot be observed.
+    static bool pure(const Expr* e) {
+        if (dynamic_cast<const Number*>(e) || dynamic_cast<const FloatLiteral*>(e) ||
+            dynamic_cast<const BoolLiteral*>(e) || dynamic_cast<const CharLiteral*>(e) ||
+            dynamic_cast<const StringLiteral*>(e) || dynamic_cast<const Variable*>(e))
+            return true;
+        if (auto b = dynamic_cast<const BinaryExpr*>(e)) return pure(b->left.get()) && pure(b->right.get());
+        if (auto u = dynamic_cast<const UnaryExpr*>(e))  return pure(u->operand.get());
+        if (auto c = dynamic_cast<const CastExpr*>(e))   return pure(c->operand.get());
+        if (auto a = dynamic_cast<const ArrayAccess*>(e)) return pure(a->index.get());
+        return false;
+    }
+
+    // Evaluates a non-trivial element index once into an int temporary, so
+    // a copy touching every field runs it once (ps[f()] = q calls f once).
+    void pinIndex(Place& p, Body& out) {
+        if ((p.kind != Place::Elem && p.kind != Place::Column) ||
+            dynamic_cast<const Number*>(p.index) || dynamic_cast<const Variable*>(p.index))
+            return;
+        std::string name = "idx$" + std::to_string(pinned_.size());
+        out.push_back(std::make_unique<Assignment>(name, lowered(p.index), "int"));
+        declare(name, "int");
+        pinned_.push_back(std::make_unique<Variable>(name));
+        p.index = pinned_.back().get();
+    }
+
+    // Read of a scalar place.
+    ExprPtr load(const Place& p) {
+        switch (p.kind) {
+            case Place::Local: return std::make_unique<Variable>(p.name);
+            case Place::Field: return std::make_unique<ObjectMemberAccess>(lowered(p.object), p.path);
+            case Place::Elem:  return std::make_unique<ArrayAccess>(p.name, slotIndex(p));
+            case Place::Column:
+                return std::make_unique<ArrayAccess>(column(p.name, p.path), lowered(p.index));
+        }
+        return nullptr;
+    }
+
+    // Write of a scalar place; declType makes a Local write a declaration.
+    StmtPtr store(const Place& p, ExprPtr value, const std::string& declType = "") {
+        if (p.kind == Place::Local)
+            return std::make_unique<Assignment>(p.name, std::move(value), declType);
+        if (p.kind == Place::Elem)
+            return std::make_unique<ArrayAssignment>(p.name, slotIndex(p), std::move(value));
+        if (p.kind == Place::Column)
+            return std::make_unique<ArrayAssignment>(column(p.name, p.path), lowered(p.index),
+                                                     std::move(value));
+        return std::make_unique<Assignment>(targetName(p.object) + "." + p.path, std::move(value));
+    }
+
+    // "obj", "this" or "arr[i]" — the spelling field-assignment targets use.
+    static std::string targetName(const Expr* obj) {
+        if (auto v = dynamic_cast<const Variable*>(obj)) return v->name;
+        if (auto a = dynamic_cast<const ArrayAccess*>(obj)) {
+            if (auto n = dynamic_cast<const Number*>(a->index.get()))
+                return a->arrayName + "[" + std::to_string(n->value) + "]";
+            if (auto v = dynamic_cast<const Variable*>(a->index.get()))
+                return a->arrayName + "[" + v->name + "]";
+        }
+        fail("Unsupported struct field assignment target");
+    }
+
+    // Scalar reads of every field of the struct at p, in layout order.
+    std::vector<ExprPtr> loadAll(const Place& p) {
+        std::vector<ExprPtr> out;
+        const auto& leaves = layout(p.type);
+        for (size_t i = 0; i < leaves.size(); ++i) out.push_back(load(leafOf(p, leaves[i], (int)i)));
+        return out;
+    }
+
+    // Field-by-field copy of struct-valued src into dst.
+    void copy(Place dst, const Expr* src, Body& out, bool declaring = false) {
+        Place from;
+        if (!resolve(src, from) || from.type != dst.type)
+            fail("Expected a '" + dst.type + "' value");
+        pinIndex(dst, out);
+        pinIndex(from, out);
+        const auto& leaves = layout(dst.type);
+        for (size_t i = 0; i < leaves.size(); ++i)
+            out.push_back(store(leafOf(dst, leaves[i], (int)i), load(leafOf(from, leaves[i], (int)i)),
+                                declaring ? leaves[i].type : ""));
+    }
+
+    // ── Expressions ─────────────────────────────────────────────────────────
+
+    ExprPtr lowered(const Expr* e) {
+        ExprPtr c = cloneExpr(e);
+        lowerExpr(c);
+        return c;
+    }
+
+    // Expands struct-valued arguments into their fields (pass by value).
+    void lowerArgs(std::vector<ExprPtr>& args) {
+        std::vector<ExprPtr> out;
+        for (auto& a : args) {
+            Place p;
+            if (resolve(a.get(), p) && isStruct(p.type)) {
+                if (p.index && !pure(p.index))
+                    fail("Struct argument '" + p.type + "' is indexed by an expression with "
+                         "side effects; copy the element to a local first");
+                for (auto& f : loadAll(p)) out.push_back(std::move(f));
+            } else {
+                lowerExpr(a);
+                out.push_back(std::move(a));
+            }
+        }
+        args = std::move(out);
+    }
+
+    void lowerExpr(ExprPtr& e) {
+        if (!e) return;
+        Place p;
+        if (resolve(e.get(), p)) {
+            if (isStruct(p.type))
+                fail("Struct '" + p.type + "' used where a single value is expected");
+            e = load(p);
+            return;
+        }
+        if (auto v = dynamic_cast<Variable*>(e.get())) {
+            std::string t = typeOf(v->name);
+            if (isArrayType(t) && isSoA(t.substr(0, t.size() - 2)))
+                fail("@soa array '" + v->name + "' can only be indexed");
+        }
+        if (auto b = dynamic_cast<BinaryExpr*>(e.get())) {
+            lowerExpr(b->left);
+            lowerExpr(b->right);
+        } else if (auto u = dynamic_cast<UnaryExpr*>(e.get())) {
+            lowerExpr(u->operand);
+        } else if (auto c = dynamic_cast<CallExpr*>(e.get())) {
+            lowerArgs(c->arguments);
+        } else if (auto a = dynamic_cast<ArrayAccess*>(e.get())) {
+            lowerExpr(a->index);
+        } else if (auto al = dynamic_cast<ArrayLiteral*>(e.get())) {
+            for (auto& el : al->elements) lowerExpr(el);
+        } else if (auto m = dynamic_cast<ObjectMemberAccess*>(e.get())) {
+            lowerExpr(m->object);
+        } else if (auto mc = dynamic_cast<ObjectMethodCall*>(e.get())) {
+            Place self;
+            if (resolve(mc->object.get(), self) && isStruct(self.type))
+                fail("Struct '" + self.type + "' has no methods");
+            lowerExpr(mc->object);
+            lowerArgs(mc->arguments);
+        } else if (auto cast = dynamic_cast<CastExpr*>(e.get())) {
+            lowerExpr(cast->operand);
+        }
+    }
+
+    // ── Statements ──────────────────────────────────────────────────────────
+
+    // Rebuilds an assignment target ("p.pos.x", "arr[i].x", "this.pos")
+    // as an expression so it can be resolved like any other access.
+    static ExprPtr targetExpr(const std::string& name) {
+        size_t dot = name.find('.');
+        std::string head = name.substr(0, dot);
+        ExprPtr e;
+        size_t lb = head.find('[');
+        if (lb == std::string::npos) {
+            e = std::make_unique<Variable>(head);
+        } else {
+            std::string idx = head.substr(lb + 1, head.size() - lb - 2);
+            ExprPtr ie;
+            if (!idx.empty() && (isdigit((unsigned char)idx[0]) || idx[0] == '-'))
+                ie = std::make_unique<Number>(std::stoi(idx));
+            else
+                ie = std::make_unique<Variable>(idx);
+            e = std::make_unique<ArrayAccess>(head.substr(0, lb), std::move(ie));
+        }
+        while (dot != std::string::npos) {
+            size_t next = name.find('.', dot + 1);
+            e = std::make_unique<ObjectMemberAccess>(std::move(e),
+                    name.substr(dot + 1, next == std::string::npos ? std::string::npos : next - dot - 1));
+            dot = next;
+        }
+        return e;
+    }
+
+    Body lowerBody(Body& body) {
+        Body out;
+        for (auto& s : body) lowerStmt(std::move(s), out);
+        return out;
+    }
+
+    Body lowerScoped(Body& body) {
+        scopes_.emplace_back();
+        Body out = lowerBody(body);
+        scopes_.pop_back();
+        return out;
+    }
+
+    // for-loop header clauses must stay a single statement.
+    StmtPtr lowerSingle(StmtPtr s) {
+        if (!s) return s;
+        Body out;
+        lowerStmt(std::move(s), out);
+        if (out.size() != 1) fail("Struct copies are not allowed in a for-loop header");
+        return std::move(out[0]);
+    }
+
+    // Expands struct params to one param per field; declares the rest.
+    void lowerParams(FunctionDef* fn) {
+        std::vector<std::pair<std::string, std::string>> params;
+        for (auto& [ty, name] : fn->params) {
+            if (isStruct(ty)) {
+                for (auto& l : layout(ty)) params.push_back({l.type, name + "$" + l.path});
+            } else {
+                params.push_back({ty, name});
+            }
+            declare(name, ty);
+        }
+        fn->params = std::move(params);
+    }
+
+    // fields: the enclosing class's fields, which method bodies may name bare.
+    void lowerFunction(FunctionDef* fn,
+                       const std::vector<std::pair<std::string, std::string>>& fields = {}) {
+        auto saved = std::move(scopes_);     // functions do not see outer variables
+        scopes_.assign(1, {});
+        for (auto& [ty, name] : fields) declare(name, ty);
+        lowerParams(fn);
+        fn->body = lowerBody(fn->body);
+        scopes_ = std::move(saved);
+    }
+
+    void lowerClass(ClassDef* cd) {
+        std::vector<std::pair<std::string, std::string>> fields;
+        for (auto& [ty, name] : cd->fields) {
+            if (isArrayType(ty) && isStruct(ty.substr(0, ty.size() - 2)))
+                fail("Class '" + cd->name + "': struct array field '" + name +
+                     "' is not supported; use a local array");
+            if (isStruct(ty)) {
+                for (auto& l : layout(ty)) fields.push_back({l.type, name + "$" + l.path});
+            } else {
+                fields.push_back({ty, name});
+            }
+        }
+        std::vector<std::pair<std::string, std::string>> visible;
+        for (std::string c = cd->name; classDefs_.count(c); c = classDefs_[c].base)
+            for (auto& f : classDefs_[c].fields) visible.push_back(f);
+        std::string savedClass = curClass_;
+        curClass_ = cd->name;
+        for (auto& m : cd->methods) lowerFunction(m.get(), visible);
+        curClass_ = savedClass;
+        cd->fields = std::move(fields);
+    }
+
+    void lowerAssignment(StmtPtr s, Assignment* a, Body& out) {
+        const std::string& ty = a->type;
+        std::string elem = isArrayType(ty) ? ty.substr(0, ty.size() - 2) : "";
+
+        // @soa Particle ps[n];  ->  one n-element array per field
+        if (!elem.empty() && isSoA(elem)) {
+            ExprPtr size = std::move(a->value);
+            if (size) lowerExpr(size);
+            // Evaluate the size once when it is more than a literal or a name.
+            if (size && !dynamic_cast<Number*>(size.get()) && !dynamic_cast<Variable*>(size.get())) {
+                out.push_back(std::make_unique<Assignment>(a->name + "$n", std::move(size), "int"));
+                size = std::make_unique<Variable>(a->name + "$n");
+            }
+            for (auto& l : layout(elem))
+                out.push_back(std::make_unique<Assignment>(column(a->name, l.path), cloneExpr(size.get()),
+                                                           l.type + "[]"));
+            declare(a->name, ty);
+            return;
+        }
+
+        // Point pts[n];  ->  one flat array of n * fields slots
+        if (!elem.empty() && isStruct(elem)) {
+            ExprPtr size = std::move(a->value);
+            int stride = (int)layout(elem).size();
+            if (size) {
+                lowerExpr(size);
+                if (stride != 1)
+                    size = std::make_unique<BinaryExpr>(std::move(size), TokenType::MULTIPLICATION,
+                                                        std::make_unique<Number>(stride));
+            }
+            declare(a->name, ty);
+            out.push_back(std::make_unique<Assignment>(a->name, std::move(size),
+                                                       flatElemType(elem) + "[]"));
+            return;
+        }
+
+        // Point p;  /  Point q = p;
+        if (isStruct(ty)) {
+            Place dst;
+            dst.name = a->name;
+            dst.type = ty;
+            if (a->value) {
+                copy(dst, a->value.get(), out, true);
+            } else {
+                for (auto& l : layout(ty))
+                    out.push_back(std::make_unique<Assignment>(a->name + "$" + l.path, nullptr, l.type));
+            }
+            declare(a->name, ty);
+            return;
+        }
+
+        // p = q;  p.pos = q;  pts[i].x = v;  this.pos.x = v;
+        if (ty.empty()) {
+            ExprPtr target = targetExpr(a->name);
+            Place dst;
+            if (resolve(target.get(), dst)) {
+                if (isStruct(dst.type)) {
+                    copy(dst, a->value.get(), out);
+                } else {
+                    lowerExpr(a->value);
+                    out.push_back(store(dst, std::move(a->value)));
+                }
+                return;
+            }
+        }
+
+        lowerExpr(a->value);
+        if (!ty.empty()) declare(a->name, ty);
+        out.push_back(std::move(s));
+    }
+
+    void lowerStmt(StmtPtr s, Body& out) {
+        Statement* st = s.get();
+        if (auto a = dynamic_cast<Assignment*>(st)) {
+            lowerAssignment(std::move(s), a, out);
+            return;
+        }
+        if (auto oi = dynamic_cast<ObjectInstantiation*>(st)) {
+            lowerArgs(oi->arguments);
+            if (isStruct(oi->className)) {
+                // Point p(1.0, 2.0);  ->  one declaration per field, in order
+                const auto& leaves = layout(oi->className);
+                if (oi->arguments.size() != leaves.size())
+                    fail("Struct '" + oi->className + "' has " + std::to_string(leaves.size()) +
+                         " field(s), got " + std::to_string(oi->arguments.size()) + " value(s)");
+                for (size_t i = 0; i < leaves.size(); ++i)
+                    out.push_back(std::make_unique<Assignment>(oi->varName + "$" + leaves[i].path,
+                                                               std::move(oi->arguments[i]),
+                                                               leaves[i].type));
+            } else {
+                out.push_back(std::move(s));
+            }
+            declare(oi->varName, oi->className);
+            return;
+        }
+        if (auto aa = dynamic_cast<ArrayAssignment*>(st)) {
+            ArrayAccess elem(aa->arrayName, std::move(aa->index));
+            Place dst;
+            if (resolve(&elem, dst)) {          // pts[i] = p;
+                copy(dst, aa->value.get(), out);
+                return;
+            }
+            aa->index = std::move(elem.index);
+            lowerExpr(aa->index);
+            lowerExpr(aa->value);
+            out.push_back(std::move(s));
+            return;
+        }
+        if (auto p = dynamic_cast<Print*>(st)) {
+            lowerExpr(p->value);
+        } else if (auto r = dynamic_cast<Return*>(st)) {
+            Place rp;
+            if (r->value && resolve(r->value.get(), rp) && isStruct(rp.type))
+                fail("Functions cannot return struct '" + rp.type + "'");
+            lowerExpr(r->value);
+        } else if (auto es = dynamic_cast<ExprStatement*>(st)) {
+            lowerExpr(es->expr);
+        } else if (auto fn = dynamic_cast<FunctionDef*>(st)) {
+            lowerFunction(fn);
+        } else if (auto cd = dynamic_cast<ClassDef*>(st)) {
+            lowerClass(cd);
+        } else if (auto is = dynamic_cast<IfStatement*>(st)) {
+            lowerExpr(is->condition);
+            is->thenBranch = lowerScoped(is->thenBranch);
+            is->elseBranch = lowerScoped(is->elseBranch);
+        } else if (auto ws = dynamic_cast<WhileStatement*>(st)) {
+            lowerExpr(ws->condition);
+            ws->body = lowerScoped(ws->body);
+        } else if (auto fs = dynamic_cast<ForStatement*>(st)) {
+            scopes_.emplace_back();
+            fs->initializer = lowerSingle(std::move(fs->initializer));
+            lowerExpr(fs->condition);
+            fs->body      = lowerScoped(fs->body);
+            fs->increment = lowerSingle(std::move(fs->increment));
+            scopes_.pop_back();
+        }
+        out.push_back(std::move(s));
+    }
+};
+
+} // namespace
+
+void lowerStructs(std::vector<std::unique_ptr<Statement>>& program) {
+    StructLowering().run(program);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "ast.hpp"
+#include <memory>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Struct lowering — value types without a heap object per instance.
+//
+// `struct Point { float x; float y; }` declares a value type.  This pass
+// rewrites the AST so that no Point object ever exists at run time:
+//   • a local or parameter `Point p` becomes the scalars p$x, p$y
+//     (parameters are passed field by field, i.e. by value);
+//   • a class field `Point pos` becomes the fields pos$x, pos$y;
+//   • an array `Point pts[n]` becomes one flat array of n * 2 slots with
+//     the fields of each element stored next to each other, so pts[i].y is
+//     a load of slot i * 2 + 1 — one allocation, nothing for the GC to trace
+//     per element;
+//   • `q = p`, `pts[i] = p`, `Point q = pts[i]` and struct arguments copy
+//     field by field.
+// Structs nest (struct Rect { Point min; Point max; }).  They have no
+// methods and cannot be returned from a function or printed as a whole.
+//
+// `@soa struct Particle { ... }` keeps the same scalar form for locals,
+// parameters and fields, but stores arrays column-wise: `Particle ps[n]`
+// becomes one n-element array per field (ps$x, ps$y, ...), so ps[i].x is
+// ps$x[i] and a loop over one field walks a single packed array.
+//
+// Runs after instantiateGenerics, so `struct Pair<A, B>` works too.
+// Throws std::runtime_error for a misuse of a struct value.
+// ---------------------------------------------------------------------------
+
+void lowerStructs(std::vector<std::unique_ptr<Statement>>& program);
@@ -1,5 +1,6 @@
 #include "cfg.hpp"
 #include <algorithm>
+#include <deque>
 #include <queue>
 #include <set>
 #include <stack>
@@ -176,9 +177,9 @@ void CFG::dump() const {
         for (int s : bb.succs) std::cout << s << ",";
         std::cout << "}\n";
         std::cout << "  liveIn: ";
-        for (const auto& v : bb.liveIn) std::cout << v << " ";
+        bb.liveIn.forEach([&](int v) { std::cout << vars[v] << " "; });
         std::cout << "\n  liveOut: ";
-        for (const auto& v : bb.liveOut) std::cout << v << " ";
+        bb.liveOut.forEach([&](int v) { std::cout << vars[v] << " "; });
         std::cout << "\n";
         for (const PhiNode& phi : bb.phis) {
             std::cout << "  PHI " << phi.dest << " = phi(";
@@ -206,22 +207,29 @@ void CFG::dump() const {
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// CFG::reversePostOrder — DFS from entry, return blocks in RPO.
+// CFG::reversePostOrder — iterative DFS from entry, return blocks in RPO.
 // ─────────────────────────────────────────────────────────────────────────────
 std::vector<int> CFG::reversePostOrder() const {
     int n = blocks.size();
     std::vector<bool> visited(n, false);
     std::vector<int> post;
     post.reserve(n);
-
-    std::function<void(int)> dfs = [&](int b) {
-        visited[b] = true;
-        for (int s : blocks[b].succs)
-            if (!visited[s]) dfs(s);
-        post.push_back(b);
-    };
-
-    if (n > 0) dfs(0);
+    if (n == 0) return post;
+
+    // (block, index of the next successor to visit)
+    std::vector<std::pair<int,size_t>> stk;
+    stk.push_back({0, 0});
+    visited[0] = true;
+    while (!stk.empty()) {
+        auto& [b, next] = stk.back();
+        if (next < blocks[b].succs.size()) {
+            int s = blocks[b].succs[next++];
+            if (!visited[s]) { visited[s] = true; stk.push_back({s, 0}); }
+        } else {
+            post.push_back(b);
+            stk.pop_back();
+        }
+    }
     std::reverse(post.begin(), post.end());
     return post;
 }
@@ -229,6 +237,9 @@ std::vector<int> CFG::reversePostOrder() const {
 // ─────────────────────────────────────────────────────────────────────────────
 // CFG::computeDominators — Cooper, Harvey, Kennedy (2001)
 // "A Simple, Fast Dominance Algorithm"
+//
+// Works entirely on RPO numbers: predecessors are translated once into RPO
+// indices (unreachable ones dropped), so intersect() compares plain ints.
 // ─────────────────────────────────────────────────────────────────────────────
 void CFG::computeDominators() {
     int n = blocks.size();
@@ -238,17 +249,26 @@ void CFG::computeDominators() {
     for (BasicBlock& bb : blocks) { bb.idom = -1; bb.domChildren.clear(); }
 
     std::vector<int> rpo = reversePostOrder();
+    int m = rpo.size();
     std::vector<int> rpoNum(n, -1);
-    for (int i = 0; i < (int)rpo.size(); ++i) rpoNum[rpo[i]] = i;
+    for (int i = 0; i < m; ++i) rpoNum[rpo[i]] = i;
+
+    // Predecessors of each reachable block as RPO numbers (CSR layout)
+    std::vector<int> predStart(m + 1, 0), predRpo;
+    for (int i = 0; i < m; ++i) {
+        for (int p : blocks[rpo[i]].preds)
+            if (rpoNum[p] >= 0) predRpo.push_back(rpoNum[p]);
+        predStart[i + 1] = predRpo.size();
+    }
 
-    std::vector<int> idom(n, -1);
-    idom[rpo[0]] = rpo[0]; // entry dominates itself
+    std::vector<int> idom(m, -1);   // indexed and valued by RPO number
+    idom[0] = 0;                    // entry dominates itself
 
     // Walk up the dominator tree to the LCA of a and b
     auto intersect = [&](int a, int b) -> int {
         while (a != b) {
-            while (rpoNum[a] > rpoNum[b]) a = idom[a];
-            while (rpoNum[b] > rpoNum[a]) b = idom[b];
+            while (a > b) a = idom[a];
+            while (b > a) b = idom[b];
         }
         return a;
     };
@@ -257,10 +277,10 @@ void CFG::computeDominators() {
     while (changed) {
         changed = false;
         // Process in RPO, skip entry (index 0)
-        for (int i = 1; i < (int)rpo.size(); ++i) {
-            int b = rpo[i];
+        for (int b = 1; b < m; ++b) {
             int new_idom = -1;
-            for (int p : blocks[b].preds) {
+            for (int k = predStart[b]; k < predStart[b + 1]; ++k) {
+                int p = predRpo[k];
                 if (idom[p] == -1) continue; // predecessor not yet processed
                 new_idom = (new_idom == -1) ? p : intersect(new_idom, p);
             }
@@ -272,28 +292,32 @@ void CFG::computeDominators() {
     }
 
     // Store results: entry has no immediate dominator
-    blocks[rpo[0]].idom = -1;
-    for (int i = 1; i < (int)rpo.size(); ++i) {
+    for (int i = 1; i < m; ++i) {
         int b = rpo[i];
-        blocks[b].idom = idom[b];
-        if (idom[b] >= 0) blocks[idom[b]].domChildren.push_back(b);
+        if (idom[i] < 0) continue;
+        blocks[b].idom = rpo[idom[i]];
+        blocks[blocks[b].idom].domChildren.push_back(b);
     }
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// CFG::computeDomFrontiers — Cytron et al.
+// CFG::computeDomFrontiers — Cooper et al. runner formulation of Cytron's
 // DF(b) = { y | ∃ pred p of y : b dom p  and  b ⋢ sdom y }
 // Requires computeDominators() first.
 // ─────────────────────────────────────────────────────────────────────────────
 void CFG::computeDomFrontiers() {
     for (BasicBlock& bb : blocks) bb.domFrontier.clear();
 
+    // lastAdded[b] == y  ⇔  y is already in DF(b) (y only grows)
+    std::vector<int> lastAdded(blocks.size(), -1);
     for (int y = 0; y < (int)blocks.size(); ++y) {
         if (blocks[y].preds.size() < 2) continue;
         for (int p : blocks[y].preds) {
             int runner = p;
             while (runner != blocks[y].idom && runner != -1) {
-                blocks[runner].domFrontier.insert(y);
+                if (lastAdded[runner] == y) break; // rest of the walk was done
+                lastAdded[runner] = y;
+                blocks[runner].domFrontier.push_back(y);
                 runner = blocks[runner].idom;
             }
         }
@@ -301,50 +325,79 @@ void CFG::computeDomFrontiers() {
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// CFG::computeLiveness — backward dataflow worklist.
+// CFG::numberVars — dense IDs for every variable named by LOAD/DECLARE/STORE.
+// ─────────────────────────────────────────────────────────────────────────────
+void CFG::numberVars() {
+    vars.clear();
+    varIds.clear();
+    for (const BasicBlock& bb : blocks)
+        for (const IRInstr& ins : bb.instrs)
+            if (ins.op == IROp::LOAD || ins.op == IROp::DECLARE || ins.op == IROp::STORE)
+                if (varIds.emplace(ins.sval, (int)vars.size()).second)
+                    vars.push_back(ins.sval);
+}
+
+int CFG::varId(const std::string& name) const {
+    auto it = varIds.find(name);
+    return it == varIds.end() ? -1 : it->second;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// CFG::computeLiveness — backward bitset dataflow over a worklist.
 // Fills use/def/liveIn/liveOut for every block.
 // ─────────────────────────────────────────────────────────────────────────────
 void CFG::computeLiveness() {
     int n = blocks.size();
+    numberVars();
+    int nv = vars.size();
 
     // Compute per-block gen (use) and kill (def)
     for (BasicBlock& bb : blocks) {
-        bb.use.clear(); bb.def.clear();
+        bb.use.reset(nv); bb.def.reset(nv);
+        bb.liveIn.reset(nv); bb.liveOut.reset(nv);
         for (const IRInstr& ins : bb.instrs) {
-            if (ins.op == IROp::LOAD && !bb.def.count(ins.sval))
-                bb.use.insert(ins.sval);
+            if (ins.op == IROp::LOAD) {
+                int v = varIds[ins.sval];
+                if (!bb.def.test(v)) bb.use.set(v);
+            }
             if (ins.op == IROp::DECLARE || ins.op == IROp::STORE)
-                bb.def.insert(ins.sval);
+                bb.def.set(varIds[ins.sval]);
         }
     }
 
-    // Worklist: start with all blocks (process in reverse order for efficiency)
-    std::vector<bool> inQueue(n, true);
-    std::queue<int> wl;
-    for (int i = n - 1; i >= 0; --i) wl.push(i);
+    // Worklist seeded in post-order (successors before predecessors), then
+    // any unreachable blocks.
+    std::vector<int> order = reversePostOrder();
+    std::reverse(order.begin(), order.end());
+    std::vector<bool> inQueue(n, false);
+    for (int b : order) inQueue[b] = true;
+    for (int b = 0; b < n; ++b) if (!inQueue[b]) { inQueue[b] = true; order.push_back(b); }
+    std::deque<int> wl(order.begin(), order.end());
 
+    size_t nw = (nv + 63) / 64;
     while (!wl.empty()) {
-        int b = wl.front(); wl.pop();
+        int b = wl.front(); wl.pop_front();
         inQueue[b] = false;
 
         BasicBlock& bb = blocks[b];
 
         // liveOut[b] = ∪ liveIn[s] for each successor s
-        std::unordered_set<std::string> newOut;
-        for (int s : bb.succs)
-            for (const std::string& v : blocks[s].liveIn) newOut.insert(v);
-
-        // liveIn[b] = use[b] ∪ (liveOut[b] − def[b])
-        std::unordered_set<std::string> newIn = bb.use;
-        for (const std::string& v : newOut)
-            if (!bb.def.count(v)) newIn.insert(v);
-
-        if (newIn != bb.liveIn || newOut != bb.liveOut) {
-            bb.liveIn  = std::move(newIn);
-            bb.liveOut = std::move(newOut);
-            for (int p : bb.preds)
-                if (!inQueue[p]) { inQueue[p] = true; wl.push(p); }
+        for (size_t w = 0; w < nw; ++w) {
+            uint64_t out = 0;
+            for (int s : bb.succs) out |= blocks[s].liveIn.words[w];
+            bb.liveOut.words[w] = out;
+        }
+
+        // liveIn[b] = use[b] ∪ (liveOut[b] − def[b]); only a changed liveIn
+        // can change a predecessor's liveOut.
+        bool changed = false;
+        for (size_t w = 0; w < nw; ++w) {
+            uint64_t in = bb.use.words[w] | (bb.liveOut.words[w] & ~bb.def.words[w]);
+            if (in != bb.liveIn.words[w]) { bb.liveIn.words[w] = in; changed = true; }
         }
+        if (changed)
+            for (int p : bb.preds)
+                if (!inQueue[p]) { inQueue[p] = true; wl.push_back(p); }
     }
 }
 
@@ -362,76 +415,89 @@ void CFG::computeLiveness() {
 void buildSSA(CFG& cfg) {
     cfg.computeDominators();
     cfg.computeDomFrontiers();
+    cfg.numberVars();
 
-    int n = cfg.blocks.size();
+    int n  = cfg.blocks.size();
+    int nv = cfg.vars.size();
 
     // ── Step 1: collect def-sites ────────────────────────────────────────────
-    std::unordered_map<std::string, std::unordered_set<int>> defsites;
+    std::vector<std::vector<int>> defsites(nv);
     for (int b = 0; b < n; ++b)
         for (const IRInstr& ins : cfg.blocks[b].instrs)
-            if (ins.op == IROp::DECLARE || ins.op == IROp::STORE)
-                defsites[ins.sval].insert(b);
+            if (ins.op == IROp::DECLARE || ins.op == IROp::STORE) {
+                std::vector<int>& d = defsites[cfg.varIds[ins.sval]];
+                if (d.empty() || d.back() != b) d.push_back(b);
+            }
 
     // ── Step 2: insert phi nodes at IDF ──────────────────────────────────────
-    for (auto& [var, defs] : defsites) {
+    // placed[b] / queued[b] hold the ID of the last variable that marked b,
+    // so the marks need no clearing between variables.
+    std::vector<int> placed(n, -1), queued(n, -1);
+    std::vector<int> wl;
+    for (int var = 0; var < nv; ++var) {
+        const std::vector<int>& defs = defsites[var];
         if (defs.size() < 2) continue; // single def site: no phi needed
 
-        std::queue<int> wl;
-        std::unordered_set<int> inWl, placed;
-        for (int b : defs) { wl.push(b); inWl.insert(b); }
+        wl.clear();
+        for (int b : defs) { wl.push_back(b); queued[b] = var; }
 
         while (!wl.empty()) {
-            int b = wl.front(); wl.pop(); inWl.erase(b);
+            int b = wl.back(); wl.pop_back();
             for (int df : cfg.blocks[b].domFrontier) {
-                if (placed.count(df)) continue;
+                if (placed[df] == var) continue;
                 PhiNode phi;
-                phi.origVar = var;
-                phi.dest    = var; // renamed in step 3
+                phi.origVar = cfg.vars[var];
+                phi.dest    = cfg.vars[var]; // renamed in step 3
                 for (int p : cfg.blocks[df].preds)
-                    phi.srcs.push_back({var, p}); // sources renamed in step 3
+                    phi.srcs.push_back({cfg.vars[var], p}); // sources renamed in step 3
                 cfg.blocks[df].phis.push_back(std::move(phi));
-                placed.insert(df);
+                placed[df] = var;
                 // Phi itself is a new def-site: propagate
-                if (!inWl.count(df)) { wl.push(df); inWl.insert(df); }
+                if (queued[df] != var) { queued[df] = var; wl.push_back(df); }
             }
         }
     }
 
     // ── Step 3: rename (DFS on dominator tree) ───────────────────────────────
-    std::unordered_map<std::string, int>                  counter;
-    std::unordered_map<std::string, std::vector<std::string>> stk; // var → version stack
-
-    auto newVer = [&](const std::string& var) -> std::string {
-        int v = counter[var]++;
-        std::string name = var + "$" + std::to_string(v);
-        stk[var].push_back(name);
-        return name;
+    std::vector<int>                      counter(nv, 0);
+    std::vector<std::vector<std::string>> stk(nv); // var ID → version stack
+    std::vector<int>                      pushed;  // var IDs, in push order
+
+    auto newVer = [&](int var) -> const std::string& {
+        stk[var].push_back(cfg.vars[var] + "$" + std::to_string(counter[var]++));
+        pushed.push_back(var);
+        return stk[var].back();
     };
 
-    auto topVer = [&](const std::string& var) -> std::string {
-        auto it = stk.find(var);
-        if (it == stk.end() || it->second.empty()) return var;
-        return it->second.back();
+    auto topVer = [&](int var) -> const std::string& {
+        return stk[var].empty() ? cfg.vars[var] : stk[var].back();
     };
 
-    // Track what was pushed per block so we can pop on exit
-    std::function<void(int)> rename = [&](int b) {
-        std::vector<std::pair<std::string,int>> pushed; // (orig_var, push_count)
+    // Iterative pre/post walk of the dominator tree; each entry remembers how
+    // many versions were pushed before the block so its exit can pop them.
+    struct Visit { int block; size_t mark; bool exiting; };
+    std::vector<Visit> walk;
+    if (n > 0) walk.push_back({0, 0, false});
+    while (!walk.empty()) {
+        Visit v = walk.back(); walk.pop_back();
+        if (v.exiting) {
+            // Pop all versions introduced in this block
+            while (pushed.size() > v.mark) { stk[pushed.back()].pop_back(); pushed.pop_back(); }
+            continue;
+        }
+        int b = v.block;
+        walk.push_back({b, pushed.size(), true});
 
         // Rename phi destinations
-        for (PhiNode& phi : cfg.blocks[b].phis) {
-            phi.dest = newVer(phi.origVar);
-            pushed.push_back({phi.origVar, 1});
-        }
+        for (PhiNode& phi : cfg.blocks[b].phis)
+            phi.dest = newVer(cfg.varIds[phi.origVar]);
 
         // Rename instructions: uses before defs
         for (IRInstr& ins : cfg.blocks[b].instrs) {
             if (ins.op == IROp::LOAD) {
-                ins.sval = topVer(ins.sval);
+                ins.sval = topVer(cfg.varIds[ins.sval]);
             } else if (ins.op == IROp::DECLARE || ins.op == IROp::STORE) {
-                std::string orig = ins.sval;
-                ins.sval = newVer(orig);
-                pushed.push_back({orig, 1});
+                ins.sval = newVer(cfg.varIds[ins.sval]);
             }
         }
 
@@ -440,21 +506,16 @@ void buildSSA(CFG& cfg) {
             for (PhiNode& phi : cfg.blocks[s].phis) {
                 for (auto& [srcVar, srcBlock] : phi.srcs) {
                     if (srcBlock == b)
-                        srcVar = topVer(phi.origVar);
+                        srcVar = topVer(cfg.varIds[phi.origVar]);
                 }
             }
         }
 
-        // Recurse to dominator children
-        for (int child : cfg.blocks[b].domChildren) rename(child);
-
-        // Pop all versions introduced in this block
-        for (auto& [var, cnt] : pushed)
-            for (int i = 0; i < cnt; ++i)
-                if (!stk[var].empty()) stk[var].pop_back();
-    };
-
-    if (n > 0) rename(0);
+        // Recurse to dominator children (pushed in reverse to keep their order)
+        const std::vector<int>& kids = cfg.blocks[b].domChildren;
+        for (auto it = kids.rbegin(); it != kids.rend(); ++it)
+            walk.push_back({*it, 0, false});
+    }
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -487,8 +548,9 @@ void destroySSA(CFG& cfg) {
 // provided the preceding instruction is a pure value producer (constant push or
 // LOAD).  The LOAD case covers copies inserted by GVN / phi elimination.
 // ─────────────────────────────────────────────────────────────────────────────
-std::vector<IRInstr> livenessDSE(const std::vector<IRInstr>& code) {
-    if (code.empty()) return code;
+int livenessDSE(std::vector<IRInstr>& code) {
+    if (code.empty()) return 0;
+    int changes = 0;
 
     CFG cfg = CFG::build("__ldse", code);
     cfg.computeLiveness();
@@ -518,9 +580,10 @@ std::vector<IRInstr> livenessDSE(const std::vector<IRInstr>& code) {
                     break; // overwritten before being read
             }
 
-            if (!usedLater && !bb.liveOut.count(var)) {
+            if (!usedLater && !bb.liveOut.test(cfg.varId(var))) {
                 dead[i]   = true;
                 dead[i-1] = true; // drop the producer too
+                ++changes;
             }
         }
 
@@ -531,5 +594,6 @@ std::vector<IRInstr> livenessDSE(const std::vector<IRInstr>& code) {
         bb.instrs = std::move(kept);
     }
 
-    return cfg.flatten();
+    if (changes) code = cfg.flatten();
+    return changes;
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "ir.hpp"
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -18,6 +19,30 @@ struct PhiNode {
     std::vector<std::pair<std::string,int>> srcs;
 };
 
+// ─────────────────────────────────────────────────────────────────────────────
+// VarSet: dense bitset over the per-function variable IDs of a CFG
+// (see CFG::numberVars).  All sets of one CFG share the same width.
+// ─────────────────────────────────────────────────────────────────────────────
+struct VarSet {
+    std::vector<uint64_t> words;
+
+    void reset(int nbits) { words.assign((nbits + 63) / 64, 0); }
+    void set(int i)       { words[i >> 6] |= uint64_t(1) << (i & 63); }
+    bool test(int i) const {
+        return i >= 0 && (size_t)(i >> 6) < words.size() &&
+               ((words[i >> 6] >> (i & 63)) & 1);
+    }
+    bool operator==(const VarSet& o) const { return words == o.words; }
+    bool operator!=(const VarSet& o) const { return words != o.words; }
+
+    // Calls f(id) for every member in increasing order.
+    template <class F> void forEach(F f) const {
+        for (size_t w = 0; w < words.size(); ++w)
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1)
+                f((int)(w * 64 + __builtin_ctzll(bits)));
+    }
+};
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Basic block: a maximal straight-line sequence of instructions.
 // ─────────────────────────────────────────────────────────────────────────────
@@ -31,16 +56,16 @@ struct BasicBlock {
     std::vector<int> succs;         // successor block IDs
     std::vector<int> preds;         // predecessor block IDs
 
-    // Liveness (filled by CFG::computeLiveness)
-    std::unordered_set<std::string> use;      // vars used before any def in block
-    std::unordered_set<std::string> def;      // vars defined in block
-    std::unordered_set<std::string> liveIn;
-    std::unordered_set<std::string> liveOut;
+    // Liveness (filled by CFG::computeLiveness), indexed by CFG variable ID
+    VarSet use;                     // vars used before any def in block
+    VarSet def;                     // vars defined in block
+    VarSet liveIn;
+    VarSet liveOut;
 
     // Dominator info (filled by CFG::computeDominators / computeDomFrontiers)
     int              idom = -1;               // immediate dominator (-1 for entry)
     std::vector<int> domChildren;
-    std::unordered_set<int> domFrontier;
+    std::vector<int> domFrontier;             // no duplicates
 
     bool isExit() const { return succs.empty(); }
 };
@@ -53,6 +78,11 @@ struct CFG {
     std::vector<BasicBlock> blocks;             // blocks[0] is always the entry
     std::unordered_map<std::string,int> labelToBlock;
 
+    // Variable numbering (filled by numberVars): every name read or written
+    // by LOAD / DECLARE / STORE gets a dense ID in order of first appearance.
+    std::vector<std::string>            vars;     // ID → name
+    std::unordered_map<std::string,int> varIds;   // name → ID
+
     // Build from a flat instruction vector.
     static CFG build(const std::string& name, const std::vector<IRInstr>& code);
 
@@ -63,10 +93,19 @@ struct CFG {
     void dump() const;
 
     // ── Analysis passes (modify blocks in-place) ──────────────────────────
-    // Backward dataflow: fills use/def/liveIn/liveOut.
+    // Number the variables of the current instructions (renumbers from
+    // scratch, so call it again after renaming, e.g. after buildSSA).
+    void numberVars();
+
+    // ID of a numbered variable, or -1.
+    int varId(const std::string& name) const;
+
+    // Backward bitset dataflow over a worklist: renumbers variables, then
+    // fills use/def/liveIn/liveOut.
     void computeLiveness();
 
-    // Cooper et al. iterative dominators: fills idom + domChildren.
+    // Cooper et al. iterative dominators over RPO index arrays:
+    // fills idom + domChildren.
     void computeDominators();
 
     // Cytron et al.: fills domFrontier (requires computeDominators first).
@@ -88,6 +127,7 @@ void destroySSA(CFG& cfg);
 // Liveness-based dead store elimination.
 // Builds a CFG internally, runs liveness, removes DECLARE x whose value is
 // never read before it's overwritten or the block exits.
-// Returns an optimised flat instruction vector.
+// Rewrites code only if something was removed; returns the number of
+// stores removed.
 // ─────────────────────────────────────────────────────────────────────────────
-std::vector<IRInstr> livenessDSE(const std::vector<IRInstr>& code);
+int livenessDSE(std::vector<IRInstr>& code);
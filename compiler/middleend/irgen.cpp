@@ -193,10 +193,13 @@ void IRGen::genStmt(const Statement* stmt) {
             std::string objPart = asgn->name.substr(0, dot);
             std::string field   = asgn->name.substr(dot + 1);
 
-            // "this.field = value" inside a method → treat as bare field update (fields-as-locals)
+            // "this.field = value" inside a method → STORE_FIELD on this; the VM
+            // mirrors it into the field's local copy (fields-as-locals), so
+            // later reads through either this.field or the bare name agree.
             if (objPart == "this") {
+                emit(IROp::PUSH_THIS);
                 genExpr(asgn->value.get());
-                emit(IROp::STORE, field);
+                emit(IROp::STORE_FIELD, field);
                 return;
             }
 
@@ -463,6 +466,8 @@ static const char* opName(IROp op) {
         case IROp::LOAD:        return "LOAD";
         case IROp::DECLARE:     return "DECLARE";
         case IROp::STORE:       return "STORE";
+        case IROp::LOAD_SLOT:   return "LOAD_SLOT";
+        case IROp::STORE_SLOT:  return "STORE_SLOT";
         case IROp::POP:         return "POP";
         case IROp::ADD:         return "ADD";
         case IROp::SUB:         return "SUB";
@@ -502,15 +507,29 @@ static const char* opName(IROp op) {
         case IROp::ENTER_SCOPE: return "ENTER_SCOPE";
         case IROp::EXIT_SCOPE:  return "EXIT_SCOPE";
         case IROp::NOP:         return "NOP";
+        case IROp::INC_SLOT:           return "INC_SLOT";
+        case IROp::CMP_LT_JUMP_FALSE:  return "CMP_LT_JUMP_FALSE";
+        case IROp::CMP_GT_JUMP_FALSE:  return "CMP_GT_JUMP_FALSE";
+        case IROp::CMP_EQ_JUMP_FALSE:  return "CMP_EQ_JUMP_FALSE";
+        case IROp::CMP_NEQ_JUMP_FALSE: return "CMP_NEQ_JUMP_FALSE";
+        case IROp::LOAD_FIELD_THIS:    return "LOAD_FIELD_THIS";
+        case IROp::LOAD_SLOT2:         return "LOAD_SLOT2";
+        case IROp::MOVE_SLOT:          return "MOVE_SLOT";
+        case IROp::STORE_LOAD_SLOT:    return "STORE_LOAD_SLOT";
     }
     return "?";
 }
 
-static void dumpCode(const std::vector<IRInstr>& code, const std::string& indent = "  ") {
+// Programs loaded from TLBC v2 carry their strings only in the pool.
+static void dumpCode(const std::vector<IRInstr>& code,
+                     const std::vector<std::string>& pool,
+                     const std::string& indent = "  ") {
     for (auto& ins : code) {
-        if (ins.op == IROp::LABEL) { std::cout << ins.sval << ":\n"; continue; }
+        const std::string& sval = (ins.sval.empty() && ins.sidx >= 0 &&
+                                   ins.sidx < (int)pool.size()) ? pool[ins.sidx] : ins.sval;
+        if (ins.op == IROp::LABEL) { std::cout << sval << ":\n"; continue; }
         std::cout << indent << opName(ins.op);
-        if (!ins.sval.empty())  std::cout << " " << ins.sval;
+        if (!sval.empty())  std::cout << " " << sval;
         switch (ins.op) {
             case IROp::PUSH_INT:
             case IROp::PUSH_BOOL:
@@ -519,6 +538,19 @@ static void dumpCode(const std::vector<IRInstr>& code, const std::string& indent
                 std::cout << " " << ins.dval; break;
             case IROp::PUSH_CHAR:
                 std::cout << " '" << ins.cval << "'"; break;
+            case IROp::INC_SLOT:
+            case IROp::LOAD_SLOT2:
+            case IROp::MOVE_SLOT:
+            case IROp::STORE_LOAD_SLOT:
+                std::cout << " " << ins.ival << " " << ins.aux; break;
+            case IROp::LOAD_SLOT:
+            case IROp::STORE_SLOT:
+            case IROp::JUMP:
+            case IROp::JUMP_FALSE:
+            case IROp::CMP_LT_JUMP_FALSE:
+            case IROp::CMP_GT_JUMP_FALSE:
+            case IROp::CMP_EQ_JUMP_FALSE:
+            case IROp::CMP_NEQ_JUMP_FALSE:
             case IROp::CALL:
             case IROp::CALL_METHOD:
             case IROp::CALL_SUPER:
@@ -540,10 +572,10 @@ void IRGen::dump(const IRProgram& prog) {
             std::cout << fn.params[i].first << " " << fn.params[i].second;
         }
         std::cout << "):\n";
-        dumpCode(fn.code);
+        dumpCode(fn.code, prog.strings);
     }
     std::cout << "\n[main]:\n";
-    dumpCode(prog.main);
+    dumpCode(prog.main, prog.strings);
     std::cout << "===================\n";
 }
 
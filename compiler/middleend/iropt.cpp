@@ -5,6 +5,8 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstdlib>
+#include <deque>
 
 // ─────────────────────────────────────────────────────────────────────────────
 // Predicate helpers
@@ -30,38 +32,35 @@ static bool hasSideEffect(IROp op) {
 // Track variables assigned constant values; replace LOAD of those variables
 // with the constant push instruction directly.
 // ─────────────────────────────────────────────────────────────────────────────
-static std::vector<IRInstr> constantPropagation(const std::vector<IRInstr>& code) {
+static int constantPropagation(std::vector<IRInstr>& code) {
     std::unordered_map<std::string, IRInstr> constMap; // var → constant push instr
-    std::vector<IRInstr> result;
-    result.reserve(code.size());
+    int changes = 0;
 
-    for (const IRInstr& ins : code) {
+    for (size_t i = 0; i < code.size(); ++i) {
+        IRInstr& ins = code[i];
         switch (ins.op) {
         case IROp::LOAD: {
             auto it = constMap.find(ins.sval);
-            result.push_back(it != constMap.end() ? it->second : ins);
+            if (it != constMap.end()) { ins = it->second; ++changes; }
             break;
         }
         case IROp::DECLARE:
         case IROp::STORE:
-            if (!result.empty() && isConstPush(result.back().op))
-                constMap[ins.sval] = result.back();
+            if (i > 0 && isConstPush(code[i-1].op))
+                constMap[ins.sval] = code[i-1];
             else
                 constMap.erase(ins.sval);
-            result.push_back(ins);
             break;
         case IROp::LABEL:
         case IROp::EXIT_SCOPE:
             constMap.clear();
-            result.push_back(ins);
             break;
         default:
             if (hasSideEffect(ins.op)) constMap.clear();
-            result.push_back(ins);
             break;
         }
     }
-    return result;
+    return changes;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -71,37 +70,43 @@ static std::vector<IRInstr> constantPropagation(const std::vector<IRInstr>& code
 // Also fold constant-condition JUMP_FALSE: if the condition is a known
 // int/bool constant, replace with an unconditional JUMP or drop entirely.
 // ─────────────────────────────────────────────────────────────────────────────
-static std::vector<IRInstr> deadCodeElimination(const std::vector<IRInstr>& code) {
-    std::vector<IRInstr> result;
-    result.reserve(code.size());
+static int deadCodeElimination(std::vector<IRInstr>& code) {
+    size_t w = 0;   // compacted length; code[0, w) is the result so far
+    int changes = 0;
     bool unreachable = false;
 
-    for (const IRInstr& ins : code) {
+    for (size_t i = 0; i < code.size(); ++i) {
+        IRInstr& ins = code[i];
         if (ins.op == IROp::LABEL) {
             unreachable = false;
-            result.push_back(ins);
+            if (w != i) code[w] = std::move(ins);
+            ++w;
             continue;
         }
-        if (unreachable) continue;
+        if (unreachable) { ++changes; continue; }
 
         // Constant-condition JUMP_FALSE → unconditional JUMP or dead branch
-        if (ins.op == IROp::JUMP_FALSE && !result.empty() &&
-            (result.back().op == IROp::PUSH_INT || result.back().op == IROp::PUSH_BOOL)) {
-            int val = result.back().ival;
-            result.pop_back(); // remove the constant push
+        if (ins.op == IROp::JUMP_FALSE && w > 0 &&
+            (code[w-1].op == IROp::PUSH_INT || code[w-1].op == IROp::PUSH_BOOL)) {
+            int val = code[w-1].ival;
+            --w; // remove the constant push
+            ++changes;
             if (val == 0) {
-                result.push_back({IROp::JUMP, ins.sval}); // always jumps
+                code[w++] = IRInstr{IROp::JUMP, ins.sval}; // always jumps
                 unreachable = true;
             }
             // else always falls through → drop the JUMP_FALSE
             continue;
         }
 
-        result.push_back(ins);
-        if (ins.op == IROp::JUMP || ins.op == IROp::RETURN || ins.op == IROp::RETURN_VAL)
+        IROp op = ins.op;
+        if (w != i) code[w] = std::move(ins);
+        ++w;
+        if (op == IROp::JUMP || op == IROp::RETURN || op == IROp::RETURN_VAL)
             unreachable = true;
     }
-    return result;
+    code.resize(w);
+    return changes;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -109,22 +114,25 @@ static std::vector<IRInstr> deadCodeElimination(const std::vector<IRInstr>& code
 // When a = b (LOAD b; DECLARE/STORE a), replace subsequent LOAD a with LOAD b
 // as long as neither a nor b has been reassigned.
 // ─────────────────────────────────────────────────────────────────────────────
-static std::vector<IRInstr> copyPropagation(const std::vector<IRInstr>& code) {
+static int copyPropagation(std::vector<IRInstr>& code) {
     std::unordered_map<std::string, std::string> copyOf; // a → b (a equals b)
-    std::vector<IRInstr> result;
-    result.reserve(code.size());
+    int changes = 0;
 
-    for (const IRInstr& ins : code) {
+    for (size_t i = 0; i < code.size(); ++i) {
+        IRInstr& ins = code[i];
         switch (ins.op) {
         case IROp::LOAD: {
             auto it = copyOf.find(ins.sval);
-            result.push_back(it != copyOf.end() ? IRInstr{IROp::LOAD, it->second} : ins);
+            if (it != copyOf.end() && it->second != ins.sval) {
+                ins = IRInstr{IROp::LOAD, it->second};
+                ++changes;
+            }
             break;
         }
         case IROp::DECLARE:
         case IROp::STORE:
-            if (!result.empty() && result.back().op == IROp::LOAD) {
-                copyOf[ins.sval] = result.back().sval;
+            if (i > 0 && code[i-1].op == IROp::LOAD) {
+                copyOf[ins.sval] = code[i-1].sval;
             } else {
                 copyOf.erase(ins.sval);
             }
@@ -135,20 +143,17 @@ static std::vector<IRInstr> copyPropagation(const std::vector<IRInstr>& code) {
                 else
                     ++it;
             }
-            result.push_back(ins);
             break;
         case IROp::LABEL:
         case IROp::EXIT_SCOPE:
             copyOf.clear();
-            result.push_back(ins);
             break;
         default:
             if (hasSideEffect(ins.op)) copyOf.clear();
-            result.push_back(ins);
             break;
         }
     }
-    return result;
+    return changes;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -158,9 +163,10 @@ static std::vector<IRInstr> copyPropagation(const std::vector<IRInstr>& code) {
 // Only eliminates pairs where the preceding push is a simple constant push,
 // so we can safely remove both the push and the declare/store together.
 // ─────────────────────────────────────────────────────────────────────────────
-static std::vector<IRInstr> deadStoreElimination(const std::vector<IRInstr>& code) {
+static int deadStoreElimination(std::vector<IRInstr>& code) {
     size_t n = code.size();
     std::vector<bool> dead(n, false);
+    int changes = 0;
 
     for (size_t i = 0; i < n; ++i) {
         if (code[i].op != IROp::DECLARE && code[i].op != IROp::STORE) continue;
@@ -176,16 +182,19 @@ static std::vector<IRInstr> deadStoreElimination(const std::vector<IRInstr>& cod
             if ((op == IROp::DECLARE || op == IROp::STORE) && code[j].sval == var) {
                 dead[i]   = true; // store is dead
                 dead[i-1] = true; // preceding constant push is dead
+                ++changes;
                 break;
             }
         }
     }
 
-    std::vector<IRInstr> result;
-    result.reserve(n);
-    for (size_t i = 0; i < n; ++i)
-        if (!dead[i]) result.push_back(code[i]);
-    return result;
+    if (changes) {
+        size_t w = 0;
+        for (size_t i = 0; i < n; ++i)
+            if (!dead[i]) { if (w != i) code[w] = std::move(code[i]); ++w; }
+        code.resize(w);
+    }
+    return changes;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -195,7 +204,9 @@ static std::vector<IRInstr> deadStoreElimination(const std::vector<IRInstr>& cod
 // On subsequent occurrences, load the temp directly instead of recomputing.
 // Only applies to expressions that appear more than once in the same block.
 // ─────────────────────────────────────────────────────────────────────────────
-static std::vector<IRInstr> commonSubexprElim(const std::vector<IRInstr>& code) {
+// Grows the code, so unlike the other flat passes it builds a new vector —
+// only once an expression is known to repeat.
+static int commonSubexprElim(std::vector<IRInstr>& code) {
     // Pre-scan: count per-block occurrences of each LOAD-LOAD-BINOP triple.
     std::unordered_map<std::string, int> blockExprCount;
     {
@@ -212,11 +223,19 @@ static std::vector<IRInstr> commonSubexprElim(const std::vector<IRInstr>& code)
             }
         }
     }
+    bool repeats = false;
+    for (auto& [key, count] : blockExprCount) if (count > 1) { repeats = true; break; }
+    if (!repeats) return 0;
 
     // Main pass: transform multi-occurrence expressions.
     std::unordered_map<std::string, std::string> exprToTemp;
     std::unordered_map<std::string, std::pair<std::string,std::string>> tempDeps;
-    int cseCount = 0, bb = 0;
+    // The driver reruns this pass on its own output; number new temps past
+    // those an earlier run left, so a live __cse_N is never declared twice.
+    int cseCount = 0, bb = 0, changes = 0;
+    for (const IRInstr& ins : code)
+        if (ins.op == IROp::DECLARE && ins.sval.compare(0, 6, "__cse_") == 0)
+            cseCount = std::max(cseCount, std::atoi(ins.sval.c_str() + 6) + 1);
     std::vector<IRInstr> result;
     result.reserve(code.size() + 16);
 
@@ -262,6 +281,7 @@ static std::vector<IRInstr> commonSubexprElim(const std::vector<IRInstr>& code)
                 auto it = exprToTemp.find(key);
                 if (it != exprToTemp.end()) {
                     result.push_back({IROp::LOAD, it->second}); // reuse cached result
+                    ++changes;
                 } else {
                     // Compute, stash in temp, reload — preserves stack neutrality
                     std::string tmp = "__cse_" + std::to_string(cseCount++);
@@ -280,7 +300,8 @@ static std::vector<IRInstr> commonSubexprElim(const std::vector<IRInstr>& code)
         result.push_back(ins);
         ++i;
     }
-    return result;
+    if (changes) code = std::move(result);
+    return changes;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -292,9 +313,9 @@ static std::vector<IRInstr> commonSubexprElim(const std::vector<IRInstr>& code)
 //   x - 0  →  x         (remove PUSH_INT 0 + SUB)
 //   x * 0  →  0         (POP x, push 0)
 // ─────────────────────────────────────────────────────────────────────────────
-static std::vector<IRInstr> strengthReduction(const std::vector<IRInstr>& code) {
-    std::vector<IRInstr> result;
-    result.reserve(code.size());
+static int strengthReduction(std::vector<IRInstr>& code) {
+    size_t w = 0;   // compacted length; never passes i
+    int changes = 0;
 
     size_t i = 0;
     while (i < code.size()) {
@@ -303,20 +324,21 @@ static std::vector<IRInstr> strengthReduction(const std::vector<IRInstr>& code)
             const IRInstr& next = code[i+1];
 
             if (cur.op == IROp::PUSH_INT) {
-                if (cur.ival == 1 && next.op == IROp::MUL) { i += 2; continue; }
-                if (cur.ival == 1 && next.op == IROp::DIV) { i += 2; continue; }
-                if (cur.ival == 0 && next.op == IROp::ADD) { i += 2; continue; }
-                if (cur.ival == 0 && next.op == IROp::SUB) { i += 2; continue; }
+                bool identity = (cur.ival == 1 && (next.op == IROp::MUL || next.op == IROp::DIV)) ||
+                                (cur.ival == 0 && (next.op == IROp::ADD || next.op == IROp::SUB));
+                if (identity) { i += 2; ++changes; continue; }
                 if (cur.ival == 0 && next.op == IROp::MUL) {
-                    result.push_back({IROp::POP});
-                    result.push_back({IROp::PUSH_INT, "", 0});
-                    i += 2; continue;
+                    code[w++] = IRInstr{IROp::POP};
+                    code[w++] = IRInstr{IROp::PUSH_INT, "", 0};
+                    i += 2; ++changes; continue;
                 }
             }
         }
-        result.push_back(code[i++]);
+        if (w != i) code[w] = std::move(code[i]);
+        ++w; ++i;
     }
-    return result;
+    code.resize(w);
+    return changes;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -327,24 +349,28 @@ static std::vector<IRInstr> strengthReduction(const std::vector<IRInstr>& code)
 // where neither a nor b is written in the loop, and x is declared exactly once.
 // Hoist those four instructions to just before the LABEL.
 // ─────────────────────────────────────────────────────────────────────────────
-static std::vector<IRInstr> loopInvariantCodeMotion(const std::vector<IRInstr>& code) {
-    std::vector<IRInstr> result(code.begin(), code.end());
+static int loopInvariantCodeMotion(std::vector<IRInstr>& result) {
     bool changed = true;
+    int changes = 0;
 
     while (changed) {
         changed = false;
         size_t n = result.size();
 
+        // Positions of the JUMPs to each label, ascending
+        std::unordered_map<std::string, std::vector<size_t>> jumpsTo;
+        for (size_t j = 0; j < n; ++j)
+            if (result[j].op == IROp::JUMP) jumpsTo[result[j].sval].push_back(j);
+
         for (size_t ls = 0; ls < n && !changed; ++ls) {
             if (result[ls].op != IROp::LABEL) continue;
-            const std::string& loopLabel = result[ls].sval;
 
             // Find the back-edge JUMP to this label
-            size_t lj = n;
-            for (size_t j = ls + 1; j < n; ++j) {
-                if (result[j].op == IROp::JUMP && result[j].sval == loopLabel) { lj = j; break; }
-            }
-            if (lj == n) continue;
+            auto jt = jumpsTo.find(result[ls].sval);
+            if (jt == jumpsTo.end()) continue;
+            auto back = std::upper_bound(jt->second.begin(), jt->second.end(), ls);
+            if (back == jt->second.end()) continue;
+            size_t lj = *back;
 
             // Collect all variables written in the loop body [ls+1, lj-1]
             std::unordered_set<std::string> written;
@@ -378,10 +404,11 @@ static std::vector<IRInstr> loopInvariantCodeMotion(const std::vector<IRInstr>&
                 result.erase(result.begin() + j, result.begin() + j + 4);
                 result.insert(result.begin() + ls, hoisted.begin(), hoisted.end());
                 changed = true;
+                ++changes;
             }
         }
     }
-    return result;
+    return changes;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -399,8 +426,10 @@ static std::vector<IRInstr> loopInvariantCodeMotion(const std::vector<IRInstr>&
 // copies), and copy propagation + DSE clean up any leftover identity copies.
 // ─────────────────────────────────────────────────────────────────────────────
 
-static void runGVNOnCFG(CFG& cfg) {
+// Returns the number of recomputations replaced.
+static int runGVNOnCFG(CFG& cfg) {
     using ExprTable = std::unordered_map<std::string, std::string>;
+    int changes = 0;
 
     auto getVN = [](const IRInstr& ins) -> std::string {
         switch (ins.op) {
@@ -439,6 +468,7 @@ static void runGVNOnCFG(CFG& cfg) {
                         // Redundant: replace with copy of the canonical result
                         result.push_back({IROp::LOAD,    it->second});
                         result.push_back({IROp::DECLARE, dest});
+                        ++changes;
                     } else {
                         table[key] = dest;
                         result.push_back(bb.instrs[i]);
@@ -460,61 +490,89 @@ static void runGVNOnCFG(CFG& cfg) {
     };
 
     if (!cfg.blocks.empty()) visit(0, {});
+    return changes;
 }
 
-static std::vector<IRInstr> gvnPass(const std::vector<IRInstr>& code) {
-    if (code.size() < 4) return code;
+// The code is only replaced when GVN found a redundancy; otherwise the SSA
+// round trip would just rename variables and add phi copies.
+static int gvnPass(std::vector<IRInstr>& code) {
+    if (code.size() < 4) return 0;
 
     CFG cfg = CFG::build("__gvn", code);
-    if (cfg.blocks.size() < 2) return code; // single-block: flat CSE already covers it
+    if (cfg.blocks.size() < 2) return 0; // single-block: flat CSE already covers it
 
-    buildSSA(cfg);       // rename into SSA form; builds dominator tree internally
-    runGVNOnCFG(cfg);    // eliminate cross-block redundancies
-    destroySSA(cfg);     // phi elimination (LOAD/STORE copies in predecessors)
+    buildSSA(cfg);                       // rename into SSA form; builds dominator tree internally
+    int changes = runGVNOnCFG(cfg);      // eliminate cross-block redundancies
+    if (changes == 0) return 0;
+    destroySSA(cfg);                     // phi elimination (LOAD/STORE copies in predecessors)
 
-    auto result = cfg.flatten();
-    result = copyPropagation(result);    // collapse identity copies from phi elim
-    result = deadStoreElimination(result); // remove any newly dead stores
-    return result;
+    code = cfg.flatten();
+    copyPropagation(code);               // collapse identity copies from phi elim
+    deadStoreElimination(code);          // remove any newly dead stores
+    return changes;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Apply a pass to main code and every function in the program
+// Fixed-point driver
+//
+// Each code unit (main and every function) gets a worklist seeded with the
+// whole pipeline in order.  A pass that changes the code re-queues every
+// other pass not already queued, so opportunities it exposes (e.g. GVN
+// turning a recomputation into a copy that copy propagation then folds) are
+// revisited.  A pass that reports no change leaves the code untouched.  The
+// budget caps the pass runs per unit; it is only reached by pathological
+// inputs, and stopping early still leaves valid code.
 // ─────────────────────────────────────────────────────────────────────────────
 
-using PassFn = std::vector<IRInstr>(*)(const std::vector<IRInstr>&);
-
-static void applyPass(IRProgram& prog, PassFn pass) {
-    prog.main = pass(prog.main);
-    for (auto& [key, fn] : prog.functions)
-        fn.code = pass(fn.code);
+using PassFn = int(*)(std::vector<IRInstr>&);
+
+struct PassInfo { const char* name; PassFn run; };
+
+static const PassInfo kPasses[] = {
+    {"constprop", constantPropagation},
+    {"dce",       deadCodeElimination},
+    {"copyprop",  copyPropagation},
+    {"dse",       deadStoreElimination},
+    {"cse",       commonSubexprElim},
+    {"strength",  strengthReduction},
+    {"licm",      loopInvariantCodeMotion},
+    {"gvn",       gvnPass},
+    {"ldse",      livenessDSE},
+};
+static constexpr int kNumPasses = sizeof(kPasses) / sizeof(kPasses[0]);
+static constexpr int kPassBudget = 8 * kNumPasses;
+
+static void optimizeUnit(std::vector<IRInstr>& code, OptStats& stats) {
+    std::deque<int> wl;
+    std::vector<bool> queued(kNumPasses, true);
+    for (int p = 0; p < kNumPasses; ++p) wl.push_back(p);
+
+    int runs = 0;
+    while (!wl.empty()) {
+        if (runs == kPassBudget) { ++stats.budgetExhausted; break; }
+        int p = wl.front(); wl.pop_front();
+        queued[p] = false;
+        ++runs;
+
+        int changes = kPasses[p].run(code);
+        stats.passes[p].runs++;
+        stats.passes[p].changes += changes;
+        if (changes == 0) continue;
+
+        for (int q = 0; q < kNumPasses; ++q)
+            if (q != p && !queued[q]) { queued[q] = true; wl.push_back(q); }
+    }
 }
 
-// ─────────────────────────────────────────────────────────────────────────────
-// Public entry point — runs all 7 passes in order
-// ─────────────────────────────────────────────────────────────────────────────
-
-IRProgram runOptimizationPasses(IRProgram prog) {
-    // ── Flat-list passes (Phase 3A) ──────────────────────────────────────────
-    applyPass(prog, constantPropagation);
-    applyPass(prog, deadCodeElimination);
-    applyPass(prog, copyPropagation);
-    applyPass(prog, deadStoreElimination);
-    applyPass(prog, commonSubexprElim);
-    applyPass(prog, strengthReduction);
-    applyPass(prog, loopInvariantCodeMotion);
-
-    // ── CFG-based passes (Phase 3B / 3C) ────────────────────────────────────
-    // Global Value Numbering via SSA: eliminates cross-block redundant exprs.
-    applyPass(prog, gvnPass);
-
-    // Liveness-based dead store elimination (global, cross-block).
-    applyPass(prog, livenessDSE);
-
-    // Second round of flat passes to clean up copies inserted by livenessDSE
-    // and any opportunities exposed by the global analysis.
-    applyPass(prog, copyPropagation);
-    applyPass(prog, deadStoreElimination);
+IRProgram runOptimizationPasses(IRProgram prog, OptStats* stats) {
+    OptStats local;
+    OptStats& st = stats ? *stats : local;
+    st.passes.clear();
+    for (const PassInfo& p : kPasses) st.passes.push_back({p.name, 0, 0});
+    st.budgetExhausted = 0;
 
+    optimizeUnit(prog.main, st);
+    for (auto& [key, fn] : prog.functions)
+        optimizeUnit(fn.code, st);
     return prog;
 }
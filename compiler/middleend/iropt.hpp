@@ -1,11 +1,25 @@
 #pragma once
 #include "ir.hpp"
+#include <string>
+#include <vector>
 
-// Run all 7 optimization passes on an IRProgram.
-// Each pass operates on the flat instruction vectors in prog.main
-// and in every function's code vector — never inside the IR generator.
+// Per-pass counters collected by runOptimizationPasses.
+struct OptStats {
+    struct Pass {
+        std::string name;
+        int runs    = 0;   // times the pass ran, over all code units
+        int changes = 0;   // rewrites it reported (folds, removals, hoists…)
+    };
+    std::vector<Pass> passes;       // in pipeline order
+    int budgetExhausted = 0;        // code units that hit the pass budget
+};
+
+// Optimize an IRProgram with the legacy IR passes, iterated to a fixed point.
+// Each pass rewrites the flat instruction vectors in prog.main and in every
+// function's code vector in place — never inside the IR generator.
 //
-// Pipeline: constantPropagation → deadCodeElimination → copyPropagation
-//         → deadStoreElimination → commonSubexprElim → strengthReduction
-//         → loopInvariantCodeMotion
-IRProgram runOptimizationPasses(IRProgram prog);
+// Pipeline (initial order; passes re-run when another pass changes the code):
+//   constantPropagation → deadCodeElimination → copyPropagation
+//   → deadStoreElimination → commonSubexprElim → strengthReduction
+//   → loopInvariantCodeMotion → gvnPass → livenessDSE
+IRProgram runOptimizationPasses(IRProgram prog, OptStats* stats = nullptr);
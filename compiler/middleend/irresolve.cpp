@@ -0,0 +1,301 @@
+#include "irresolve.hpp"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Flattened (type, name) field list, base class first; a redeclared field
+// keeps its base-class position.  Same order as IRVM::collectAllFields, so
+// a method's field i is field i of every subclass instance too.
+static void collectAllFields(const IRProgram& prog, const std::string& cls,
+                             std::vector<std::pair<std::string,std::string>>& out) {
+    auto it = prog.classes.find(cls);
+    if (it == prog.classes.end()) return;
+    if (!it->second.baseClass.empty())
+        collectAllFields(prog, it->second.baseClass, out);
+    for (auto& f : it->second.fields) {
+        auto fi = std::find_if(out.begin(), out.end(),
+                               [&](const auto& x){ return x.second == f.second; });
+        if (fi != out.end()) *fi = f; else out.push_back(f);
+    }
+}
+
+namespace {
+
+struct SlotResolver {
+    std::vector<std::unordered_map<std::string, int>> scopes{1};
+    int numSlots = 0;
+
+    int newSlot(const std::string& name, size_t scope) {
+        return scopes[scope][name] = numSlots++;
+    }
+
+    int find(const std::string& name) const {
+        for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
+            auto f = it->find(name);
+            if (f != it->end()) return f->second;
+        }
+        return -1;
+    }
+
+    // Bind in the outermost scope, reusing an existing binding of that name.
+    int bindOuter(const std::string& name) {
+        auto f = scopes[0].find(name);
+        return f != scopes[0].end() ? f->second : newSlot(name, 0);
+    }
+
+    std::vector<IRInstr> run(const std::vector<IRInstr>& code) {
+        std::vector<IRInstr> out;
+        out.reserve(code.size());
+        for (const IRInstr& ins : code) {
+            switch (ins.op) {
+            case IROp::ENTER_SCOPE:
+                scopes.emplace_back();
+                break;
+            case IROp::EXIT_SCOPE:
+                if (scopes.size() > 1) scopes.pop_back();
+                break;
+            case IROp::DECLARE: {
+                auto f = scopes.back().find(ins.sval);
+                int slot = f != scopes.back().end() ? f->second
+                                                    : newSlot(ins.sval, scopes.size() - 1);
+                out.push_back({IROp::STORE_SLOT, ins.sval, slot});
+                break;
+            }
+            case IROp::STORE: {
+                int slot = find(ins.sval);
+                if (slot < 0) slot = newSlot(ins.sval, 0);
+                out.push_back({IROp::STORE_SLOT, ins.sval, slot});
+                break;
+            }
+            case IROp::LOAD: {
+                int slot = find(ins.sval);
+                if (slot < 0) out.push_back(ins);
+                else          out.push_back({IROp::LOAD_SLOT, ins.sval, slot});
+                break;
+            }
+            default:
+                out.push_back(ins);
+            }
+        }
+        return out;
+    }
+};
+
+} // namespace
+
+void resolveSlots(IRProgram& prog) {
+    if (prog.slotsResolved) return;
+
+    for (auto& [key, fn] : prog.functions) {
+        SlotResolver r;
+        // Fields first, then parameters: a parameter named like a field
+        // shares its slot and shadows it, as in the old scope map.
+        fn.fieldSlots.clear();
+        fn.paramSlots.clear();
+        if (!fn.className.empty()) {
+            std::vector<std::pair<std::string,std::string>> fields;
+            collectAllFields(prog, fn.className, fields);
+            for (auto& f : fields) fn.fieldSlots.push_back(r.bindOuter(f.second));
+        }
+        for (auto& p : fn.params) fn.paramSlots.push_back(r.bindOuter(p.second));
+        fn.code     = r.run(fn.code);
+        fn.numSlots = r.numSlots;
+    }
+
+    SlotResolver r;
+    prog.main      = r.run(prog.main);
+    prog.mainSlots = r.numSlots;
+
+    prog.slotsResolved = true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Superinstructions
+// ─────────────────────────────────────────────────────────────────────────────
+
+static bool isJump(IROp op) {
+    switch (op) {
+    case IROp::JUMP:
+    case IROp::JUMP_FALSE:
+    case IROp::CMP_LT_JUMP_FALSE:
+    case IROp::CMP_GT_JUMP_FALSE:
+    case IROp::CMP_EQ_JUMP_FALSE:
+    case IROp::CMP_NEQ_JUMP_FALSE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static IROp fusedCompareJump(IROp cmp) {
+    switch (cmp) {
+    case IROp::CMP_LT:  return IROp::CMP_LT_JUMP_FALSE;
+    case IROp::CMP_GT:  return IROp::CMP_GT_JUMP_FALSE;
+    case IROp::CMP_EQ:  return IROp::CMP_EQ_JUMP_FALSE;
+    case IROp::CMP_NEQ: return IROp::CMP_NEQ_JUMP_FALSE;
+    default:            return IROp::NOP;
+    }
+}
+
+// LOAD_SLOT x; PUSH_INT k; ADD|SUB; STORE_SLOT x at code[i]?
+static bool isIncrement(const std::vector<IRInstr>& code, size_t i) {
+    return i + 3 < code.size() &&
+           code[i].op   == IROp::LOAD_SLOT &&
+           code[i+1].op == IROp::PUSH_INT &&
+           (code[i+2].op == IROp::ADD || code[i+2].op == IROp::SUB) &&
+           code[i+3].op == IROp::STORE_SLOT && code[i+3].ival == code[i].ival;
+}
+
+static std::vector<IRInstr> fuseCode(const std::vector<IRInstr>& code) {
+    std::vector<IRInstr> out;
+    out.reserve(code.size());
+    size_t i = 0;
+    while (i < code.size()) {
+        const IRInstr& a = code[i];
+        if (isIncrement(code, i)) {
+            IRInstr f{IROp::INC_SLOT, a.sval, a.ival};
+            // Negate in unsigned: k == INT_MIN wraps to itself, which is
+            // what x - INT_MIN is in two's complement anyway.
+            int k = code[i+1].ival;
+            f.aux = code[i+2].op == IROp::ADD ? k : (int)(0u - (unsigned)k);
+            out.push_back(std::move(f));
+            i += 4;
+            continue;
+        }
+        if (i + 1 < code.size()) {
+            const IRInstr& b = code[i+1];
+            // Leave a LOAD_SLOT that starts an increment for INC_SLOT.
+            bool bFree = !isIncrement(code, i + 1);
+            IRInstr f{IROp::NOP};
+            if (b.op == IROp::JUMP_FALSE && fusedCompareJump(a.op) != IROp::NOP) {
+                f = {fusedCompareJump(a.op), b.sval};
+            } else if (a.op == IROp::PUSH_THIS && b.op == IROp::LOAD_FIELD) {
+                f = {IROp::LOAD_FIELD_THIS, b.sval};
+            } else if (a.op == IROp::LOAD_SLOT && b.op == IROp::LOAD_SLOT && bFree) {
+                f = {IROp::LOAD_SLOT2, a.sval + "," + b.sval, a.ival};
+                f.aux = b.ival;
+            } else if (a.op == IROp::LOAD_SLOT && b.op == IROp::STORE_SLOT) {
+                f = {IROp::MOVE_SLOT, b.sval + "," + a.sval, b.ival};
+                f.aux = a.ival;
+            } else if (a.op == IROp::STORE_SLOT && b.op == IROp::LOAD_SLOT && bFree) {
+                f = {IROp::STORE_LOAD_SLOT, a.sval + "," + b.sval, a.ival};
+                f.aux = b.ival;
+            }
+            if (f.op != IROp::NOP) {
+                out.push_back(std::move(f));
+                i += 2;
+                continue;
+            }
+        }
+        out.push_back(a);
+        ++i;
+    }
+    return out;
+}
+
+void fuseSuperinstructions(IRProgram& prog) {
+    for (auto& [key, fn] : prog.functions) fn.code = fuseCode(fn.code);
+    prog.main = fuseCode(prog.main);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Jumps
+// ─────────────────────────────────────────────────────────────────────────────
+
+static void resolveJumpsIn(std::vector<IRInstr>& code) {
+    // A label resolves to the index its next instruction will have once
+    // the LABELs are gone.
+    std::unordered_map<std::string, int> target;
+    int n = 0;
+    for (const IRInstr& ins : code) {
+        if (ins.op == IROp::LABEL) target[ins.sval] = n;
+        else                       ++n;
+    }
+    std::vector<IRInstr> out;
+    out.reserve(n);
+    for (IRInstr& ins : code) {
+        if (ins.op == IROp::LABEL) continue;
+        if (isJump(ins.op)) {
+            auto it = target.find(ins.sval);
+            ins.ival = it != target.end() ? it->second : -1;
+        }
+        out.push_back(std::move(ins));
+    }
+    code = std::move(out);
+}
+
+void resolveJumps(IRProgram& prog) {
+    if (prog.jumpsResolved) return;
+    for (auto& [key, fn] : prog.functions) resolveJumpsIn(fn.code);
+    resolveJumpsIn(prog.main);
+    prog.jumpsResolved = true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Field indices
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Stores field index + 1 in aux, so IRVM indexes obj->fields directly.
+// LOAD_FIELD_THIS in a method of C reads C's field, which keeps its index
+// in every subclass.  Other accesses resolve when every class with that
+// field name keeps it at the same index; the rest stay 0 (lookup by name).
+static void resolveFields(IRProgram& prog) {
+    std::unordered_map<std::string, std::vector<std::string>> names;   // per class
+    std::unordered_map<std::string, int> common;   // field → index, -1 if it varies
+    for (auto& [cls, ci] : prog.classes) {
+        std::vector<std::pair<std::string,std::string>> fields;
+        collectAllFields(prog, cls, fields);
+        auto& list = names[cls];
+        for (int i = 0; i < (int)fields.size(); ++i) {
+            list.push_back(fields[i].second);
+            auto [it, added] = common.emplace(fields[i].second, i);
+            if (!added && it->second != i) it->second = -1;
+        }
+    }
+    auto resolveIn = [&](std::vector<IRInstr>& code, const std::string& cls) {
+        auto own = names.find(cls);
+        for (IRInstr& ins : code) {
+            if (ins.op != IROp::LOAD_FIELD && ins.op != IROp::STORE_FIELD &&
+                ins.op != IROp::LOAD_FIELD_THIS)
+                continue;
+            int idx = -1;
+            if (ins.op == IROp::LOAD_FIELD_THIS && own != names.end()) {
+                auto f = std::find(own->second.begin(), own->second.end(), ins.sval);
+                if (f != own->second.end()) idx = (int)(f - own->second.begin());
+            } else {
+                auto c = common.find(ins.sval);
+                if (c != common.end()) idx = c->second;
+            }
+            ins.aux = idx + 1;
+        }
+    };
+    for (auto& [key, fn] : prog.functions) resolveIn(fn.code, fn.className);
+    resolveIn(prog.main, "");
+}
+
+// Give every instruction string a pool index.  Already-interned
+// instructions (sidx >= 0) are left alone, so this is idempotent.
+static void internStrings(IRProgram& prog) {
+    std::unordered_map<std::string, int> index;
+    for (int i = 0; i < (int)prog.strings.size(); ++i) index.emplace(prog.strings[i], i);
+    auto internCode = [&](std::vector<IRInstr>& code) {
+        for (IRInstr& ins : code) {
+            if (ins.sidx >= 0) continue;
+            if (ins.sval.empty() && ins.op != IROp::PUSH_STR) continue;
+            auto [it, added] = index.emplace(ins.sval, (int)prog.strings.size());
+            if (added) prog.strings.push_back(ins.sval);
+            ins.sidx = it->second;
+        }
+    };
+    for (auto& [key, fn] : prog.functions) internCode(fn.code);
+    internCode(prog.main);
+}
+
+void resolveForVM(IRProgram& prog) {
+    resolveSlots(prog);
+    if (!prog.jumpsResolved) fuseSuperinstructions(prog);
+    resolveJumps(prog);
+    resolveFields(prog);
+    internStrings(prog);
+}
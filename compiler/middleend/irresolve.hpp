@@ -0,0 +1,58 @@
+#pragma once
+#include "ir.hpp"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Pre-execution resolution for the legacy IRVM.
+//
+// resolveForVM runs resolveSlots, fuseSuperinstructions and resolveJumps,
+// records field indices in the field ops' aux where they are known
+// statically, then interns every instruction string into prog.strings (IRInstr::sidx);
+// IRVM::run requires all of them.  The result is for execution only — the CFG and optimization passes
+// expect named variables and LABELs.
+// ─────────────────────────────────────────────────────────────────────────────
+void resolveForVM(IRProgram& prog);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Slot resolution.
+//
+// Runs after runOptimizationPasses (and after readBytecode) and before
+// execution.  Every variable in a function — parameters, fields-as-locals,
+// declared locals and SSA-renamed temporaries (x$N) — gets a fixed frame slot:
+//
+//   DECLARE x / STORE x  →  STORE_SLOT   (ival = slot)
+//   LOAD x               →  LOAD_SLOT    (ival = slot)
+//   ENTER_SCOPE / EXIT_SCOPE are removed.
+//
+// Scopes are resolved statically, mirroring VMFrame's old dynamic rules:
+// DECLARE binds in the innermost scope (shadowing outer bindings), STORE
+// updates the nearest binding or falls back to the outermost scope, LOAD
+// reads the nearest binding.  A LOAD with no binding is left as LOAD and
+// fails at runtime with "Undefined variable", as before.
+//
+// Idempotent: does nothing if prog.slotsResolved is already set.
+// ─────────────────────────────────────────────────────────────────────────────
+void resolveSlots(IRProgram& prog);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Superinstruction peephole over slot-resolved, still label-based code (a
+// LABEL between two instructions keeps them apart, so no fused instruction
+// spans a jump target).  Chosen from the dynamic op-pair profile of the
+// examples and integration tests:
+//
+//   LOAD_SLOT x; PUSH_INT k; ADD|SUB; STORE_SLOT x  →  INC_SLOT x, ±k
+//   CMP_LT|GT|EQ|NEQ; JUMP_FALSE L                  →  CMP_xx_JUMP_FALSE L
+//   PUSH_THIS; LOAD_FIELD f                         →  LOAD_FIELD_THIS f
+//   LOAD_SLOT a; LOAD_SLOT b                        →  LOAD_SLOT2 a, b
+//   LOAD_SLOT a; STORE_SLOT b                       →  MOVE_SLOT b, a
+//   STORE_SLOT a; LOAD_SLOT b                       →  STORE_LOAD_SLOT a, b
+//
+// Must run before resolveJumps; resolveForVM does both in order.
+// ─────────────────────────────────────────────────────────────────────────────
+void fuseSuperinstructions(IRProgram& prog);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Jump resolution: removes every LABEL and stores each JUMP / JUMP_FALSE /
+// CMP_xx_JUMP_FALSE target as an instruction index in ival (-1 for an undefined label, which
+// IRVM reports if the jump is taken).  Idempotent via prog.jumpsResolved.
+// ─────────────────────────────────────────────────────────────────────────────
+void resolveJumps(IRProgram& prog);
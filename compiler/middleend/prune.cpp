@@ -0,0 +1,178 @@
+#include "prune.hpp"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Reachability state shared by both IR flavours.  Functions are keyed as in
+// the program maps: "name" for free functions, "Class::method" for methods.
+struct Reach {
+    std::unordered_set<std::string> funcKeys;                        // all functions
+    std::unordered_map<std::string, std::string> baseOf;            // class → base
+    std::unordered_map<std::string, std::vector<std::string>> fieldClassesOf;
+    std::unordered_map<std::string,
+        std::vector<std::pair<std::string, std::string>>> methodsOf; // class → (method, key)
+
+    std::unordered_set<std::string> liveFuncs, liveClasses, calledMethods;
+    std::vector<std::string> work;   // live function keys not yet scanned
+
+    void func(const std::string& key) {
+        if (funcKeys.count(key) && liveFuncs.insert(key).second) work.push_back(key);
+    }
+
+    // Marks a class and its bases; names that are not classes are ignored.
+    void cls(const std::string& name) {
+        std::string cur = name;
+        while (baseOf.count(cur) && liveClasses.insert(cur).second) {
+            for (auto& [m, key] : methodsOf[cur])
+                if (calledMethods.count(m)) func(key);
+            for (const std::string& f : fieldClassesOf[cur]) cls(f);
+            cur = baseOf[cur];
+        }
+    }
+
+    void method(const std::string& m) {
+        if (!calledMethods.insert(m).second) return;
+        for (const std::string& c : liveClasses)
+            for (auto& [mm, key] : methodsOf[c])
+                if (mm == m) func(key);
+    }
+
+    // Constructors are looked up as "init" or by the class name.
+    void newObject(const std::string& c) {
+        cls(c);
+        method("init");
+        method(c);
+    }
+};
+
+// Erases every entry whose key is not in keep.
+template <class Map>
+int eraseUnlisted(Map& m, const std::unordered_set<std::string>& keep) {
+    int removed = 0;
+    for (auto it = m.begin(); it != m.end(); ) {
+        if (keep.count(it->first)) { ++it; continue; }
+        it = m.erase(it);
+        ++removed;
+    }
+    return removed;
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TIR
+// ─────────────────────────────────────────────────────────────────────────────
+
+static void markType(Reach& r, const TIR::Type& t) {
+    if ((t.isObj() || t.isArr()) && !t.name.empty()) r.cls(t.name);
+}
+
+static void scanFunc(Reach& r, const TIR::Func& fn) {
+    if (!fn.className.empty()) r.cls(fn.className);
+    markType(r, fn.retType);
+    for (auto& [ty, name] : fn.params) markType(r, ty);
+
+    for (const TIR::Block& bb : fn.blocks) {
+        for (const TIR::Instr& ins : bb.instrs) {
+            markType(r, ins.type);
+            for (const TIR::Val& a : ins.args) markType(r, a.type);
+            switch (ins.op) {
+            case TIR::Op::Call:
+                r.func(ins.name);
+                break;
+            case TIR::Op::NewObj:
+                r.newObject(ins.name);
+                break;
+            case TIR::Op::CallMethod:
+            case TIR::Op::CallSuper:
+                r.method(ins.name);
+                r.cls(ins.name2);    // statically bound target (LLVM backend)
+                break;
+            case TIR::Op::NewArray:
+                r.cls(ins.name);
+                r.cls(ins.name2);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+void pruneUnreachable(TIR::Program& prog) {
+    Reach r;
+    for (auto& [key, fn] : prog.funcs) {
+        r.funcKeys.insert(key);
+        if (!fn.className.empty()) r.methodsOf[fn.className].push_back({fn.name, key});
+    }
+    for (auto& [name, c] : prog.classes) {
+        r.baseOf[name] = c.baseClass;
+        for (auto& [ty, f] : c.fields)
+            if (ty.isObj() || ty.isArr()) r.fieldClassesOf[name].push_back(ty.name);
+    }
+
+    scanFunc(r, prog.globalInit);
+    while (!r.work.empty()) {
+        std::string key = std::move(r.work.back());
+        r.work.pop_back();
+        scanFunc(r, prog.funcs.at(key));
+    }
+
+    eraseUnlisted(prog.funcs, r.liveFuncs);
+    eraseUnlisted(prog.classes, r.liveClasses);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Legacy IR
+// ─────────────────────────────────────────────────────────────────────────────
+
+static void scanCode(Reach& r, const std::vector<IRInstr>& code) {
+    for (const IRInstr& ins : code) {
+        switch (ins.op) {
+        case IROp::CALL:
+            r.func(ins.sval);
+            break;
+        case IROp::NEW_OBJ:
+            r.newObject(ins.sval);
+            break;
+        case IROp::CALL_METHOD:
+        case IROp::CALL_SUPER:
+            r.method(ins.sval);
+            break;
+        case IROp::NEW_ARRAY:
+            r.cls(ins.sval);       // object arrays are filled with instances
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void pruneUnreachable(IRProgram& prog) {
+    Reach r;
+    for (auto& [key, fn] : prog.functions) {
+        r.funcKeys.insert(key);
+        if (!fn.className.empty()) r.methodsOf[fn.className].push_back({fn.name, key});
+    }
+    for (auto& [name, c] : prog.classes) {
+        r.baseOf[name] = c.baseClass;
+        for (auto& [ty, f] : c.fields) r.fieldClassesOf[name].push_back(ty);
+    }
+
+    scanCode(r, prog.main);
+    while (!r.work.empty()) {
+        std::string key = std::move(r.work.back());
+        r.work.pop_back();
+        const IRFunction& fn = prog.functions.at(key);
+        if (!fn.className.empty()) r.cls(fn.className);
+        for (auto& [ty, name] : fn.params) r.cls(ty);
+        scanCode(r, fn.code);
+    }
+
+    eraseUnlisted(prog.functions, r.liveFuncs);
+    eraseUnlisted(prog.classes, r.liveClasses);
+}
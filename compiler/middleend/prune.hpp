@@ -0,0 +1,29 @@
+#pragma once
+#include "ir.hpp"
+#include "tir.hpp"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Whole-program dead function and dead class elimination.
+//
+// processImports splices every statement of every imported file into the
+// program, so a file that uses two functions of stdlib/String.tl would
+// otherwise lower, optimize and emit all of them.  pruneUnreachable keeps
+// only what is reachable from the top-level code (TIR globalInit / legacy
+// main):
+//
+//   • free functions named by a Call
+//   • classes that are instantiated (NewObj), used as an element, field,
+//     parameter or value type, or own a reachable method — plus their bases
+//   • a method C::m when C is live and m is called anywhere (CallMethod or
+//     CallSuper); constructors count as called once any object is created
+//
+// Method calls are matched by name against every live class, so dynamic
+// dispatch stays correct without type information: an override survives
+// whenever its class is live and its name is called, whatever the static
+// type of the receiver.
+//
+// Run it right after generateTIR / generateIR, before optimization and
+// emission.
+// ─────────────────────────────────────────────────────────────────────────────
+void pruneUnreachable(TIR::Program& prog);
+void pruneUnreachable(IRProgram& prog);
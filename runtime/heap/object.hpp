@@ -1,8 +1,11 @@
 #pragma once
 #include "tir.hpp"
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
+#include <sys/mman.h>
 
 // ---------------------------------------------------------------------------
 // Production object model (Phase 4.3 + 4.4 GC).
@@ -10,6 +13,8 @@
 //   • Objects are TLObject*  — raw pointer into TLHeap.
 //   • Arrays  are TLArray*   — same.
 //   • Values  are TLValue    — typed 8-byte word (tag + payload union).
+//   • Mapped files are TLMapping*; slices of them are TLStrView* (zero-copy
+//     strings — see __tl_file_map).
 //
 // GC word layout (per ABI doc, abi.md §4.2):
 //   bit 0  — mark bit  (set during mark phase, cleared during sweep)
@@ -23,11 +28,12 @@ static constexpr uint64_t GC_PINNED_BIT = 1ULL << 1;
 
 struct TLObject;
 struct TLArray;
+struct TLStrView;
 
 // ─── Runtime value ────────────────────────────────────────────────────────────
 
 struct TLValue {
-    enum class Tag : uint8_t { Nil, Bool, I32, F64, Char, Str, Obj, Arr } tag = Tag::Nil;
+    enum class Tag : uint8_t { Nil, Bool, I32, F64, Char, Str, Obj, Arr, StrView } tag = Tag::Nil;
 
     union Payload {
         int32_t   i;   // I32 and Bool (stored as 0/1)
@@ -35,6 +41,7 @@ struct TLValue {
         char      c;   // Char
         TLObject* obj; // Obj
         TLArray*  arr; // Arr
+        TLStrView* view; // StrView
         Payload() : i(0) {}
     } p;
 
@@ -47,15 +54,20 @@ struct TLValue {
     static TLValue fromFloat(double v)            { TLValue r; r.tag=Tag::F64;  r.p.d=v;   return r; }
     static TLValue fromChar(char v)               { TLValue r; r.tag=Tag::Char; r.p.c=v;   return r; }
     static TLValue fromStr(const std::string& v)  { TLValue r; r.tag=Tag::Str;  r.sval=v;  return r; }
+    static TLValue fromStr(std::string&& v)       { TLValue r; r.tag=Tag::Str;  r.sval=std::move(v); return r; }
     static TLValue fromObj(TLObject* v)           { TLValue r; r.tag=Tag::Obj;  r.p.obj=v; return r; }
     static TLValue fromArr(TLArray* v)            { TLValue r; r.tag=Tag::Arr;  r.p.arr=v; return r; }
+    static TLValue fromView(TLStrView* v)         { TLValue r; r.tag=Tag::StrView; r.p.view=v; return r; }
 
     bool isNil()   const { return tag == Tag::Nil; }
     bool isFloat() const { return tag == Tag::F64; }
-    bool isStr()   const { return tag == Tag::Str; }
+    // True for both owned strings and views; read either through str().
+    bool isStr()   const { return tag == Tag::Str || tag == Tag::StrView; }
     bool isObj()   const { return tag == Tag::Obj; }
     bool isArr()   const { return tag == Tag::Arr; }
 
+    inline std::string_view str() const;
+
     bool isTruthy() const {
         switch (tag) {
         case Tag::Nil:          return false;
@@ -66,29 +78,73 @@ struct TLValue {
         case Tag::Str:          return !sval.empty();
         case Tag::Obj:          return p.obj != nullptr;
         case Tag::Arr:          return p.arr != nullptr;
+        case Tag::StrView:      return !str().empty();
         }
         return false;
     }
 };
 
+// ─── Mapped file / string view ───────────────────────────────────────────────
+// TLMapping owns a read-only mmap of a file; it is unmapped when the GC frees
+// it.  TLStrView is an immutable slice of a mapping: substring operations on
+// a view allocate a new TLStrView over the same bytes instead of copying.
+
+struct TLMapping {
+    uint64_t    gcWord = 0;
+    const char* data   = nullptr;
+    size_t      size   = 0;
+
+    ~TLMapping() {
+        if (data && size) munmap(const_cast<char*>(data), size);
+    }
+};
+
+struct TLStrView {
+    uint64_t   gcWord = 0;
+    TLMapping* base   = nullptr;
+    size_t     off    = 0;
+    size_t     len    = 0;
+
+    std::string_view text() const {
+        return len ? std::string_view(base->data + off, len) : std::string_view();
+    }
+};
+
+inline std::string_view TLValue::str() const {
+    if (tag == Tag::StrView) return p.view->text();
+    return sval;
+}
+
+// ─── Field layout ─────────────────────────────────────────────────────────────
+// defs[i] is the (type, name) of field i, inherited fields first (base first,
+// derived last), matching the order produced by TIRVM::collectAllFields().
+// Engines build one layout per class and share it between its instances.
+
+struct TLLayout {
+    std::vector<std::pair<TIR::Type, std::string>> defs;
+    std::vector<int> nameIds;   // IRVM only: IRProgram::strings index of each name
+
+    // Name → field index (-1 if not found).
+    int indexOf(const std::string& name) const {
+        for (int i = 0; i < (int)defs.size(); ++i)
+            if (defs[i].second == name) return i;
+        return -1;
+    }
+};
+
 // ─── Heap object ──────────────────────────────────────────────────────────────
-// Fields are stored in a contiguous vector indexed by declaration order.
-// fieldDefs[i] is the (type, name) of fields[i].
-// Both include inherited fields (base first, derived last), matching the
-// order produced by TIRVM::collectAllFields().
+// Fields are stored in a contiguous vector indexed by layout order.
 
 struct TLObject {
     uint64_t    gcWord    = 0;        // GC mark / pin / tag / refcount (reserved)
     std::string className;            // runtime class name (vtable placeholder)
 
-    std::vector<std::pair<TIR::Type, std::string>> fieldDefs; // (type, name) in order
-    std::vector<TLValue>                            fields;   // parallel values
+    std::shared_ptr<const TLLayout> layout;   // the class's, shared
+    std::vector<TLValue>            fields;   // parallel to layout->defs
 
     // Name → field index (-1 if not found).
     int fieldIndex(const std::string& name) const {
-        for (int i = 0; i < (int)fieldDefs.size(); ++i)
-            if (fieldDefs[i].second == name) return i;
-        return -1;
+        return layout ? layout->indexOf(name) : -1;
     }
 
     TLValue getField(const std::string& name) const {
@@ -104,10 +160,20 @@ struct TLObject {
 
 // ─── Heap array ───────────────────────────────────────────────────────────────
 
+// Side data of the native collections ("map", "set", "deque", "ring", "pq" —
+// see natives.cpp).  Their keys and values live in the array's elements; this
+// holds only positions and counts, so marking elements is all the GC needs.
+struct TLCollIndex {
+    std::vector<int32_t> slots;      // map/set: hash slots → entry, -1 = empty
+    size_t               head  = 0;  // deque/ring: position of the front
+    size_t               count = 0;  // deque/ring: live elements
+};
+
 struct TLArray {
     uint64_t             gcWord   = 0;
     std::string          elemType;
     std::vector<TLValue> elements;
+    std::unique_ptr<TLCollIndex> index;   // native collections only
 };
 
 // ─── Heap allocator + mark-and-sweep GC ─────────────────────────────────────
@@ -139,17 +205,40 @@ public:
         return arr;
     }
 
+    // Takes ownership of an mmap'd region (data may be null when size == 0).
+    TLMapping* allocMapping(const char* data, size_t size) {
+        auto* m = new TLMapping;
+        m->data = data;
+        m->size = size;
+        mappings_.push_back(m);
+        ++allocsSinceGC_;
+        return m;
+    }
+
+    TLStrView* allocView(TLMapping* base, size_t off, size_t len) {
+        auto* v = new TLStrView;
+        v->base = base;
+        v->off  = off;
+        v->len  = len;
+        views_.push_back(v);
+        ++allocsSinceGC_;
+        return v;
+    }
+
     // ── GC threshold ──────────────────────────────────────────────────────
     static constexpr size_t GC_THRESHOLD = 256;
     bool shouldCollect() const {
         return allocsSinceGC_ >= GC_THRESHOLD;
     }
-    size_t objectCount() const { return objects_.size() + arrays_.size(); }
+    size_t objectCount() const {
+        return objects_.size() + arrays_.size() + mappings_.size() + views_.size();
+    }
 
     // ── Mark phase (called by TIRVM for each root) ────────────────────────
     void markValue(const TLValue& v) {
         if      (v.isObj()) markObject(v.p.obj);
         else if (v.isArr()) markArray(v.p.arr);
+        else if (v.tag == TLValue::Tag::StrView) markView(v.p.view);
     }
 
     void markObject(TLObject* obj) {
@@ -164,38 +253,18 @@ public:
         for (auto& ev : arr->elements) markValue(ev);
     }
 
+    void markView(TLStrView* v) {
+        if (!v) return;
+        v->gcWord       |= GC_MARK_BIT;
+        v->base->gcWord |= GC_MARK_BIT;
+    }
+
     // ── Sweep phase ───────────────────────────────────────────────────────
     // Deletes unmarked objects, clears marks on survivors.
     // Returns count of freed objects (for stats / testing).
     size_t sweep() {
-        size_t freed = 0;
-
-        auto oit = objects_.begin();
-        while (oit != objects_.end()) {
-            TLObject* obj = *oit;
-            if ((obj->gcWord & GC_MARK_BIT) || (obj->gcWord & GC_PINNED_BIT)) {
-                obj->gcWord &= ~GC_MARK_BIT;  // clear for next cycle
-                ++oit;
-            } else {
-                delete obj;
-                oit = objects_.erase(oit);
-                ++freed;
-            }
-        }
-
-        auto ait = arrays_.begin();
-        while (ait != arrays_.end()) {
-            TLArray* arr = *ait;
-            if ((arr->gcWord & GC_MARK_BIT) || (arr->gcWord & GC_PINNED_BIT)) {
-                arr->gcWord &= ~GC_MARK_BIT;
-                ++ait;
-            } else {
-                delete arr;
-                ait = arrays_.erase(ait);
-                ++freed;
-            }
-        }
-
+        size_t freed = sweepList(objects_) + sweepList(arrays_)
+                     + sweepList(views_)   + sweepList(mappings_);
         allocsSinceGC_ = 0;
         totalCollected_ += freed;
         ++gcCycles_;
@@ -209,12 +278,34 @@ public:
     ~TLHeap() {
         for (auto* p : objects_) delete p;
         for (auto* p : arrays_)  delete p;
+        for (auto* p : views_)    delete p;
+        for (auto* p : mappings_) delete p;
     }
 
 private:
     std::vector<TLObject*> objects_;
     std::vector<TLArray*>  arrays_;
+    std::vector<TLMapping*> mappings_;
+    std::vector<TLStrView*> views_;
     size_t allocsSinceGC_  = 0;
     size_t gcCycles_        = 0;
     size_t totalCollected_  = 0;
+
+    template <typename T>
+    static size_t sweepList(std::vector<T*>& list) {
+        size_t freed = 0;
+        auto it = list.begin();
+        while (it != list.end()) {
+            T* p = *it;
+            if ((p->gcWord & GC_MARK_BIT) || (p->gcWord & GC_PINNED_BIT)) {
+                p->gcWord &= ~GC_MARK_BIT;  // clear for next cycle
+                ++it;
+            } else {
+                delete p;
+                it = list.erase(it);
+                ++freed;
+            }
+        }
+        return freed;
+    }
 };
@@ -1,39 +1,211 @@
 /* TinyLang native runtime — linked with every compiled TinyLang program.
  *
- * Compile with:  clang -c tinyrt.c -o tinyrt.o
- * Then link  :  clang program.ll tinyrt.o -o program
+ * Compile with:  clang -O2 -fno-math-errno -c tinyrt.c -o tinyrt.o
+ * Then link  :  clang program.ll tinyrt.o -lpthread -lm -o program
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <ctype.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <dirent.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+
+/* ── Output buffer ──────────────────────────────────────────────────────── */
+/*
+ * Mirrors the interpreters' OutBuf (runtime/vm/outbuf.hpp): values are
+ * formatted straight into a 64 KiB buffer and written with write(2), bypassing
+ * stdio.  The buffer is flushed when full, on newline when stdout is a
+ * terminal, before reading stdin, and at exit.  Formatting is byte-identical
+ * to the interpreters.
+ */
+
+#define TL_OUT_CAP (64 * 1024)
+
+static char   tl_out_buf[TL_OUT_CAP];
+static size_t tl_out_len;
+static int    tl_out_tty = -1;       /* -1 until the first write */
+
+static void tl_out_write_all(const char* p, size_t n) {
+    while (n > 0) {
+        ssize_t w = write(STDOUT_FILENO, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+}
+
+static void tl_out_flush(void) {
+    tl_out_write_all(tl_out_buf, tl_out_len);
+    tl_out_len = 0;
+}
+
+static void tl_out_init(void) {
+    tl_out_tty = isatty(STDOUT_FILENO);
+    fflush(stdout);                  /* anything already written via stdio */
+    atexit(tl_out_flush);
+}
+
+static void tl_out_reserve(size_t n) {
+    if (tl_out_tty < 0) tl_out_init();
+    if (tl_out_len + n > TL_OUT_CAP) tl_out_flush();
+}
+
+static void tl_out_str(const char* s) {
+    size_t n = strlen(s);
+    tl_out_reserve(n);
+    if (n > TL_OUT_CAP) { tl_out_write_all(s, n); return; }
+    memcpy(tl_out_buf + tl_out_len, s, n);
+    tl_out_len += n;
+}
+
+static void tl_out_i64(long long v) {
+    char tmp[24];
+    int  i = 24;
+    unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    do { tmp[--i] = (char)('0' + u % 10); u /= 10; } while (u);
+    if (v < 0) tmp[--i] = '-';
+    tl_out_reserve((size_t)(24 - i));
+    memcpy(tl_out_buf + tl_out_len, tmp + i, (size_t)(24 - i));
+    tl_out_len += (size_t)(24 - i);
+}
+
+static void tl_out_newline(void) {
+    tl_out_reserve(1);
+    tl_out_buf[tl_out_len++] = '\n';
+    if (tl_out_tty) tl_out_flush();
+}
 
 /* ── Print ─────────────────────────────────────────────────────────────── */
 
-void __tl_print_i32(int32_t v) { printf("%d\n", v); }
+void __tl_print_i32(int32_t v) { tl_out_i64(v); tl_out_newline(); }
 
 void __tl_print_f64(double v) {
     /* Match TIRVM output: integer-valued floats print without decimal point */
-    long long iv = (long long)v;
-    if ((double)iv == v && v >= -1e15 && v <= 1e15)
-        printf("%lld\n", iv);
-    else
-        printf("%g\n", v);
+    if (v >= -1e15 && v <= 1e15 && (double)(long long)v == v) {
+        tl_out_i64((long long)v);
+    } else {
+        char tmp[32];
+        snprintf(tmp, sizeof(tmp), "%g", v);
+        tl_out_str(tmp);
+    }
+    tl_out_newline();
 }
 
-void __tl_print_bool(int32_t v) { printf("%s\n", v ? "true" : "false"); }
-void __tl_print_char(int32_t v) { printf("%c\n", (char)v); }
-void __tl_print_str(char* v)    { printf("%s\n", v ? v : ""); }
+void __tl_print_bool(int32_t v) { tl_out_str(v ? "true" : "false"); tl_out_newline(); }
+
+void __tl_print_char(int32_t v) {
+    tl_out_reserve(1);
+    tl_out_buf[tl_out_len++] = (char)v;
+    tl_out_newline();
+}
+
+void __tl_print_str(char* v) { tl_out_str(v ? v : ""); tl_out_newline(); }
 
 /* ── Input ──────────────────────────────────────────────────────────────── */
+/*
+ * Mirrors the interpreters' InBuf (runtime/vm/inbuf.hpp): stdin is read in
+ * 64 KiB blocks and integers are parsed in place, so bulk ingestion costs one
+ * read(2) per block rather than one scanf per token.  Every stdin builtin
+ * shares this buffer.
+ */
+
+#define TL_IN_CAP (64 * 1024)
+
+static char   tl_in_buf[TL_IN_CAP];
+static size_t tl_in_pos, tl_in_end;
+static int    tl_in_eof;
+
+/* Move unread bytes to the front and append more; 0 if nothing new. */
+static int tl_in_refill(void) {
+    if (tl_in_eof) return 0;
+    tl_out_flush();                  /* prompts must be visible first */
+    if (tl_in_pos > 0) {
+        memmove(tl_in_buf, tl_in_buf + tl_in_pos, tl_in_end - tl_in_pos);
+        tl_in_end -= tl_in_pos;
+        tl_in_pos  = 0;
+    }
+    if (tl_in_end == TL_IN_CAP) return 0;
+    for (;;) {
+        ssize_t n = read(STDIN_FILENO, tl_in_buf + tl_in_end, TL_IN_CAP - tl_in_end);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) { tl_in_eof = 1; return 0; }
+        tl_in_end += (size_t)n;
+        return 1;
+    }
+}
+
+/* Next whitespace-separated integer; 0 at EOF, for a malformed token or one
+ * outside the int32 range. */
+static int32_t tl_in_next_int(void) {
+    for (;;) {
+        while (tl_in_pos < tl_in_end && isspace((unsigned char)tl_in_buf[tl_in_pos]))
+            tl_in_pos++;
+        if (tl_in_pos < tl_in_end) break;
+        if (!tl_in_refill()) return 0;
+    }
+    size_t tok_end = tl_in_pos;
+    for (;;) {
+        while (tok_end < tl_in_end && !isspace((unsigned char)tl_in_buf[tok_end]))
+            tok_end++;
+        if (tok_end < tl_in_end) break;
+        size_t off  = tok_end - tl_in_pos;
+        int    more = tl_in_refill();
+        tok_end = tl_in_pos + off;
+        if (!more) break;
+    }
+    const char* p   = tl_in_buf + tl_in_pos;
+    const char* end = tl_in_buf + tok_end;
+    int neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    /* Out-of-range values read as 0, like InBuf::nextInt's from_chars. */
+    uint64_t v = 0, limit = neg ? 2147483648u : 2147483647u;
+    int digits = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + (uint64_t)(*p++ - '0');
+        digits++;
+        if (v > limit) { tl_in_pos = tok_end; return 0; }
+    }
+    tl_in_pos = tok_end;
+    if (!digits) return 0;
+    return neg ? (int32_t)(0u - (uint32_t)v) : (int32_t)v;
+}
+
+int32_t __tl_input_i32(void) { return tl_in_next_int(); }
 
-int32_t __tl_input_i32(void) {
-    int32_t v = 0;
-    scanf("%d", &v);
-    return v;
+char* __tl_read_line(void) {
+    char*  out = NULL;
+    size_t len = 0;
+    for (;;) {
+        if (tl_in_pos == tl_in_end && !tl_in_refill()) break;
+        char*  start = tl_in_buf + tl_in_pos;
+        size_t avail = tl_in_end - tl_in_pos;
+        char*  nl    = (char*)memchr(start, '\n', avail);
+        size_t take  = nl ? (size_t)(nl - start) : avail;
+        char*  nb    = (char*)realloc(out, len + take + 1);
+        if (!nb) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+        out = nb;
+        memcpy(out + len, start, take);
+        len += take;
+        tl_in_pos += take + (nl ? 1 : 0);
+        if (nl) break;
+    }
+    if (!out) return strdup("");
+    if (len > 0 && out[len - 1] == '\r') len--;
+    out[len] = '\0';
+    return out;
 }
 
 /* ── String operations ──────────────────────────────────────────────────── */
@@ -75,6 +247,10 @@ char* __tl_str_sub(char* s, int32_t start, int32_t len) {
     if (start < 0) start = 0;
     if (start >= slen) return strdup("");
     if (len < 0 || start + len > slen) len = slen - start;
+    /* A suffix already ends in the source's NUL: share it (strings are never
+     * freed, so the alias stays valid).  Keeps slices of __tl_file_map
+     * buffers zero-copy when they run to the end. */
+    if (start + len == slen) return s + start;
     char* r = (char*)malloc(len + 1);
     if (!r) return strdup("");
     memcpy(r, s + start, len);
@@ -164,6 +340,136 @@ int32_t __tl_str_char_at(char* s, int32_t i) {
     return (int32_t)(unsigned char)s[i];
 }
 
+/* ── Split / join ───────────────────────────────────────────────────────── */
+/*
+ * Single-byte separators are found with memchr, longer ones with strstr;
+ * each piece is copied once into its own string.
+ */
+
+void* __tl_alloc_arr(int32_t size);
+void* __tl_arr_resize(void* arr, int32_t new_cap);
+void  __tl_store_arr(void* arr, int32_t idx, uint64_t val);
+int32_t  __tl_arr_len(void* arr);
+uint64_t __tl_load_arr(void* arr, int32_t idx);
+
+static void* tl_split(const char* s, const char* sep, size_t seplen, int lines) {
+    if (!s) s = "";
+    size_t len = strlen(s), pos = 0;
+    int32_t n = 0, cap = 16;
+    void* arr = __tl_alloc_arr(cap);
+    for (;;) {
+        const char* hit = NULL;
+        if (seplen == 1)     hit = (const char*)memchr(s + pos, sep[0], len - pos);
+        else if (seplen > 1) hit = (const char*)strstr(s + pos, sep);
+        size_t end = hit ? (size_t)(hit - s) : len;
+        /* split_lines drops the empty piece after a final newline. */
+        if (!hit && lines && pos == len) break;
+        size_t plen = end - pos;
+        if (lines && plen > 0 && s[pos + plen - 1] == '\r') plen--;
+        char* piece = (char*)malloc(plen + 1);
+        if (!piece) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+        memcpy(piece, s + pos, plen);
+        piece[plen] = '\0';
+        if (n == cap) arr = __tl_arr_resize(arr, cap *= 2);
+        __tl_store_arr(arr, n++, (uint64_t)(uintptr_t)piece);
+        if (!hit) break;
+        pos = end + seplen;
+    }
+    return __tl_arr_resize(arr, n);
+}
+
+/* An empty separator leaves the string whole. */
+void* __tl_str_split(char* s, char* sep) {
+    return tl_split(s, sep ? sep : "", sep ? strlen(sep) : 0, 0);
+}
+
+void* __tl_str_split_lines(char* s) {
+    return tl_split(s, "\n", 1, 1);
+}
+
+char* __tl_str_join(void* arr, char* sep) {
+    if (!sep) sep = "";
+    int32_t n = __tl_arr_len(arr);
+    size_t seplen = strlen(sep), total = 0;
+    for (int32_t i = 0; i < n; i++) {
+        const char* e = (const char*)(uintptr_t)__tl_load_arr(arr, i);
+        total += (e ? strlen(e) : 0) + (i > 0 ? seplen : 0);
+    }
+    char* r = (char*)malloc(total + 1);
+    if (!r) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+    char* w = r;
+    for (int32_t i = 0; i < n; i++) {
+        const char* e = (const char*)(uintptr_t)__tl_load_arr(arr, i);
+        if (i > 0) { memcpy(w, sep, seplen); w += seplen; }
+        if (e) { size_t l = strlen(e); memcpy(w, e, l); w += l; }
+    }
+    *w = '\0';
+    return r;
+}
+
+/* ── String builders ────────────────────────────────────────────────────── */
+/*
+ * A growable byte buffer; capacity doubles, so appends are amortized O(1)
+ * and __tl_sb_to_str copies the bytes once.  The builder stays usable after
+ * to_str.
+ */
+
+typedef struct {
+    char*  data;
+    size_t len, cap;
+} TLStrBuf;
+
+static void tl_sb_reserve(TLStrBuf* sb, size_t extra) {
+    if (sb->len + extra <= sb->cap) return;
+    size_t ncap = sb->cap ? sb->cap : 16;
+    while (ncap < sb->len + extra) ncap *= 2;
+    char* nd = (char*)realloc(sb->data, ncap);
+    if (!nd) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+    sb->data = nd;
+    sb->cap  = ncap;
+}
+
+void* __tl_sb_new(int32_t cap) {
+    TLStrBuf* sb = (TLStrBuf*)calloc(1, sizeof(TLStrBuf));
+    if (!sb) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+    if (cap > 0) tl_sb_reserve(sb, (size_t)cap);
+    return sb;
+}
+
+void __tl_sb_append(void* p, char* s) {
+    TLStrBuf* sb = (TLStrBuf*)p;
+    if (!s) return;
+    size_t n = strlen(s);
+    tl_sb_reserve(sb, n);
+    memcpy(sb->data + sb->len, s, n);
+    sb->len += n;
+}
+
+void __tl_sb_append_int(void* p, int32_t v) {
+    TLStrBuf* sb = (TLStrBuf*)p;
+    tl_sb_reserve(sb, 12);
+    sb->len += (size_t)snprintf(sb->data + sb->len, 12, "%d", v);
+}
+
+void __tl_sb_append_char(void* p, int32_t c) {
+    TLStrBuf* sb = (TLStrBuf*)p;
+    tl_sb_reserve(sb, 1);
+    sb->data[sb->len++] = (char)c;
+}
+
+int32_t __tl_sb_len(void* p) {
+    return (int32_t)((TLStrBuf*)p)->len;
+}
+
+char* __tl_sb_to_str(void* p) {
+    TLStrBuf* sb = (TLStrBuf*)p;
+    char* r = (char*)malloc(sb->len + 1);
+    if (!r) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+    if (sb->len) memcpy(r, sb->data, sb->len);
+    r[sb->len] = '\0';
+    return r;
+}
+
 /* ── File operations ────────────────────────────────────────────────────── */
 
 int32_t __tl_file_exists(char* path) {
@@ -174,19 +480,47 @@ int32_t __tl_file_exists(char* path) {
     return 1;
 }
 
+/* Read a whole file into a malloc'd, NUL-terminated buffer.  Regular files
+ * are read into an exactly fstat-sized buffer; once it is full a 1-byte read
+ * probes for EOF, so the buffer only grows for files longer than they
+ * claimed (pipes and procfs report size 0).  Returns NULL on error. */
+static char* tl_read_file(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    size_t cap = (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+                 ? (size_t)st.st_size : 4096;
+    char* buf = (char*)malloc(cap + 1);
+    size_t used = 0;
+    while (buf) {
+        ssize_t n;
+        if (used == cap) {
+            char probe;
+            n = read(fd, &probe, 1);
+            if (n == 1) {
+                char* nb = (char*)realloc(buf, cap * 2 + 1);
+                if (!nb) { free(buf); buf = NULL; break; }
+                buf = nb; cap *= 2;
+                buf[used] = probe;
+            }
+        } else {
+            n = read(fd, buf + used, cap - used);
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            free(buf); buf = NULL; break;
+        }
+        if (n == 0) { buf[used] = '\0'; break; }
+        used += (size_t)n;
+    }
+    close(fd);
+    return buf;
+}
+
 char* __tl_file_read_all(char* path) {
     if (!path) return strdup("");
-    FILE* f = fopen(path, "r");
-    if (!f) return strdup("");
-    fseek(f, 0, SEEK_END);
-    long sz = ftell(f);
-    rewind(f);
-    char* buf = (char*)malloc(sz + 1);
-    if (!buf) { fclose(f); return strdup(""); }
-    fread(buf, 1, sz, f);
-    buf[sz] = '\0';
-    fclose(f);
-    return buf;
+    char* buf = tl_read_file(path);
+    return buf ? buf : strdup("");
 }
 
 int32_t __tl_file_write_all(char* path, char* content) {
@@ -211,6 +545,313 @@ int32_t __tl_file_delete(char* path) {
     return path && remove(path) == 0 ? 1 : 0;
 }
 
+/* Map a file read-only and return it as a string without copying.  A zeroed
+ * anonymous region one byte larger than the file is reserved first and the
+ * file is mapped over its front, so the byte after EOF is always the NUL
+ * terminator — even when the size is an exact multiple of the page size.
+ * The mapping lives until exit, like every other native string. */
+char* __tl_file_map(char* path) {
+    if (!path) return strdup("");
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return strdup("");
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        close(fd);
+        return strdup("");
+    }
+    size_t size = (size_t)st.st_size;
+    char* base = (char*)mmap(NULL, size + 1, PROT_READ,
+                             MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (base != MAP_FAILED &&
+        mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(base, size + 1);
+        base = (char*)MAP_FAILED;
+    }
+    close(fd);
+    if (base == MAP_FAILED) {            /* fall back to a heap copy */
+        char* buf = tl_read_file(path);
+        return buf ? buf : strdup("");
+    }
+    return base;
+}
+
+/* ── Streaming readers ──────────────────────────────────────────────────── */
+/*
+ * Same contract as TIRVM's LineReader: one fixed TL_READER_BUF buffer per
+ * handle, refilled with read(2), lines found with memchr and copied once into
+ * the returned string.  Memory is bounded by the buffer plus the longest line.
+ */
+
+#define TL_READER_BUF (256 * 1024)
+
+typedef struct {
+    int    fd;
+    char*  buf;
+    size_t pos, end;
+    int    atEof;
+} TLReader;
+
+static TLReader** tl_readers;      /* handle h → tl_readers[h-1] */
+static int32_t    tl_readers_cap;
+
+static TLReader* tl_reader(int32_t h) {
+    if (h < 1 || h > tl_readers_cap || !tl_readers[h - 1]) {
+        fprintf(stderr, "tinyrt: invalid reader handle %d\n", h);
+        exit(1);
+    }
+    return tl_readers[h - 1];
+}
+
+static int tl_reader_fill(TLReader* r) {
+    r->pos = r->end = 0;
+    if (r->atEof) return 0;
+    for (;;) {
+        ssize_t n = read(r->fd, r->buf, TL_READER_BUF);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) { r->atEof = 1; return 0; }
+        r->end = (size_t)n;
+        return 1;
+    }
+}
+
+int32_t __tl_reader_open(char* path) {
+    if (!path) return 0;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    TLReader* r = (TLReader*)calloc(1, sizeof(TLReader));
+    char*     b = (char*)malloc(TL_READER_BUF);
+    if (!r || !b) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+    r->fd  = fd;
+    r->buf = b;
+    int32_t slot = 0;
+    while (slot < tl_readers_cap && tl_readers[slot]) slot++;
+    if (slot == tl_readers_cap) {
+        int32_t ncap = tl_readers_cap ? tl_readers_cap * 2 : 8;
+        TLReader** nt = (TLReader**)realloc(tl_readers, (size_t)ncap * sizeof(TLReader*));
+        if (!nt) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+        memset(nt + tl_readers_cap, 0, (size_t)(ncap - tl_readers_cap) * sizeof(TLReader*));
+        tl_readers     = nt;
+        tl_readers_cap = ncap;
+    }
+    tl_readers[slot] = r;
+    return slot + 1;
+}
+
+char* __tl_reader_read_line(int32_t h) {
+    TLReader* r = tl_reader(h);
+    char*  out = NULL;
+    size_t len = 0;
+    for (;;) {
+        if (r->pos == r->end && !tl_reader_fill(r)) break;
+        char*  start = r->buf + r->pos;
+        size_t avail = r->end - r->pos;
+        char*  nl    = (char*)memchr(start, '\n', avail);
+        size_t take  = nl ? (size_t)(nl - start) : avail;
+        char*  nb    = (char*)realloc(out, len + take + 1);
+        if (!nb) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+        out = nb;
+        memcpy(out + len, start, take);
+        len += take;
+        r->pos += take + (nl ? 1 : 0);
+        if (nl) break;
+    }
+    if (!out) return strdup("");
+    if (len > 0 && out[len - 1] == '\r') len--;
+    out[len] = '\0';
+    return out;
+}
+
+char* __tl_reader_read_chunk(int32_t h, int32_t n) {
+    TLReader* r = tl_reader(h);
+    if (n < 0) n = 0;
+    char* out = (char*)malloc((size_t)n + 1);
+    if (!out) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+    size_t len = 0;
+    while (len < (size_t)n) {
+        if (r->pos == r->end && !tl_reader_fill(r)) break;
+        size_t take = r->end - r->pos;
+        if (take > (size_t)n - len) take = (size_t)n - len;
+        memcpy(out + len, r->buf + r->pos, take);
+        len    += take;
+        r->pos += take;
+    }
+    out[len] = '\0';
+    return out;
+}
+
+int32_t __tl_reader_eof(int32_t h) {
+    TLReader* r = tl_reader(h);
+    if (r->pos < r->end) return 0;
+    return tl_reader_fill(r) ? 0 : 1;
+}
+
+void __tl_reader_close(int32_t h) {
+    TLReader* r = tl_reader(h);
+    close(r->fd);
+    free(r->buf);
+    free(r);
+    tl_readers[h - 1] = NULL;
+}
+
+/* ── Async file I/O ─────────────────────────────────────────────────────── */
+/*
+ * Mirrors TIRVM's AsyncIO: submit returns an integer handle at once and a
+ * small pthread pool (started on first use) performs the blocking read/write.
+ * Handles index a growable request table; await releases the slot so the
+ * table stays as small as the number of requests in flight.
+ */
+
+enum { TL_AIO_READ, TL_AIO_WRITE, TL_AIO_APPEND };
+
+typedef struct TLAioReq {
+    int              kind;
+    char*            path;
+    char*            data;     /* write payload, or read result */
+    int32_t          status;
+    int              done;
+    struct TLAioReq* next;     /* work-queue link */
+} TLAioReq;
+
+static pthread_mutex_t tl_aio_mu   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  tl_aio_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  tl_aio_done = PTHREAD_COND_INITIALIZER;
+static TLAioReq**      tl_aio_reqs;          /* handle h → tl_aio_reqs[h-1] */
+static int32_t         tl_aio_cap;
+static TLAioReq*       tl_aio_head;
+static TLAioReq*       tl_aio_tail;
+static int             tl_aio_started;
+
+static int32_t tl_write_file(const char* path, const char* data, int append) {
+    int fd = open(path, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+    if (fd < 0) return 0;
+    size_t len = strlen(data), done = 0;
+    while (done < len) {
+        ssize_t n = write(fd, data + done, len - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            return 0;
+        }
+        done += (size_t)n;
+    }
+    return close(fd) == 0 ? 1 : 0;
+}
+
+static void* tl_aio_worker(void* unused) {
+    (void)unused;
+    for (;;) {
+        pthread_mutex_lock(&tl_aio_mu);
+        while (!tl_aio_head) pthread_cond_wait(&tl_aio_work, &tl_aio_mu);
+        TLAioReq* r = tl_aio_head;
+        tl_aio_head = r->next;
+        if (!tl_aio_head) tl_aio_tail = NULL;
+        pthread_mutex_unlock(&tl_aio_mu);
+
+        char*   result = NULL;
+        int32_t status;
+        if (r->kind == TL_AIO_READ) {
+            result = tl_read_file(r->path);
+            status = result ? 1 : 0;
+        } else {
+            status = tl_write_file(r->path, r->data, r->kind == TL_AIO_APPEND);
+        }
+
+        pthread_mutex_lock(&tl_aio_mu);
+        if (r->kind == TL_AIO_READ) r->data = result;
+        r->status = status;
+        r->done   = 1;
+        pthread_cond_broadcast(&tl_aio_done);
+        pthread_mutex_unlock(&tl_aio_mu);
+    }
+    return NULL;
+}
+
+static int32_t tl_aio_submit(int kind, char* path, char* data) {
+    TLAioReq* r = (TLAioReq*)calloc(1, sizeof(TLAioReq));
+    if (!r) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+    r->kind  = kind;
+    r->path  = strdup(path ? path : "");
+    r->data  = kind == TL_AIO_READ ? NULL : strdup(data ? data : "");
+
+    pthread_mutex_lock(&tl_aio_mu);
+    if (!tl_aio_started) {
+        /* I/O-bound: a fixed pool of 8 detached workers keeps the disk busy. */
+        for (int i = 0; i < 8; i++) {
+            pthread_t t;
+            if (pthread_create(&t, NULL, tl_aio_worker, NULL) == 0)
+                pthread_detach(t);
+        }
+        tl_aio_started = 1;
+    }
+    int32_t slot = 0;
+    while (slot < tl_aio_cap && tl_aio_reqs[slot]) slot++;
+    if (slot == tl_aio_cap) {
+        int32_t ncap = tl_aio_cap ? tl_aio_cap * 2 : 64;
+        TLAioReq** nt = (TLAioReq**)realloc(tl_aio_reqs, (size_t)ncap * sizeof(TLAioReq*));
+        if (!nt) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+        memset(nt + tl_aio_cap, 0, (size_t)(ncap - tl_aio_cap) * sizeof(TLAioReq*));
+        tl_aio_reqs = nt;
+        tl_aio_cap  = ncap;
+    }
+    tl_aio_reqs[slot] = r;
+    if (tl_aio_tail) tl_aio_tail->next = r; else tl_aio_head = r;
+    tl_aio_tail = r;
+    pthread_cond_signal(&tl_aio_work);
+    pthread_mutex_unlock(&tl_aio_mu);
+    return slot + 1;
+}
+
+/* Wait for handle h and detach it from the table; caller frees the request. */
+static TLAioReq* tl_aio_take(int32_t h) {
+    pthread_mutex_lock(&tl_aio_mu);
+    if (h < 1 || h > tl_aio_cap || !tl_aio_reqs[h - 1]) {
+        pthread_mutex_unlock(&tl_aio_mu);
+        fprintf(stderr, "tinyrt: invalid async handle %d\n", h);
+        exit(1);
+    }
+    TLAioReq* r = tl_aio_reqs[h - 1];
+    while (!r->done) pthread_cond_wait(&tl_aio_done, &tl_aio_mu);
+    tl_aio_reqs[h - 1] = NULL;
+    pthread_mutex_unlock(&tl_aio_mu);
+    free(r->path);
+    return r;
+}
+
+int32_t __tl_file_read_async(char* path) {
+    return tl_aio_submit(TL_AIO_READ, path, NULL);
+}
+
+int32_t __tl_file_write_async(char* path, char* content) {
+    return tl_aio_submit(TL_AIO_WRITE, path, content);
+}
+
+int32_t __tl_file_append_async(char* path, char* content) {
+    return tl_aio_submit(TL_AIO_APPEND, path, content);
+}
+
+int32_t __tl_async_poll(int32_t h) {
+    pthread_mutex_lock(&tl_aio_mu);
+    int32_t done = (h < 1 || h > tl_aio_cap || !tl_aio_reqs[h - 1])
+                   ? 1 : tl_aio_reqs[h - 1]->done;
+    pthread_mutex_unlock(&tl_aio_mu);
+    return done;
+}
+
+char* __tl_async_await_str(int32_t h) {
+    TLAioReq* r = tl_aio_take(h);
+    char* s = r->data ? r->data : strdup("");
+    free(r);
+    return s;
+}
+
+int32_t __tl_async_await_i32(int32_t h) {
+    TLAioReq* r = tl_aio_take(h);
+    int32_t status = r->status;
+    free(r->data);
+    free(r);
+    return status;
+}
+
 /* ── Directory operations ─────────────────────────────────────────────────── */
 
 int32_t __tl_dir_exists(char* path) {
@@ -239,60 +880,212 @@ int32_t __tl_dir_delete(char* path) {
     return rmdir(path) == 0 ? 1 : 0;
 }
 
+/* Next entry name from d, skipping dot files, or NULL at the end.  readdir()
+ * refills from getdents64 in large batches, so a full scan costs a handful
+ * of syscalls however many entries there are. */
+static const char* tl_dir_next_name(DIR* d) {
+    struct dirent* e;
+    while ((e = readdir(d)) != NULL)
+        if (e->d_name[0] != '.') return e->d_name;
+    return NULL;
+}
+
 int32_t __tl_dir_list_count(char* path) {
     if (!path) return 0;
     DIR* d = opendir(path);
     if (!d) return 0;
     int32_t count = 0;
-    struct dirent* entry;
-    while ((entry = readdir(d)) != NULL) {
-        if (entry->d_name[0] == '.') continue; /* skip . and .. */
-        count++;
-    }
+    while (tl_dir_next_name(d)) count++;
     closedir(d);
     return count;
 }
 
+/* Rescans from the start on every call; prefer the iterator or
+ * __tl_dir_list_all for walking a whole directory. */
 char* __tl_dir_list_entry(char* path, int32_t idx) {
     if (!path) return "";
     DIR* d = opendir(path);
     if (!d) return "";
     int32_t i = 0;
-    struct dirent* entry;
-    while ((entry = readdir(d)) != NULL) {
-        if (entry->d_name[0] == '.') continue;
-        if (i == idx) {
+    const char* name;
+    while ((name = tl_dir_next_name(d)) != NULL) {
+        if (i++ == idx) {
+            char* s = strdup(name);
             closedir(d);
-            char* s = strdup(entry->d_name);
             return s ? s : "";
         }
-        i++;
     }
     closedir(d);
     return "";
 }
 
-/* ── Array resize ────────────────────────────────────────────────────────── */
+/* All entry names as a string array, in one pass. */
+void* __tl_dir_list_all(char* path) {
+    int32_t n = 0, cap = 16;
+    void* arr = __tl_alloc_arr(cap);
+    DIR* d = path ? opendir(path) : NULL;
+    if (d) {
+        const char* name;
+        while ((name = tl_dir_next_name(d)) != NULL) {
+            if (n == cap) arr = __tl_arr_resize(arr, cap *= 2);
+            char* s = strdup(name);
+            __tl_store_arr(arr, n++, (uint64_t)(uintptr_t)(s ? s : ""));
+        }
+        closedir(d);
+    }
+    return __tl_arr_resize(arr, n);
+}
 
-void* __tl_arr_resize(void* arr, int32_t new_cap) {
-    /* Realloc the element area preserving the header.
-     * This invalidates the old pointer — callers must update their reference. */
-    if (!arr) return __tl_alloc_arr(new_cap);
-    TLArrHeader* h = (TLArrHeader*)arr;
-    int32_t old_cap = (int32_t)h->length;
-    size_t new_sz = sizeof(TLArrHeader) + (size_t)new_cap * 8;
-    TLArrHeader* new_arr = (TLArrHeader*)realloc(arr, new_sz);
-    if (!new_arr) return arr; /* keep old on failure */
-    /* Zero the new slots */
-    if (new_cap > old_cap) {
-        uint64_t* elems = (uint64_t*)(new_arr + 1);
-        memset(elems + old_cap, 0, (size_t)(new_cap - old_cap) * 8);
+/* Directory iterators: handle h → tl_dirs[h-1]; 0 means opendir failed. */
+static DIR**   tl_dirs;
+static int32_t tl_dirs_cap;
+
+static DIR* tl_dir(int32_t h) {
+    if (h < 1 || h > tl_dirs_cap || !tl_dirs[h - 1]) {
+        fprintf(stderr, "tinyrt: invalid directory handle %d\n", h);
+        exit(1);
     }
-    new_arr->length = new_cap;
-    return new_arr;
+    return tl_dirs[h - 1];
+}
+
+int32_t __tl_dir_open(char* path) {
+    DIR* d = path ? opendir(path) : NULL;
+    if (!d) return 0;
+    int32_t slot = 0;
+    while (slot < tl_dirs_cap && tl_dirs[slot]) slot++;
+    if (slot == tl_dirs_cap) {
+        int32_t ncap = tl_dirs_cap ? tl_dirs_cap * 2 : 8;
+        DIR** nt = (DIR**)realloc(tl_dirs, (size_t)ncap * sizeof(DIR*));
+        if (!nt) { closedir(d); return 0; }
+        memset(nt + tl_dirs_cap, 0, (size_t)(ncap - tl_dirs_cap) * sizeof(DIR*));
+        tl_dirs     = nt;
+        tl_dirs_cap = ncap;
+    }
+    tl_dirs[slot] = d;
+    return slot + 1;
+}
+
+/* Next entry name, or "" once the directory is exhausted. */
+char* __tl_dir_next(int32_t h) {
+    const char* name = tl_dir_next_name(tl_dir(h));
+    char* s = name ? strdup(name) : NULL;
+    return s ? s : "";
+}
+
+void __tl_dir_close(int32_t h) {
+    closedir(tl_dir(h));
+    tl_dirs[h - 1] = NULL;
+}
+
+/* ── SPSC queues ────────────────────────────────────────────────────────── */
+/*
+ * Bounded lock-free single-producer / single-consumer int queues, the C
+ * twin of runtime/thread/spsc.hpp.  One thread pushes, one thread pops;
+ * head and tail count forever and are masked by the power-of-two capacity.
+ * The handle table has a fixed size and its slots are atomic, so a producer
+ * thread in native code can call __tl_spsc_push(h, v) on a handle the
+ * script created without any further synchronisation.
+ */
+
+#define TL_SPSC_MAX 64
+
+typedef struct {
+    int32_t*       slots;
+    size_t         mask;
+    atomic_bool    closed;
+    _Alignas(64) atomic_size_t head;   /* next slot to pop  */
+    _Alignas(64) atomic_size_t tail;   /* next slot to push */
+} TLSpsc;
+
+static TLSpsc* _Atomic tl_spsc[TL_SPSC_MAX];
+
+static TLSpsc* tl_spsc_get(int32_t h) {
+    TLSpsc* q = (h >= 1 && h <= TL_SPSC_MAX)
+        ? atomic_load_explicit(&tl_spsc[h - 1], memory_order_acquire) : NULL;
+    if (!q) {
+        fprintf(stderr, "tinyrt: invalid spsc queue handle %d\n", h);
+        exit(1);
+    }
+    return q;
+}
+
+/* Handle of a new queue, or 0 when all TL_SPSC_MAX handles are in use. */
+int32_t __tl_spsc_new(int32_t cap) {
+    size_t n = 2;
+    while (n < (size_t)(cap > 0 ? cap : 1)) n *= 2;
+    TLSpsc* q = (TLSpsc*)aligned_alloc(64, sizeof(TLSpsc));
+    int32_t* slots = (int32_t*)malloc(n * sizeof(int32_t));
+    if (!q || !slots) { fprintf(stderr, "tinyrt: out of memory\n"); exit(1); }
+    q->slots = slots;
+    q->mask  = n - 1;
+    atomic_init(&q->closed, 0);
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    for (int32_t i = 0; i < TL_SPSC_MAX; i++) {
+        TLSpsc* expected = NULL;
+        if (atomic_compare_exchange_strong(&tl_spsc[i], &expected, q)) return i + 1;
+    }
+    free(slots);
+    free(q);
+    return 0;
+}
+
+/* 1 on success, 0 when the queue is full or closed. */
+int32_t __tl_spsc_push(int32_t h, int32_t v) {
+    TLSpsc* q = tl_spsc_get(h);
+    if (atomic_load_explicit(&q->closed, memory_order_relaxed)) return 0;
+    size_t t = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    if (t - atomic_load_explicit(&q->head, memory_order_acquire) > q->mask) return 0;
+    q->slots[t & q->mask] = v;
+    atomic_store_explicit(&q->tail, t + 1, memory_order_release);
+    return 1;
+}
+
+static int tl_spsc_pop(TLSpsc* q, int32_t* out) {
+    size_t hd = atomic_load_explicit(&q->head, memory_order_relaxed);
+    if (hd == atomic_load_explicit(&q->tail, memory_order_acquire)) return 0;
+    *out = q->slots[hd & q->mask];
+    atomic_store_explicit(&q->head, hd + 1, memory_order_release);
+    return 1;
+}
+
+int32_t __tl_spsc_pop_or(int32_t h, int32_t dflt) {
+    int32_t v;
+    return tl_spsc_pop(tl_spsc_get(h), &v) ? v : dflt;
 }
 
-/* __tl_load_arr / __tl_store_arr / __tl_alloc_arr already defined above */
+/* Waits for a value; dflt once the queue is closed and drained. */
+int32_t __tl_spsc_take(int32_t h, int32_t dflt) {
+    TLSpsc* q = tl_spsc_get(h);
+    int32_t v;
+    for (;;) {
+        if (tl_spsc_pop(q, &v)) return v;
+        if (atomic_load_explicit(&q->closed, memory_order_acquire))
+            return tl_spsc_pop(q, &v) ? v : dflt;
+        sched_yield();
+    }
+}
+
+int32_t __tl_spsc_len(int32_t h) {
+    TLSpsc* q = tl_spsc_get(h);
+    return (int32_t)(atomic_load(&q->tail) - atomic_load(&q->head));
+}
+
+int32_t __tl_spsc_closed(int32_t h) {
+    return atomic_load(&tl_spsc_get(h)->closed) ? 1 : 0;
+}
+
+void __tl_spsc_close(int32_t h) {
+    atomic_store(&tl_spsc_get(h)->closed, 1);
+}
+
+/* Only once neither side will touch the handle again. */
+void __tl_spsc_free(int32_t h) {
+    TLSpsc* q = tl_spsc_get(h);
+    atomic_store(&tl_spsc[h - 1], NULL);
+    free(q->slots);
+    free(q);
+}
 
 /* ── Object layout ──────────────────────────────────────────────────────── */
 /*
@@ -378,3 +1171,180 @@ void __tl_store_arr(void* arr, int32_t idx, uint64_t val) {
     uint64_t* elems = (uint64_t*)((char*)arr + sizeof(TLArrHeader));
     elems[idx] = val;
 }
+
+/* Failure path of the bounds checks LLVMGen inlines for int/float arrays. */
+void __tl_arr_oob(void* arr, int64_t idx) {
+    if (!arr) { fprintf(stderr, "tinyrt: null array\n"); exit(1); }
+    fprintf(stderr, "tinyrt: array index %lld out of bounds (len=%lld)\n",
+            (long long)idx, (long long)((TLArrHeader*)arr)->length);
+    exit(1);
+}
+
+/* ── Array resize ────────────────────────────────────────────────────────── */
+
+void* __tl_arr_resize(void* arr, int32_t new_cap) {
+    /* Realloc the element area preserving the header.
+     * This invalidates the old pointer — callers must update their reference. */
+    if (!arr) return __tl_alloc_arr(new_cap);
+    TLArrHeader* h = (TLArrHeader*)arr;
+    int32_t old_cap = (int32_t)h->length;
+    size_t new_sz = sizeof(TLArrHeader) + (size_t)new_cap * 8;
+    TLArrHeader* new_arr = (TLArrHeader*)realloc(arr, new_sz);
+    if (!new_arr) return arr; /* keep old on failure */
+    /* Zero the new slots */
+    if (new_cap > old_cap) {
+        uint64_t* elems = (uint64_t*)(new_arr + 1);
+        memset(elems + old_cap, 0, (size_t)(new_cap - old_cap) * 8);
+    }
+    new_arr->length = new_cap;
+    return new_arr;
+}
+
+/* ── Sort / search / partition ──────────────────────────────────────────── */
+/*
+ * All take (arr, n) and work on the first n elements only, so a Vec's unused
+ * capacity is left alone.  Element encodings match StoreArr: i32 zero-extended,
+ * f64 bit-cast, strings as char* bits.
+ */
+
+static uint64_t* tl_arr_prefix(void* arr, int32_t* n) {
+    if (!arr || *n < 0) { *n = 0; return NULL; }
+    TLArrHeader* h = (TLArrHeader*)arr;
+    if ((int64_t)*n > h->length) *n = (int32_t)h->length;
+    return (uint64_t*)(h + 1);
+}
+
+static int tl_cmp_i32(const void* a, const void* b) {
+    int32_t x = (int32_t)(uint32_t)*(const uint64_t*)a;
+    int32_t y = (int32_t)(uint32_t)*(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* Ascending, NaN last (a total order, unlike x < y). */
+static int tl_cmp_f64(const void* a, const void* b) {
+    double x, y;
+    memcpy(&x, a, 8);
+    memcpy(&y, b, 8);
+    if (isnan(x) || isnan(y)) return !!isnan(x) - !!isnan(y);
+    return (x > y) - (x < y);
+}
+
+static int tl_cmp_str(const void* a, const void* b) {
+    const char* x = (const char*)(uintptr_t)*(const uint64_t*)a;
+    const char* y = (const char*)(uintptr_t)*(const uint64_t*)b;
+    return strcmp(x ? x : "", y ? y : "");
+}
+
+void __tl_arr_sort_i32(void* arr, int32_t n) {
+    /* LSD radix sort, one byte per pass over the sign-flipped keys; a pass
+     * whose byte is equal in every key is skipped. */
+    uint64_t* el = tl_arr_prefix(arr, &n);
+    if (n < 64) {
+        if (n > 1) qsort(el, (size_t)n, 8, tl_cmp_i32);
+        return;
+    }
+    uint32_t* a = (uint32_t*)malloc((size_t)n * 4);
+    uint32_t* b = (uint32_t*)malloc((size_t)n * 4);
+    if (!a || !b) {
+        free(a); free(b);
+        qsort(el, (size_t)n, 8, tl_cmp_i32);
+        return;
+    }
+    for (int32_t i = 0; i < n; i++) a[i] = (uint32_t)el[i] ^ 0x80000000u;
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t count[257] = {0};
+        for (int32_t i = 0; i < n; i++) count[((a[i] >> shift) & 0xFF) + 1]++;
+        if (count[((a[0] >> shift) & 0xFF) + 1] == (size_t)n) continue;
+        for (int i = 0; i < 256; i++) count[i + 1] += count[i];
+        for (int32_t i = 0; i < n; i++) b[count[(a[i] >> shift) & 0xFF]++] = a[i];
+        uint32_t* t = a; a = b; b = t;
+    }
+    for (int32_t i = 0; i < n; i++) el[i] = a[i] ^ 0x80000000u;
+    free(a);
+    free(b);
+}
+
+void __tl_arr_sort_f64(void* arr, int32_t n) {
+    uint64_t* el = tl_arr_prefix(arr, &n);
+    if (n > 1) qsort(el, (size_t)n, 8, tl_cmp_f64);
+}
+
+void __tl_arr_sort_str(void* arr, int32_t n) {
+    uint64_t* el = tl_arr_prefix(arr, &n);
+    if (n > 1) qsort(el, (size_t)n, 8, tl_cmp_str);
+}
+
+/* Index of the first element equal to key in an ascending prefix, or -1. */
+int32_t __tl_arr_bsearch(void* arr, int32_t n, int32_t key) {
+    uint64_t* el = tl_arr_prefix(arr, &n);
+    int32_t lo = 0, hi = n;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if ((int32_t)(uint32_t)el[mid] < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < n && (int32_t)(uint32_t)el[lo] == key ? lo : -1;
+}
+
+int32_t __tl_arr_bsearch_str(void* arr, int32_t n, const char* key) {
+    uint64_t* el = tl_arr_prefix(arr, &n);
+    uint64_t k = (uint64_t)(uintptr_t)key;
+    int32_t lo = 0, hi = n;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (tl_cmp_str(&el[mid], &k) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < n && tl_cmp_str(&el[lo], &k) == 0 ? lo : -1;
+}
+
+/* Moves elements < pivot to the front; returns how many there are. */
+int32_t __tl_arr_partition(void* arr, int32_t n, int32_t pivot) {
+    uint64_t* el = tl_arr_prefix(arr, &n);
+    int32_t store = 0;
+    for (int32_t i = 0; i < n; i++) {
+        if ((int32_t)(uint32_t)el[i] < pivot) {
+            uint64_t t = el[i]; el[i] = el[store]; el[store] = t;
+            store++;
+        }
+    }
+    return store;
+}
+
+/* ── Math array kernels ─────────────────────────────────────────────────── */
+/*
+ * __tl_math_map_<fn>(arr) returns a new array with fn applied to every
+ * element of a float array.  The result is copied in one block and then
+ * transformed in place over a flat double[]; at -O2 with -fno-math-errno
+ * the sqrt, floor and fabs loops vectorize.  Scalar __tl_math_* calls never
+ * reach here: the LLVM backend lowers them to intrinsics.
+ */
+
+#define TL_MATH_MAP(fn, expr)                                              \
+void* __tl_math_map_##fn(void* arr) {                                      \
+    int32_t n = __tl_arr_len(arr);                                         \
+    void* out = __tl_alloc_arr(n);                                         \
+    double* d = (double*)((TLArrHeader*)out + 1);                          \
+    if (n > 0) memcpy(d, (TLArrHeader*)arr + 1, (size_t)n * 8);            \
+    for (int32_t i = 0; i < n; i++) { double x = d[i]; d[i] = (expr); }    \
+    return out;                                                            \
+}
+
+TL_MATH_MAP(sqrt,  sqrt(x))
+TL_MATH_MAP(exp,   exp(x))
+TL_MATH_MAP(log,   log(x))
+TL_MATH_MAP(sin,   sin(x))
+TL_MATH_MAP(cos,   cos(x))
+TL_MATH_MAP(floor, floor(x))
+TL_MATH_MAP(abs,   fabs(x))
+
+/* ── Bulk stdin ─────────────────────────────────────────────────────────── */
+
+void* __tl_read_ints(int32_t n) {
+    if (n < 0) n = 0;
+    void* arr = __tl_alloc_arr(n);
+    uint64_t* elems = (uint64_t*)((char*)arr + sizeof(TLArrHeader));
+    for (int32_t i = 0; i < n; i++)
+        elems[i] = (uint32_t)tl_in_next_int();   /* same encoding as StoreArr */
+    return arr;
+}
@@ -0,0 +1,157 @@
+#include "asyncio.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Synchronous helpers
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool AsyncIO::readFile(const std::string& path, std::string& out) {
+    out.clear();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        out.resize((size_t)st.st_size);
+
+    // Regular files fill the exactly-sized buffer in one read(); once it is
+    // full a 1-byte read probes for EOF, so the buffer only grows for files
+    // longer than fstat claimed (pipes and procfs report size 0).
+    size_t used = 0;
+    while (true) {
+        ssize_t n;
+        if (used == out.size()) {
+            char probe;
+            n = ::read(fd, &probe, 1);
+            if (n == 1) {
+                out.resize(std::max<size_t>(4096, out.size() * 2));
+                out[used] = probe;
+            }
+        } else {
+            n = ::read(fd, &out[used], out.size() - used);
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            out.clear();
+            return false;
+        }
+        if (n == 0) break;
+        used += (size_t)n;
+    }
+    out.resize(used);
+    ::close(fd);
+    return true;
+}
+
+bool AsyncIO::writeFile(const std::string& path, const std::string& data,
+                        bool append) {
+    int flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+    int fd = ::open(path.c_str(), flags, 0644);
+    if (fd < 0) return false;
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            return false;
+        }
+        done += (size_t)n;
+    }
+    return ::close(fd) == 0;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Worker pool
+// ─────────────────────────────────────────────────────────────────────────────
+
+AsyncIO::~AsyncIO() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    workCv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+void AsyncIO::startWorkers() {
+    // I/O-bound work: a few more threads than cores keeps the disk queue full.
+    unsigned n = std::thread::hardware_concurrency();
+    n = std::min(16u, std::max(4u, n));
+    for (unsigned i = 0; i < n; ++i)
+        workers_.emplace_back(&AsyncIO::workerLoop, this);
+}
+
+void AsyncIO::workerLoop() {
+    while (true) {
+        Request* req = nullptr;
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            workCv_.wait(lk, [&] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) return;   // stop_ and nothing left to do
+            req = queue_.front();
+            queue_.pop_front();
+        }
+
+        int status = 0;
+        if (req->kind == Kind::Read) {
+            status = readFile(req->path, req->data) ? 1 : 0;
+        } else {
+            status = writeFile(req->path, req->data, req->kind == Kind::Append) ? 1 : 0;
+            req->data.clear();
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            req->status = status;
+            req->done   = true;
+        }
+        doneCv_.notify_all();
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Handle API
+// ─────────────────────────────────────────────────────────────────────────────
+
+int AsyncIO::submit(Kind kind, std::string path, std::string data) {
+    auto req = std::make_unique<Request>();
+    req->kind = kind;
+    req->path = std::move(path);
+    req->data = std::move(data);
+
+    int handle;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (workers_.empty()) startWorkers();
+        handle = nextHandle_++;
+        queue_.push_back(req.get());
+        reqs_[handle] = std::move(req);
+    }
+    workCv_.notify_one();
+    return handle;
+}
+
+bool AsyncIO::poll(int handle) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = reqs_.find(handle);
+    return it == reqs_.end() || it->second->done;
+}
+
+bool AsyncIO::await(int handle, std::string& out, int& status) {
+    std::unique_lock<std::mutex> lk(mu_);
+    auto it = reqs_.find(handle);
+    if (it == reqs_.end()) return false;
+    Request* req = it->second.get();
+    doneCv_.wait(lk, [&] { return req->done; });
+    out    = std::move(req->data);
+    status = req->status;
+    reqs_.erase(handle);   // `it` may be stale after a rehash in submit()
+    return true;
+}
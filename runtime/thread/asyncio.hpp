@@ -0,0 +1,71 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// AsyncIO – background file I/O for the TIRVM interpreter.
+//
+// Design notes:
+//   • submit() queues a read/write/append request and returns an integer
+//     handle immediately; a small worker pool performs the blocking syscalls,
+//     so a script that reads many small files overlaps their I/O.
+//   • Workers only produce plain std::string / int results and never touch
+//     TLHeap — the GC needs no synchronisation with them.  The interpreter
+//     turns the result into a TLValue when the handle is awaited.
+//   • Handles are single-shot: await() releases the slot.
+//   • Workers are started lazily on the first submit(), so programs that
+//     never use the async builtins do not spawn threads.
+// ---------------------------------------------------------------------------
+
+class AsyncIO {
+public:
+    enum class Kind { Read, Write, Append };
+
+    AsyncIO() = default;
+    ~AsyncIO();
+    AsyncIO(const AsyncIO&)            = delete;
+    AsyncIO& operator=(const AsyncIO&) = delete;
+
+    // Queue a request; returns its handle (> 0).
+    int  submit(Kind kind, std::string path, std::string data = "");
+
+    // True once the request has completed (or the handle is unknown).
+    bool poll(int handle);
+
+    // Block until the request completes.  Read results are moved into out.
+    // Returns false for an unknown or already-awaited handle.
+    bool await(int handle, std::string& out, int& status);
+
+    // ── Synchronous helpers (shared with the blocking builtins) ───────────
+    // Read a whole file with a single fstat-sized buffer.
+    static bool readFile(const std::string& path, std::string& out);
+    static bool writeFile(const std::string& path, const std::string& data,
+                          bool append);
+
+private:
+    struct Request {
+        Kind        kind;
+        std::string path;
+        std::string data;    // write payload, or read result
+        int         status = 0;
+        bool        done   = false;
+    };
+
+    std::mutex                                        mu_;
+    std::condition_variable                           workCv_;
+    std::condition_variable                           doneCv_;
+    std::deque<Request*>                              queue_;
+    std::unordered_map<int, std::unique_ptr<Request>> reqs_;
+    std::vector<std::thread>                          workers_;
+    int                                               nextHandle_ = 1;
+    bool                                              stop_       = false;
+
+    void startWorkers();
+    void workerLoop();
+};
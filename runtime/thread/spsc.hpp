@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// ---------------------------------------------------------------------------
+// SpscQueue – bounded lock-free single-producer / single-consumer int queue.
+//
+// Design notes:
+//   • Backs the __tl_spsc_* builtins.  Exactly one thread may push and
+//     exactly one thread may pop at a time; neither ever takes a lock, so an
+//     embedder thread (or native code) can feed a running script without
+//     stalling the interpreter.
+//   • Capacity is rounded up to a power of two; head_ and tail_ count
+//     forever and are masked on access, so full and empty never alias.
+//   • The producer publishes a slot with a release store of tail_, the
+//     consumer frees it with a release store of head_; each side caches the
+//     other's index and rereads it only when the cached value says
+//     full / empty, keeping the shared cache lines mostly read-only.
+//   • Values are plain ints, never TLValues, so the GC needs no
+//     synchronisation with producers.
+// ---------------------------------------------------------------------------
+
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap *= 2;
+        mask_  = cap - 1;
+        slots_ = std::make_unique<int32_t[]>(cap);
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Producer side.  Returns false when the queue is full or closed.
+    bool push(int32_t v) {
+        if (closed_.load(std::memory_order_relaxed)) return false;
+        size_t t = tail_.load(std::memory_order_relaxed);
+        if (t - headCache_ > mask_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (t - headCache_ > mask_) return false;
+        }
+        slots_[t & mask_] = v;
+        tail_.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.  Returns false when the queue is empty.
+    bool pop(int32_t& out) {
+        size_t h = head_.load(std::memory_order_relaxed);
+        if (h == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (h == tailCache_) return false;
+        }
+        out = slots_[h & mask_];
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.  Waits for a value; false once closed and drained.
+    bool take(int32_t& out) {
+        for (;;) {
+            if (pop(out)) return true;
+            if (closed_.load(std::memory_order_acquire)) return pop(out);
+            std::this_thread::yield();
+        }
+    }
+
+    // Either side.  A snapshot; exact only when the other side is idle.
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) -
+               head_.load(std::memory_order_acquire);
+    }
+
+    // Producer side: no more pushes; take() returns false once drained.
+    void close() { closed_.store(true, std::memory_order_release); }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    size_t                     mask_ = 0;
+    std::unique_ptr<int32_t[]> slots_;
+    std::atomic<bool>          closed_{false};
+
+    // Consumer-owned, then producer-owned, on separate cache lines.
+    alignas(64) std::atomic<size_t> head_{0};        // next slot to pop
+    size_t                          tailCache_ = 0;  // consumer's view of tail_
+    alignas(64) std::atomic<size_t> tail_{0};        // next slot to push
+    size_t                          headCache_ = 0;  // producer's view of head_
+};
@@ -0,0 +1,81 @@
+#include "inbuf.hpp"
+#include "outbuf.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <unistd.h>
+
+InBuf& InBuf::instance() {
+    static InBuf in;
+    return in;
+}
+
+bool InBuf::refill() {
+    if (atEof_) return false;
+    OutBuf::instance().flush();
+    if (pos_ > 0) {
+        std::memmove(buf_, buf_ + pos_, end_ - pos_);
+        end_ -= pos_;
+        pos_  = 0;
+    }
+    if (end_ == CAP) return false;   // a single token fills the buffer
+    while (true) {
+        ssize_t n = ::read(STDIN_FILENO, buf_ + end_, CAP - end_);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) { atEof_ = true; return false; }
+        end_ += (size_t)n;
+        return true;
+    }
+}
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+int32_t InBuf::nextInt() {
+    // Skip whitespace.
+    while (true) {
+        while (pos_ < end_ && isSpace(buf_[pos_])) ++pos_;
+        if (pos_ < end_) break;
+        if (!refill()) return 0;
+    }
+    // Make sure the whole token is buffered before parsing it.
+    size_t tokEnd = pos_;
+    while (true) {
+        while (tokEnd < end_ && !isSpace(buf_[tokEnd])) ++tokEnd;
+        if (tokEnd < end_) break;
+        size_t off = tokEnd - pos_;
+        bool more = refill();          // may shift the buffer either way
+        tokEnd = pos_ + off;
+        if (!more) break;
+    }
+    const char* first = buf_ + pos_;
+    if (*first == '+') ++first;      // from_chars rejects a leading '+'
+    int32_t v = 0;
+    auto res = std::from_chars(first, buf_ + tokEnd, v);
+    if (res.ec != std::errc()) v = 0;
+    pos_ = tokEnd;
+    return v;
+}
+
+bool InBuf::readLine(std::string& out) {
+    out.clear();
+    bool gotAny = false;
+    while (true) {
+        if (pos_ == end_ && !refill()) break;
+        const char* start = buf_ + pos_;
+        const char* nl = static_cast<const char*>(std::memchr(start, '\n', end_ - pos_));
+        if (nl) {
+            out.append(start, nl - start);
+            pos_ += (nl - start) + 1;
+            if (!out.empty() && out.back() == '\r') out.pop_back();
+            return true;
+        }
+        out.append(start, end_ - pos_);
+        pos_   = end_;
+        gotAny = true;
+    }
+    if (!out.empty() && out.back() == '\r') out.pop_back();
+    return gotAny;
+}
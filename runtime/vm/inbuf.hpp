@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// InBuf – buffered stdin for the interpreters (TIRVM and IRVM).
+//
+// Design notes:
+//   • Reads stdin in 64 KiB blocks with read(2) and parses integers in place
+//     with std::from_chars — one syscall per block instead of per token.
+//   • Every stdin consumer (Op::Input, IROp::INPUT, __tl_read_ints,
+//     __tl_read_line) goes through this buffer so none of them skips input
+//     another has buffered.
+//   • OutBuf is flushed before each refill so prompts appear before the
+//     program blocks on input.
+// ---------------------------------------------------------------------------
+
+class InBuf {
+public:
+    static InBuf& instance();
+
+    // Next whitespace-separated integer.  Returns 0 at EOF; a malformed or
+    // out-of-range token is consumed and also yields 0 (tinyrt.c matches).
+    int32_t nextInt();
+
+    // Next line without its terminator.  Returns false (out empty) at EOF.
+    bool readLine(std::string& out);
+
+private:
+    InBuf() = default;
+    InBuf(const InBuf&)            = delete;
+    InBuf& operator=(const InBuf&) = delete;
+
+    static constexpr size_t CAP = 64 * 1024;
+
+    char   buf_[CAP];
+    size_t pos_   = 0;
+    size_t end_   = 0;
+    bool   atEof_ = false;
+
+    // Move unread bytes to the front and read more after them.
+    // Returns false if nothing new was read.
+    bool refill();
+};
@@ -1,4 +1,6 @@
 #include "irvm.hpp"
+#include "outbuf.hpp"
+#include "inbuf.hpp"
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
@@ -9,10 +11,6 @@
 // Utility
 // ===========================================================================
 
-std::string IRVM::newHandle(const std::string& pfx) {
-    return "__" + pfx + std::to_string(handleCounter_++);
-}
-
 IRValue IRVM::pop() {
     if (stack_.empty()) throw std::runtime_error("IRVM: operand stack underflow");
     auto v = stack_.back();
@@ -21,38 +19,52 @@ IRValue IRVM::pop() {
 }
 
 std::string IRVM::valueToString(const IRValue& v) const {
-    switch (v.type) {
-        case IRType::INT:        return std::to_string(v.i);
-        case IRType::FLOAT: {
-            std::string s = std::to_string(v.f);
+    switch (v.tag) {
+        case TLValue::Tag::Bool:
+        case TLValue::Tag::I32:  return std::to_string(v.p.i);
+        case TLValue::Tag::F64: {
+            std::string s = std::to_string(v.p.d);
             s.erase(s.find_last_not_of('0') + 1);
             if (s.back() == '.') s.pop_back();
             return s;
         }
-        case IRType::CHAR:       return std::string(1, v.c);
-        case IRType::STRING:     return v.s;
-        case IRType::OBJ_HANDLE: return v.s;
-        case IRType::ARR_HANDLE: return v.s;
+        case TLValue::Tag::Char: return std::string(1, v.p.c);
+        case TLValue::Tag::Str:
+        case TLValue::Tag::StrView: return std::string(v.str());
+        case TLValue::Tag::Obj:  return v.p.obj ? "<" + v.p.obj->className + ">" : "nil";
+        case TLValue::Tag::Arr:  return "<array>";
         default:                 return "nil";
     }
 }
 
+// ===========================================================================
+// Mark-and-sweep GC
+// ===========================================================================
+
+void IRVM::runGC() {
+    for (auto& v : stack_) heap_.markValue(v);
+    for (auto* frame : callStack_) {
+        if (frame->thisObj) heap_.markObject(frame->thisObj);
+        for (auto& val : frame->slots) heap_.markValue(val);
+    }
+    heap_.sweep();
+}
+
 // ===========================================================================
 // Arithmetic + comparison
 // ===========================================================================
 
 IRValue IRVM::arith(const IRValue& l, const IRValue& r, IROp op) {
     // String concatenation for ADD
-    if (op == IROp::ADD &&
-        (l.type == IRType::STRING || r.type == IRType::STRING)) {
-        return IRValue::fromString(valueToString(l) + valueToString(r));
+    if (op == IROp::ADD && (l.isStr() || r.isStr())) {
+        return IRValue::fromStr(valueToString(l) + valueToString(r));
     }
     // Float promotion
-    if (l.type == IRType::FLOAT || r.type == IRType::FLOAT) {
-        double lv = (l.type == IRType::FLOAT) ? l.f
-                  : (l.type == IRType::CHAR)  ? (double)(int)l.c : (double)l.i;
-        double rv = (r.type == IRType::FLOAT) ? r.f
-                  : (r.type == IRType::CHAR)  ? (double)(int)r.c : (double)r.i;
+    if (l.isFloat() || r.isFloat()) {
+        double lv = l.isFloat() ? l.p.d
+                  : (l.tag == TLValue::Tag::Char) ? (double)(int)l.p.c : (double)l.p.i;
+        double rv = r.isFloat() ? r.p.d
+                  : (r.tag == TLValue::Tag::Char) ? (double)(int)r.p.c : (double)r.p.i;
         switch (op) {
             case IROp::ADD: return IRValue::fromFloat(lv + rv);
             case IROp::SUB: return IRValue::fromFloat(lv - rv);
@@ -64,8 +76,8 @@ IRValue IRVM::arith(const IRValue& l, const IRValue& r, IROp op) {
         }
     }
     // Integer (or char-as-int)
-    int lv = (l.type == IRType::CHAR) ? (int)l.c : l.i;
-    int rv = (r.type == IRType::CHAR) ? (int)r.c : r.i;
+    int lv = (l.tag == TLValue::Tag::Char) ? (int)l.p.c : l.p.i;
+    int rv = (r.tag == TLValue::Tag::Char) ? (int)r.p.c : r.p.i;
     switch (op) {
         case IROp::ADD: return IRValue::fromInt(lv + rv);
         case IROp::SUB: return IRValue::fromInt(lv - rv);
@@ -79,32 +91,40 @@ IRValue IRVM::arith(const IRValue& l, const IRValue& r, IROp op) {
 }
 
 IRValue IRVM::compare(const IRValue& l, const IRValue& r, IROp op) {
-    // String / handle comparison
-    if (l.type == IRType::STRING || r.type == IRType::STRING ||
-        l.type == IRType::OBJ_HANDLE || r.type == IRType::OBJ_HANDLE) {
+    // Object / array identity
+    if (l.isObj() || r.isObj() || l.isArr() || r.isArr()) {
+        const void* lp = l.isObj() ? (const void*)l.p.obj : l.isArr() ? (const void*)l.p.arr : nullptr;
+        const void* rp = r.isObj() ? (const void*)r.p.obj : r.isArr() ? (const void*)r.p.arr : nullptr;
+        if (op == IROp::CMP_EQ)  return IRValue::fromInt(lp == rp ? 1 : 0);
+        if (op == IROp::CMP_NEQ) return IRValue::fromInt(lp != rp ? 1 : 0);
+        throw std::runtime_error("IRVM: <, > not supported for objects");
+    }
+    // String comparison
+    if (l.isStr() || r.isStr()) {
         std::string ls = valueToString(l), rs = valueToString(r);
         if (op == IROp::CMP_EQ)  return IRValue::fromInt(ls == rs ? 1 : 0);
         if (op == IROp::CMP_NEQ) return IRValue::fromInt(ls != rs ? 1 : 0);
         throw std::runtime_error("IRVM: <, > not supported for strings");
     }
     // Char comparison
-    if (l.type == IRType::CHAR && r.type == IRType::CHAR) {
-        if (op == IROp::CMP_EQ)  return IRValue::fromInt(l.c == r.c ? 1 : 0);
-        if (op == IROp::CMP_NEQ) return IRValue::fromInt(l.c != r.c ? 1 : 0);
-        if (op == IROp::CMP_LT)  return IRValue::fromInt(l.c  < r.c ? 1 : 0);
-        if (op == IROp::CMP_GT)  return IRValue::fromInt(l.c  > r.c ? 1 : 0);
+    if (l.tag == TLValue::Tag::Char && r.tag == TLValue::Tag::Char) {
+        char lc = l.p.c, rc = r.p.c;
+        if (op == IROp::CMP_EQ)  return IRValue::fromInt(lc == rc ? 1 : 0);
+        if (op == IROp::CMP_NEQ) return IRValue::fromInt(lc != rc ? 1 : 0);
+        if (op == IROp::CMP_LT)  return IRValue::fromInt(lc  < rc ? 1 : 0);
+        if (op == IROp::CMP_GT)  return IRValue::fromInt(lc  > rc ? 1 : 0);
     }
     // Numeric (int or float)
-    bool isFloat = (l.type == IRType::FLOAT || r.type == IRType::FLOAT);
+    bool isFloat = (l.isFloat() || r.isFloat());
     if (isFloat) {
-        double lv = (l.type == IRType::FLOAT) ? l.f : (double)l.i;
-        double rv = (r.type == IRType::FLOAT) ? r.f : (double)r.i;
+        double lv = l.isFloat() ? l.p.d : (double)l.p.i;
+        double rv = r.isFloat() ? r.p.d : (double)r.p.i;
         if (op == IROp::CMP_EQ)  return IRValue::fromInt(lv == rv ? 1 : 0);
         if (op == IROp::CMP_NEQ) return IRValue::fromInt(lv != rv ? 1 : 0);
         if (op == IROp::CMP_LT)  return IRValue::fromInt(lv  < rv ? 1 : 0);
         if (op == IROp::CMP_GT)  return IRValue::fromInt(lv  > rv ? 1 : 0);
     } else {
-        int lv = l.i, rv = r.i;
+        int lv = l.p.i, rv = r.p.i;
         if (op == IROp::CMP_EQ)  return IRValue::fromInt(lv == rv ? 1 : 0);
         if (op == IROp::CMP_NEQ) return IRValue::fromInt(lv != rv ? 1 : 0);
         if (op == IROp::CMP_LT)  return IRValue::fromInt(lv  < rv ? 1 : 0);
@@ -130,16 +150,64 @@ void IRVM::collectAllFields(const std::string& cls,
     }
 }
 
-void IRVM::initObjectFields(const std::string& cls, IRObject& obj) {
+// IR class fields carry source type names; TLLayout::defs wants TIR types.
+static TIR::Type fieldType(const std::string& s) {
+    if (s == "int"  || s == "bool") return TIR::Type::i32();
+    if (s == "float")               return TIR::Type::f64();
+    if (s == "char")                return TIR::Type::char_();
+    if (s == "string")              return TIR::Type::str();
+    if (s.size() > 2 && s.compare(s.size() - 2, 2, "[]") == 0)
+        return TIR::Type::arr(s.substr(0, s.size() - 2));
+    return TIR::Type::obj(s);
+}
+
+static IRValue defaultValue(const TIR::Type& ty) {
+    if (ty.isI32())  return IRValue::fromInt(0);
+    if (ty.isF64())  return IRValue::fromFloat(0.0);
+    if (ty.isChar()) return IRValue::fromChar('\0');
+    if (ty.isStr())  return IRValue::fromStr("");
+    return IRValue::nil();
+}
+
+const std::shared_ptr<const TLLayout>& IRVM::classLayout(const std::string& cls) {
+    auto it = layoutCache_.find(cls);
+    if (it != layoutCache_.end()) return it->second;
+    if (stringIds_.empty())
+        for (int i = 0; i < (int)prog_->strings.size(); ++i)
+            stringIds_.emplace(prog_->strings[i], i);
     std::vector<std::pair<std::string,std::string>> fields;
     collectAllFields(cls, fields);
+    auto layout = std::make_shared<TLLayout>();
+    layout->defs.reserve(fields.size());
     for (auto& [type, name] : fields) {
-        if      (type == "int"  || type == "bool") obj.fields[name] = IRValue::fromInt(0);
-        else if (type == "float")                  obj.fields[name] = IRValue::fromFloat(0.0);
-        else if (type == "char")                   obj.fields[name] = IRValue::fromChar('\0');
-        else if (type == "string")                 obj.fields[name] = IRValue::fromString("");
-        else                                       obj.fields[name] = IRValue::nil();
+        layout->defs.emplace_back(fieldType(type), name);
+        auto id = stringIds_.find(name);
+        layout->nameIds.push_back(id != stringIds_.end() ? id->second : -1);
     }
+    return layoutCache_[cls] = std::move(layout);
+}
+
+TLObject* IRVM::newObject(const std::string& cls) {
+    const auto& layout = classLayout(cls);
+    TLObject* obj = heap_.allocObject(cls);
+    obj->layout = layout;
+    obj->fields.reserve(layout->defs.size());
+    for (auto& f : layout->defs) obj->fields.push_back(defaultValue(f.first));
+    return obj;
+}
+
+// Index of ins's field in obj.  resolveForVM leaves it in aux (plus one);
+// the layout's name ids confirm it by string-table index, so a stale or
+// crafted aux falls back to the lookup by name instead of a wrong field.
+int IRVM::fieldSlot(const IRInstr& ins, const TLObject* obj) const {
+    int idx = ins.aux - 1;
+    if (idx >= 0 && obj->layout && idx < (int)obj->layout->nameIds.size() &&
+        obj->layout->nameIds[idx] == ins.sidx)
+        return idx;
+    int found = obj->fieldIndex(name(ins));
+    if (found < 0)
+        throw std::runtime_error("IRVM: field '" + name(ins) + "' not found in object of class " + obj->className);
+    return found;
 }
 
 // Walk the inheritance chain to find the nearest defining class for a method.
@@ -173,7 +241,7 @@ const IRFunction* IRVM::findMethodCached(const std::string& cls, const std::stri
 
 IRValue IRVM::callFunction(const std::string& funcKey,
                             const std::vector<IRValue>& args,
-                            const std::string& thisHandle,
+                            TLObject* thisObj,
                             const std::string& className) {
     auto it = prog_->functions.find(funcKey);
     if (it == prog_->functions.end())
@@ -185,52 +253,59 @@ IRValue IRVM::callFunction(const std::string& funcKey,
                                  " (expected " + std::to_string(fn.params.size()) +
                                  ", got " + std::to_string(args.size()) + ")");
 
-    VMFrame frame;
-    frame.className  = className.empty() ? fn.className : className;
-    frame.thisHandle = thisHandle;
+    VMFrame frame(fn.numSlots);
+    frame.fn        = &fn;
+    frame.className = className.empty() ? fn.className : className;
+    frame.thisObj   = thisObj;
 
-    // "Fields-as-locals": copy all object fields into scope[0] so that
+    // "Fields-as-locals": copy the object's fields into their slots so that
     // bare LOAD/STORE inside the method body transparently accesses object state.
-    if (!thisHandle.empty() && objHeap_.count(thisHandle)) {
-        for (auto& [fname, fval] : objHeap_.at(thisHandle).fields)
-            frame.scopes[0][fname] = fval;
+    // A subclass instance lays out the method class's fields first, so
+    // fieldSlots[i] pairs with fields[i].
+    size_t nf = 0;
+    if (thisObj) {
+        nf = std::min(fn.fieldSlots.size(), thisObj->fields.size());
+        for (size_t i = 0; i < nf; ++i)
+            frame.slots[fn.fieldSlots[i]] = thisObj->fields[i];
     }
 
     // Bind parameters (may shadow field names with the same name)
     for (size_t i = 0; i < args.size(); ++i)
-        frame.scopes[0][fn.params[i].second] = args[i];
+        frame.slots[fn.paramSlots[i]] = args[i];
 
     // Execute
-    IRValue result = runCode(fn.code, frame);
-
-    // Sync updated fields back to the object heap
-    if (!thisHandle.empty() && objHeap_.count(thisHandle)) {
-        for (auto& [fname, fval] : objHeap_.at(thisHandle).fields) {
-            if (frame.scopes[0].count(fname))
-                fval = frame.scopes[0].at(fname);
-        }
+    callStack_.push_back(&frame);
+    IRValue result;
+    try {
+        result = runCode(fn.code, frame);
+    } catch (...) {
+        callStack_.pop_back();
+        throw;
     }
+    callStack_.pop_back();
+
+    // Sync updated fields back to the object
+    for (size_t i = 0; i < nf; ++i)
+        thisObj->fields[i] = frame.slots[fn.fieldSlots[i]];
 
     return result;
 }
 
+void IRVM::resyncFields(VMFrame& frame, const TLObject* obj) {
+    if (!frame.fn) return;
+    size_t nf = std::min(frame.fn->fieldSlots.size(), obj->fields.size());
+    for (size_t i = 0; i < nf; ++i)
+        frame.slots[frame.fn->fieldSlots[i]] = obj->fields[i];
+}
+
 // ===========================================================================
 // Main execution loop
 // ===========================================================================
 
-// Pre-scan a code block to build label → next-instruction index.
-static std::unordered_map<std::string, size_t>
-buildLabelMap(const std::vector<IRInstr>& code) {
-    std::unordered_map<std::string, size_t> m;
-    for (size_t i = 0; i < code.size(); ++i)
-        if (code[i].op == IROp::LABEL)
-            m[code[i].sval] = i + 1;
-    return m;
-}
-
+// Jump targets were resolved to instruction indices by resolveJumps, so a
+// call does no per-invocation setup beyond its frame.
 IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
-    auto labels = buildLabelMap(code);
-    size_t ip   = 0;
+    size_t ip = 0;
 
     while (ip < code.size()) {
         const auto& ins = code[ip];
@@ -242,33 +317,57 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
         case IROp::LABEL:
             break;
 
+        case IROp::DECLARE:
+        case IROp::STORE:
+        case IROp::ENTER_SCOPE:
+        case IROp::EXIT_SCOPE:
+            throw std::runtime_error("IRVM: unresolved variable op (run resolveForVM)");
+
         // ---- Push constants ----
         case IROp::PUSH_INT:   push(IRValue::fromInt(ins.ival));    break;
         case IROp::PUSH_FLOAT: push(IRValue::fromFloat(ins.dval));  break;
-        case IROp::PUSH_STR:   push(IRValue::fromString(ins.sval)); break;
+        case IROp::PUSH_STR:   push(IRValue::fromStr(name(ins)));    break;
         case IROp::PUSH_CHAR:  push(IRValue::fromChar(ins.cval));   break;
         case IROp::PUSH_BOOL:  push(IRValue::fromInt(ins.ival));    break;
 
         // ---- Variable access ----
-        case IROp::LOAD:
-            push(frame.get(ins.sval));
+        case IROp::LOAD_SLOT:
+            push(frame.slots[ins.ival]);
             break;
 
-        case IROp::DECLARE:
-            frame.declare(ins.sval, pop());
+        case IROp::STORE_SLOT:
+            frame.slots[ins.ival] = pop();
             break;
 
-        case IROp::STORE:
-            frame.set(ins.sval, pop());
+        case IROp::LOAD_SLOT2:
+            push(frame.slots[ins.ival]);
+            push(frame.slots[ins.aux]);
+            break;
+
+        case IROp::MOVE_SLOT:
+            frame.slots[ins.ival] = frame.slots[ins.aux];
+            break;
+
+        case IROp::STORE_LOAD_SLOT:
+            frame.slots[ins.ival] = pop();
+            push(frame.slots[ins.aux]);
             break;
 
+        case IROp::INC_SLOT: {
+            IRValue& v = frame.slots[ins.ival];
+            if (v.tag == TLValue::Tag::I32) v.p.i += ins.aux;
+            else v = arith(v, IRValue::fromInt(ins.aux), IROp::ADD);
+            break;
+        }
+
+        // resolveSlots leaves a LOAD only when the name has no binding.
+        case IROp::LOAD:
+            throw std::runtime_error("Undefined variable: " + name(ins));
+
         case IROp::POP:
             pop();
             break;
 
-        // ---- Scope management ----
-        case IROp::ENTER_SCOPE: frame.pushScope(); break;
-        case IROp::EXIT_SCOPE:  frame.popScope();  break;
 
         // ---- Arithmetic ----
         case IROp::ADD: { auto r=pop(), l=pop(); push(arith(l,r,IROp::ADD)); break; }
@@ -277,7 +376,7 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
         case IROp::DIV: { auto r=pop(), l=pop(); push(arith(l,r,IROp::DIV)); break; }
         case IROp::NEG: {
             auto v = pop();
-            push(v.type == IRType::FLOAT ? IRValue::fromFloat(-v.f) : IRValue::fromInt(-v.i));
+            push(v.isFloat() ? IRValue::fromFloat(-v.p.d) : IRValue::fromInt(-v.p.i));
             break;
         }
 
@@ -298,18 +397,47 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
 
         // ---- Control flow ----
         case IROp::JUMP:
-            if (!labels.count(ins.sval))
-                throw std::runtime_error("IRVM: undefined label: " + ins.sval);
-            ip = labels.at(ins.sval);
+            if (ins.ival < 0)
+                throw std::runtime_error("IRVM: undefined label: " + name(ins));
+            ip = (size_t)ins.ival;
             jumped = true;
             break;
 
         case IROp::JUMP_FALSE: {
             auto v = pop();
             if (!v.isTruthy()) {
-                if (!labels.count(ins.sval))
-                    throw std::runtime_error("IRVM: undefined label: " + ins.sval);
-                ip = labels.at(ins.sval);
+                if (ins.ival < 0)
+                    throw std::runtime_error("IRVM: undefined label: " + name(ins));
+                ip = (size_t)ins.ival;
+                jumped = true;
+            }
+            break;
+        }
+
+        case IROp::CMP_LT_JUMP_FALSE:
+        case IROp::CMP_GT_JUMP_FALSE:
+        case IROp::CMP_EQ_JUMP_FALSE:
+        case IROp::CMP_NEQ_JUMP_FALSE: {
+            auto r = pop(), l = pop();
+            bool cond;
+            if (l.tag == TLValue::Tag::I32 && r.tag == TLValue::Tag::I32) {
+                switch (ins.op) {
+                    case IROp::CMP_LT_JUMP_FALSE: cond = l.p.i <  r.p.i; break;
+                    case IROp::CMP_GT_JUMP_FALSE: cond = l.p.i >  r.p.i; break;
+                    case IROp::CMP_EQ_JUMP_FALSE: cond = l.p.i == r.p.i; break;
+                    default:                      cond = l.p.i != r.p.i; break;
+                }
+            } else {
+                IROp cmp = ins.op == IROp::CMP_LT_JUMP_FALSE ? IROp::CMP_LT
+                         : ins.op == IROp::CMP_GT_JUMP_FALSE ? IROp::CMP_GT
+                         : ins.op == IROp::CMP_EQ_JUMP_FALSE ? IROp::CMP_EQ
+                         :                                     IROp::CMP_NEQ;
+                cond = compare(l, r, cmp).isTruthy();
+            }
+            if (!cond) {
+                if (ins.ival < 0)
+                    throw std::runtime_error("IRVM: undefined label: " + name(ins));
+                ip = (size_t)ins.ival;
                 jumped = true;
             }
             break;
@@ -322,23 +450,27 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
         // ---- I/O ----
         case IROp::PRINT: {
             auto v = pop();
-            switch (v.type) {
-                case IRType::STRING: std::cout << v.s   << "\n"; break;
-                case IRType::FLOAT:  std::cout << v.f   << "\n"; break;
-                case IRType::CHAR:   std::cout << v.c   << "\n"; break;
-                default:             std::cout << v.i   << "\n"; break;
+            OutBuf& out = OutBuf::instance();
+            switch (v.tag) {
+                case TLValue::Tag::Str:
+                case TLValue::Tag::StrView: out.str(v.str()); break;
+                case TLValue::Tag::F64:     out.f64(v.p.d);   break;
+                case TLValue::Tag::Char:    out.ch(v.p.c);    break;
+                case TLValue::Tag::Obj:
+                case TLValue::Tag::Arr:     out.i32(0);       break;
+                default:                    out.i32(v.p.i);   break;
             }
+            out.newline();
             break;
         }
         case IROp::INPUT: {
-            int val; std::cin >> val;
-            push(IRValue::fromInt(val));
+            push(IRValue::fromInt(InBuf::instance().nextInt()));
             break;
         }
         case IROp::READ_FILE: {
-            std::ifstream file(ins.sval);
+            std::ifstream file(name(ins));
             if (!file.is_open())
-                throw std::runtime_error("IRVM: cannot open file: " + ins.sval);
+                throw std::runtime_error("IRVM: cannot open file: " + name(ins));
             int val; file >> val;
             push(IRValue::fromInt(val));
             break;
@@ -347,26 +479,26 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
         // ---- Casts ----
         case IROp::CAST_INT: {
             auto v = pop();
-            if (v.type == IRType::FLOAT)  { push(IRValue::fromInt((int)v.f)); break; }
-            if (v.type == IRType::CHAR)   { push(IRValue::fromInt((int)v.c)); break; }
-            if (v.type == IRType::STRING) {
-                try { push(IRValue::fromInt(std::stoi(v.s))); }
+            if (v.isFloat())                   { push(IRValue::fromInt((int)v.p.d)); break; }
+            if (v.tag == TLValue::Tag::Char)   { push(IRValue::fromInt((int)v.p.c)); break; }
+            if (v.isStr()) {
+                try { push(IRValue::fromInt(std::stoi(std::string(v.str())))); }
                 catch (...) { push(IRValue::fromInt(0)); }
                 break;
             }
-            push(IRValue::fromInt(v.i));
+            push(IRValue::fromInt(v.p.i));
             break;
         }
         case IROp::CAST_FLOAT: {
             auto v = pop();
-            if (v.type == IRType::INT)  { push(IRValue::fromFloat((double)v.i)); break; }
-            if (v.type == IRType::CHAR) { push(IRValue::fromFloat((double)(int)v.c)); break; }
-            push(IRValue::fromFloat(v.f));
+            if (v.tag == TLValue::Tag::Char) { push(IRValue::fromFloat((double)(int)v.p.c)); break; }
+            if (!v.isFloat())                { push(IRValue::fromFloat((double)v.p.i)); break; }
+            push(IRValue::fromFloat(v.p.d));
             break;
         }
         case IROp::CAST_CHAR: {
             auto v = pop();
-            push(IRValue::fromChar(v.type == IRType::INT ? (char)v.i : v.c));
+            push(IRValue::fromChar(v.tag == TLValue::Tag::Char ? v.p.c : (char)v.p.i));
             break;
         }
         case IROp::CAST_BOOL: {
@@ -376,7 +508,7 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
         }
         case IROp::CAST_STR: {
             auto v = pop();
-            push(IRValue::fromString(valueToString(v)));
+            push(v.isStr() ? std::move(v) : IRValue::fromStr(valueToString(v)));
             break;
         }
 
@@ -385,60 +517,61 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
             int argc = ins.ival;
             std::vector<IRValue> args(argc);
             for (int k = argc - 1; k >= 0; --k) args[k] = pop();
-            push(callFunction(ins.sval, args));
+            push(callFunction(name(ins), args));
             break;
         }
 
         // ---- Object ----
         case IROp::PUSH_THIS:
-            push(IRValue::objHandle(frame.thisHandle));
+            push(IRValue::fromObj(frame.thisObj));
             break;
 
         case IROp::NEW_OBJ: {
+            // Collect while the constructor args are still rooted on the stack.
+            if (heap_.shouldCollect()) runGC();
             int argc = ins.ival;
             std::vector<IRValue> args(argc);
             for (int k = argc - 1; k >= 0; --k) args[k] = pop();
 
-            std::string handle = newHandle("obj");
-            IRObject obj;
-            obj.className = ins.sval;
-            initObjectFields(ins.sval, obj);
-            objHeap_[handle] = std::move(obj);
-
-            // Call constructor if args provided
+            TLObject* obj = newObject(name(ins));
+            // Rooted as the constructor's "this" while init runs.
             if (argc > 0) {
-                std::string initKey = ins.sval + "::init";
+                std::string initKey = name(ins) + "::init";
                 if (prog_->functions.count(initKey))
-                    callFunction(initKey, args, handle, ins.sval);
+                    callFunction(initKey, args, obj, name(ins));
             }
-            push(IRValue::objHandle(handle));
+            push(IRValue::fromObj(obj));
+            break;
+        }
+
+        case IROp::LOAD_FIELD_THIS: {
+            TLObject* obj = frame.thisObj;
+            if (!obj)
+                throw std::runtime_error("IRVM: LOAD_FIELD " + name(ins) + " on a non-object");
+            push(obj->fields[fieldSlot(ins, obj)]);
             break;
         }
 
         case IROp::LOAD_FIELD: {
             auto objVal = pop();
-            // May be an OBJ_HANDLE or even a STRING if the old array-proxy hack is used
-            std::string handle = objVal.s;
-            if (!objHeap_.count(handle))
-                throw std::runtime_error("IRVM: unknown object handle '" + handle + "' for LOAD_FIELD " + ins.sval);
-            auto& obj = objHeap_.at(handle);
-            if (!obj.fields.count(ins.sval))
-                throw std::runtime_error("IRVM: field '" + ins.sval + "' not found in object of class " + obj.className);
-            push(obj.fields.at(ins.sval));
+            if (!objVal.isObj() || !objVal.p.obj)
+                throw std::runtime_error("IRVM: LOAD_FIELD " + name(ins) + " on a non-object");
+            push(objVal.p.obj->fields[fieldSlot(ins, objVal.p.obj)]);
             break;
         }
 
         case IROp::STORE_FIELD: {
-            // Stack (top→bottom): value, obj_handle
+            // Stack (top→bottom): value, obj
             auto val    = pop();
             auto objVal = pop();
-            std::string handle = objVal.s;
-            if (!objHeap_.count(handle))
-                throw std::runtime_error("IRVM: unknown object handle '" + handle + "' for STORE_FIELD " + ins.sval);
-            objHeap_.at(handle).fields[ins.sval] = val;
+            if (!objVal.isObj() || !objVal.p.obj)
+                throw std::runtime_error("IRVM: STORE_FIELD " + name(ins) + " on a non-object");
+            TLObject* obj = objVal.p.obj;
+            int idx = fieldSlot(ins, obj);
             // Reflect change into current frame if this is the current "this" object
-            if (handle == frame.thisHandle && frame.scopes[0].count(ins.sval))
-                frame.scopes[0][ins.sval] = val;
+            if (obj == frame.thisObj && frame.fn && idx < (int)frame.fn->fieldSlots.size())
+                frame.slots[frame.fn->fieldSlots[idx]] = val;
+            obj->fields[idx] = std::move(val);
             break;
         }
 
@@ -446,23 +579,20 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
             int argc = ins.ival;
             std::vector<IRValue> args(argc);
             for (int k = argc - 1; k >= 0; --k) args[k] = pop();
-            auto objVal = pop(); // obj handle (bottom of args-and-handle region)
-            std::string handle = objVal.s;
-            if (!objHeap_.count(handle))
-                throw std::runtime_error("IRVM: unknown object handle '" + handle + "' for CALL_METHOD " + ins.sval);
-            std::string cls = objHeap_.at(handle).className;
-            const IRFunction* fn = findMethodCached(cls, ins.sval);
+            auto objVal = pop(); // receiver (bottom of args-and-receiver region)
+            if (!objVal.isObj() || !objVal.p.obj)
+                throw std::runtime_error("IRVM: CALL_METHOD " + name(ins) + " on a non-object");
+            TLObject* obj = objVal.p.obj;
+            const std::string& cls = obj->className;
+            const IRFunction* fn = findMethodCached(cls, name(ins));
             if (!fn)
-                throw std::runtime_error("IRVM: method '" + ins.sval + "' not found in class " + cls);
+                throw std::runtime_error("IRVM: method '" + name(ins) + "' not found in class " + cls);
             std::string funcKey = fn->className + "::" + fn->name;
-            auto result = callFunction(funcKey, args, handle, cls);
+            auto result = callFunction(funcKey, args, obj, cls);
             // After the call the method may have altered the object's fields;
             // if the object is also the current "this", keep frame.scopes[0] in sync
-            if (handle == frame.thisHandle && objHeap_.count(handle)) {
-                for (auto& [fname, fval] : objHeap_.at(handle).fields)
-                    if (frame.scopes[0].count(fname)) frame.scopes[0][fname] = fval;
-            }
-            push(result);
+            if (obj == frame.thisObj) resyncFields(frame, obj);
+            push(std::move(result));
             break;
         }
 
@@ -477,68 +607,63 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
             std::string baseClass = ci->second.baseClass;
             if (baseClass.empty())
                 throw std::runtime_error("IRVM: CALL_SUPER: class '" + frame.className + "' has no base class");
-            const IRFunction* fn = findMethodCached(baseClass, ins.sval);
+            const IRFunction* fn = findMethodCached(baseClass, name(ins));
             if (!fn)
-                throw std::runtime_error("IRVM: super method '" + ins.sval + "' not found in base " + baseClass);
+                throw std::runtime_error("IRVM: super method '" + name(ins) + "' not found in base " + baseClass);
             std::string funcKey = fn->className + "::" + fn->name;
-            auto result = callFunction(funcKey, args, frame.thisHandle, baseClass);
+            auto result = callFunction(funcKey, args, frame.thisObj, baseClass);
             // Re-sync: the super call may have updated the shared object
-            if (!frame.thisHandle.empty() && objHeap_.count(frame.thisHandle)) {
-                for (auto& [fname, fval] : objHeap_.at(frame.thisHandle).fields)
-                    if (frame.scopes[0].count(fname)) frame.scopes[0][fname] = fval;
-            }
-            push(result);
+            if (frame.thisObj) resyncFields(frame, frame.thisObj);
+            push(std::move(result));
             break;
         }
 
         // ---- Arrays ----
         case IROp::NEW_ARRAY: {
-            std::string elemType = ins.sval;
+            // Collect while literal elements / the size are still on the stack.
+            if (heap_.shouldCollect()) runGC();
+            const std::string& elemType = name(ins);
             int litCount = ins.ival;
-            std::string handle = newHandle("arr");
-            IRArray arr;
-            arr.elemType = elemType;
+            TLArray* arr = heap_.allocArray(elemType);
 
             if (litCount == -1) {
                 // Size is on the stack
-                int size = pop().i;
-                IRValue def;
-                if      (elemType == "float")  def = IRValue::fromFloat(0.0);
-                else if (elemType == "char")   def = IRValue::fromChar('\0');
-                else if (elemType == "string") def = IRValue::fromString("");
-                else                           def = IRValue::fromInt(0);
-
-                // Object arrays: create individual object instances
+                int size = pop().p.i;
+                if (size < 0)
+                    throw std::runtime_error("IRVM: negative array size: " + std::to_string(size));
+                // Object arrays: create individual object instances.  No GC
+                // runs inside this loop, so the unrooted array is safe.
                 if (prog_->classes.count(elemType)) {
-                    for (int k = 0; k < size; ++k) {
-                        std::string oHandle = newHandle("obj");
-                        IRObject obj;
-                        obj.className = elemType;
-                        initObjectFields(elemType, obj);
-                        objHeap_[oHandle] = std::move(obj);
-                        arr.elements.push_back(IRValue::objHandle(oHandle));
-                    }
+                    arr->elements.reserve(size);
+                    for (int k = 0; k < size; ++k)
+                        arr->elements.push_back(IRValue::fromObj(newObject(elemType)));
                 } else {
-                    arr.elements.assign(size, def);
+                    IRValue def;
+                    if      (elemType == "float")  def = IRValue::fromFloat(0.0);
+                    else if (elemType == "char")   def = IRValue::fromChar('\0');
+                    else if (elemType == "string") def = IRValue::fromStr("");
+                    else                           def = IRValue::fromInt(0);
+                    arr->elements.assign(size, def);
                 }
             } else {
                 // Literal: pop litCount values (were pushed first-to-last → reverse)
-                arr.elements.resize(litCount);
-                for (int k = litCount - 1; k >= 0; --k) arr.elements[k] = pop();
+                arr->elements.resize(litCount);
+                for (int k = litCount - 1; k >= 0; --k) arr->elements[k] = pop();
             }
-            arrHeap_[handle] = std::move(arr);
-            push(IRValue::arrHandle(handle));
+            push(IRValue::fromArr(arr));
             break;
         }
 
         case IROp::ARRAY_LOAD: {
             auto idxVal = pop();
             auto arrVal = pop();
-            auto& arr   = arrHeap_.at(arrVal.s);
-            int idx = idxVal.i;
-            if (idx < 0 || idx >= (int)arr.elements.size())
+            if (!arrVal.isArr() || !arrVal.p.arr)
+                throw std::runtime_error("IRVM: ARRAY_LOAD on a non-array");
+            TLArray* arr = arrVal.p.arr;
+            int idx = idxVal.p.i;
+            if (idx < 0 || idx >= (int)arr->elements.size())
                 throw std::runtime_error("IRVM: array index out of bounds: " + std::to_string(idx));
-            push(arr.elements[idx]);
+            push(arr->elements[idx]);
             break;
         }
 
@@ -546,11 +671,13 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
             auto val    = pop();
             auto idxVal = pop();
             auto arrVal = pop();
-            auto& arr   = arrHeap_.at(arrVal.s);
-            int idx = idxVal.i;
-            if (idx < 0 || idx >= (int)arr.elements.size())
+            if (!arrVal.isArr() || !arrVal.p.arr)
+                throw std::runtime_error("IRVM: ARRAY_STORE on a non-array");
+            TLArray* arr = arrVal.p.arr;
+            int idx = idxVal.p.i;
+            if (idx < 0 || idx >= (int)arr->elements.size())
                 throw std::runtime_error("IRVM: array index out of bounds: " + std::to_string(idx));
-            arr.elements[idx] = val;
+            arr->elements[idx] = std::move(val);
             break;
         }
 
@@ -569,9 +696,14 @@ IRValue IRVM::runCode(const std::vector<IRInstr>& code, VMFrame& frame) {
 // ===========================================================================
 
 void IRVM::run(const IRProgram& prog) {
+    OutFlushGuard flushOnExit;
+    if (!prog.slotsResolved || !prog.jumpsResolved)
+        throw std::runtime_error("IRVM: program must go through resolveForVM first");
     prog_ = &prog;
-    VMFrame mainFrame;
+    VMFrame mainFrame(prog.mainSlots);
+    callStack_.push_back(&mainFrame);
     runCode(prog.main, mainFrame);
+    callStack_.pop_back();
 }
 
 void runIR(const IRProgram& prog) {
@@ -1,93 +1,35 @@
 #pragma once
 #include "ir.hpp"
+#include "object.hpp"
 #include <string>
+#include <stdexcept>
 #include <vector>
 #include <unordered_map>
 
 // ===========================================================================
-// Runtime value type
+// Runtime values and heap
+//
+// IRVM shares the production object model with TIRVM (runtime/heap/object.hpp):
+// values are TLValue, objects and arrays are TLObject* / TLArray* owned by a
+// TLHeap and reclaimed by mark-and-sweep.  Booleans are I32 0/1, as the IR
+// has always treated them.
 // ===========================================================================
-enum class IRType { NIL, INT, FLOAT, CHAR, STRING, OBJ_HANDLE, ARR_HANDLE };
-
-struct IRValue {
-    IRType      type = IRType::NIL;
-    int         i    = 0;
-    double      f    = 0.0;
-    char        c    = 0;
-    std::string s;   // STRING text, or handle ID for OBJ_HANDLE / ARR_HANDLE
-
-    // Factories
-    static IRValue nil()                              { return {}; }
-    static IRValue fromInt(int v)                     { IRValue r; r.type=IRType::INT;    r.i=v; return r; }
-    static IRValue fromFloat(double v)                { IRValue r; r.type=IRType::FLOAT;  r.f=v; return r; }
-    static IRValue fromChar(char v)                   { IRValue r; r.type=IRType::CHAR;   r.c=v; return r; }
-    static IRValue fromString(const std::string& v)   { IRValue r; r.type=IRType::STRING; r.s=v; return r; }
-    static IRValue fromBool(bool v)                   { return fromInt(v ? 1 : 0); }
-    static IRValue objHandle(const std::string& h)    { IRValue r; r.type=IRType::OBJ_HANDLE; r.s=h; return r; }
-    static IRValue arrHandle(const std::string& h)    { IRValue r; r.type=IRType::ARR_HANDLE; r.s=h; return r; }
-
-    bool isTruthy() const {
-        if (type == IRType::FLOAT)  return f != 0.0;
-        if (type == IRType::CHAR)   return c != 0;
-        if (type == IRType::STRING ||
-            type == IRType::OBJ_HANDLE ||
-            type == IRType::ARR_HANDLE) return !s.empty();
-        return i != 0;
-    }
-};
-
-// ===========================================================================
-// Heap objects / arrays
-// ===========================================================================
-struct IRObject {
-    std::string className;
-    std::unordered_map<std::string, IRValue> fields;
-};
-
-struct IRArray {
-    std::string elemType;
-    std::vector<IRValue> elements;
-};
+using IRValue = TLValue;
 
 // ===========================================================================
 // Call frame  (one per active function invocation)
+//
+// Locals live in a flat slot array; resolveSlots (irresolve.hpp) has already
+// mapped every variable to its slot, so LOAD_SLOT / STORE_SLOT are a single
+// index.
 // ===========================================================================
 struct VMFrame {
-    // Stack of nested scopes; index 0 is the function's outermost scope
-    std::vector<std::unordered_map<std::string, IRValue>> scopes;
+    std::vector<IRValue> slots;
+    const IRFunction*    fn = nullptr;  // executing function (null for main)
     std::string className;    // class of the executing method ("" for free functions)
-    std::string thisHandle;   // "this" object handle ("" for free functions)
+    TLObject*   thisObj = nullptr;  // "this" object (null for free functions)
 
-    VMFrame() { scopes.push_back({}); }
-
-    void pushScope() { scopes.push_back({}); }
-    void popScope()  { if (scopes.size() > 1) scopes.pop_back(); }
-
-    // Walk scopes from innermost to outermost.
-    IRValue get(const std::string& name) const {
-        for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
-            auto f = it->find(name);
-            if (f != it->end()) return f->second;
-        }
-        throw std::runtime_error("Undefined variable: " + name);
-    }
-
-    // Update nearest existing scope, or create in outermost (scope[0]).
-    // The outermost fallback ensures SSA-renamed temporaries (x$0, x$1 …)
-    // that are first written inside a nested scope survive EXIT_SCOPE.
-    // User-visible variables are always DECLAREd before STOREd, so for them
-    // the walk always finds the binding and the fallback never fires.
-    void set(const std::string& name, const IRValue& val) {
-        for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
-            if (it->count(name)) { (*it)[name] = val; return; }
-        }
-        scopes.front()[name] = val; // fallback: outermost scope survives EXIT_SCOPE
-    }
-
-    // Always create/overwrite in innermost scope (for DECLARE).
-    void declare(const std::string& name, const IRValue& val) {
-        scopes.back()[name] = val;
-    }
+    explicit VMFrame(int numSlots) : slots(numSlots) {}
 };
 
 // ===========================================================================
@@ -100,14 +42,24 @@ public:
 private:
     const IRProgram*                            prog_ = nullptr;
     std::vector<IRValue>                        stack_;
-    std::unordered_map<std::string, IRObject>   objHeap_;
-    std::unordered_map<std::string, IRArray>    arrHeap_;
-    int                                         handleCounter_ = 0;
+    TLHeap                                      heap_;
+    std::vector<VMFrame*>                       callStack_;  // active frames — GC roots
+
+    // An instruction's string operand (via IRInstr::sidx — IRProgram::strings).
+    const std::string& name(const IRInstr& ins) const {
+        static const std::string none;
+        return ins.sidx >= 0 ? prog_->strings[ins.sidx] : none;
+    }
 
-    std::string newHandle(const std::string& pfx = "h");
     void   push(const IRValue& v) { stack_.push_back(v); }
+    void   push(IRValue&& v)      { stack_.push_back(std::move(v)); }
     IRValue pop();
 
+    // Mark everything reachable from the operand stack and callStack_, then
+    // sweep.  Only called at the start of NEW_OBJ / NEW_ARRAY, while their
+    // operands are still on the stack.
+    void runGC();
+
     // Helpers
     std::string valueToString(const IRValue& v) const;
     IRValue arith  (const IRValue& l, const IRValue& r, IROp op);
@@ -116,13 +68,20 @@ private:
     // Class hierarchy utilities
     void collectAllFields(const std::string& cls,
                           std::vector<std::pair<std::string,std::string>>& out) const;
-    void initObjectFields(const std::string& cls, IRObject& obj);
+    // Flattened (type, name) field layout per class, built on first use.
+    const std::shared_ptr<const TLLayout>& classLayout(const std::string& cls);
+    TLObject* newObject(const std::string& cls);
+    // Field index of a LOAD_FIELD / STORE_FIELD / LOAD_FIELD_THIS in obj.
+    int fieldSlot(const IRInstr& ins, const TLObject* obj) const;
     const IRFunction* findMethod(const std::string& cls, const std::string& method) const;
     // Cached variant — avoids re-walking the inheritance chain on repeated calls.
     const IRFunction* findMethodCached(const std::string& cls, const std::string& method);
 
     // One-slot inline cache: key "ClassName::methodName" → resolved IRFunction*.
     std::unordered_map<std::string, const IRFunction*> methodCache_;
+    std::unordered_map<std::string, std::shared_ptr<const TLLayout>> layoutCache_;
+    // IRProgram::strings index of each string, for TLLayout::nameIds.
+    std::unordered_map<std::string, int> stringIds_;
 
     // Execute a code block inside a given frame; returns the return value.
     IRValue runCode(const std::vector<IRInstr>& code, VMFrame& frame);
@@ -130,8 +89,12 @@ private:
     // Call a compiled function (free or method); manages frames and field sync.
     IRValue callFunction(const std::string& funcKey,
                          const std::vector<IRValue>& args,
-                         const std::string& thisHandle = "",
+                         TLObject* thisObj = nullptr,
                          const std::string& className  = "");
+
+    // Copy the object's fields back into their frame slots after a call that
+    // may have modified them (fields-as-locals).
+    static void resyncFields(VMFrame& frame, const TLObject* obj);
 };
 
 // Public entry point
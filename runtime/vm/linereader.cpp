@@ -0,0 +1,69 @@
+#include "linereader.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+LineReader::~LineReader() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+bool LineReader::open(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) return false;
+    buf_.reset(new char[BUF_SIZE]);
+    return true;
+}
+
+bool LineReader::fill() {
+    pos_ = end_ = 0;
+    if (atEof_ || fd_ < 0) return false;
+    while (true) {
+        ssize_t n = ::read(fd_, buf_.get(), BUF_SIZE);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) { atEof_ = true; return false; }
+        end_ = (size_t)n;
+        return true;
+    }
+}
+
+bool LineReader::readLine(std::string& out) {
+    out.clear();
+    bool gotAny = false;
+    while (true) {
+        if (pos_ == end_ && !fill()) break;
+        const char* start = buf_.get() + pos_;
+        const char* nl = static_cast<const char*>(std::memchr(start, '\n', end_ - pos_));
+        if (nl) {
+            out.append(start, nl - start);
+            pos_ += (nl - start) + 1;
+            if (!out.empty() && out.back() == '\r') out.pop_back();
+            return true;
+        }
+        // Line continues past the buffer: keep what we have and refill.
+        out.append(start, end_ - pos_);
+        pos_ = end_;
+        gotAny = true;
+    }
+    if (!out.empty() && out.back() == '\r') out.pop_back();
+    return gotAny;
+}
+
+std::string LineReader::readChunk(size_t n) {
+    std::string out;
+    out.reserve(std::min(n, BUF_SIZE));
+    while (out.size() < n) {
+        if (pos_ == end_ && !fill()) break;
+        size_t take = std::min(n - out.size(), end_ - pos_);
+        out.append(buf_.get() + pos_, take);
+        pos_ += take;
+    }
+    return out;
+}
+
+bool LineReader::eof() {
+    if (pos_ < end_) return false;
+    return !fill();
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <memory>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// LineReader – buffered, forward-only file reader behind the __tl_reader_*
+// builtins.
+//
+// Design notes:
+//   • One fixed BUF_SIZE buffer per reader, refilled with read(2); memory use
+//     is bounded by the buffer plus the longest line, whatever the file size.
+//   • readLine() scans with memchr and copies the line straight into the
+//     caller's string — no intermediate allocation per line.
+//   • Lines are returned without their terminator ("\n" or "\r\n").
+// ---------------------------------------------------------------------------
+
+class LineReader {
+public:
+    static constexpr size_t BUF_SIZE = 256 * 1024;
+
+    LineReader() = default;
+    ~LineReader();
+    LineReader(const LineReader&)            = delete;
+    LineReader& operator=(const LineReader&) = delete;
+
+    bool open(const std::string& path);
+
+    // Reads the next line into out.  Returns false (out empty) at EOF.
+    bool readLine(std::string& out);
+
+    // Reads up to n bytes; returns fewer only at EOF.
+    std::string readChunk(size_t n);
+
+    // True once every byte of the file has been consumed.
+    bool eof();
+
+private:
+    int                     fd_    = -1;
+    std::unique_ptr<char[]> buf_;
+    size_t                  pos_   = 0;   // next unread byte in buf_
+    size_t                  end_   = 0;   // one past the last valid byte
+    bool                    atEof_ = false;
+
+    // Refill buf_ after it has been fully consumed.  False at EOF / error.
+    bool fill();
+};
@@ -0,0 +1,1267 @@
+#include "natives.hpp"
+#include "outbuf.hpp"
+#include "inbuf.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Default value for a given TIR type
+// ─────────────────────────────────────────────────────────────────────────────
+
+TLValue tlDefault(const TIR::Type& ty) {
+    if (ty.isI32() || ty.isI1()) return TLValue::fromInt(0);
+    if (ty.isF64())               return TLValue::fromFloat(0.0);
+    if (ty.isChar())              return TLValue::fromChar('\0');
+    if (ty.isStr())               return TLValue::fromStr("");
+    return TLValue::nil();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Value → string (for print and string concatenation)
+// ─────────────────────────────────────────────────────────────────────────────
+
+std::string tlToString(const TLValue& v) {
+    switch (v.tag) {
+    case TLValue::Tag::Bool:
+    case TLValue::Tag::I32:  return std::to_string(v.p.i);
+    case TLValue::Tag::F64: {
+        std::string s = std::to_string(v.p.d);
+        s.erase(s.find_last_not_of('0') + 1);
+        if (s.back() == '.') s.pop_back();
+        return s;
+    }
+    case TLValue::Tag::Char: return std::string(1, v.p.c);
+    case TLValue::Tag::Str:  return v.sval;
+    case TLValue::Tag::StrView: return std::string(v.str());
+    case TLValue::Tag::Obj:  return v.p.obj ? "[" + v.p.obj->className + "]" : "null";
+    case TLValue::Tag::Arr:  return "[array]";
+    default:                 return "nil";
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Arithmetic
+// ─────────────────────────────────────────────────────────────────────────────
+
+TLValue tlArith(const TLValue& l, const TLValue& r, TIR::Op op) {
+    // String concatenation via +
+    if (op == TIR::Op::Add && (l.isStr() || r.isStr()))
+        return TLValue::fromStr(tlToString(l) + tlToString(r));
+
+    // Float promotion
+    bool isFloat = (l.tag == TLValue::Tag::F64 || r.tag == TLValue::Tag::F64);
+    if (isFloat) {
+        double lv = (l.tag==TLValue::Tag::F64)  ? l.p.d
+                  : (l.tag==TLValue::Tag::Char) ? (double)(unsigned char)l.p.c
+                  : (double)l.p.i;
+        double rv = (r.tag==TLValue::Tag::F64)  ? r.p.d
+                  : (r.tag==TLValue::Tag::Char) ? (double)(unsigned char)r.p.c
+                  : (double)r.p.i;
+        switch (op) {
+        case TIR::Op::Add: return TLValue::fromFloat(lv + rv);
+        case TIR::Op::Sub: return TLValue::fromFloat(lv - rv);
+        case TIR::Op::Mul: return TLValue::fromFloat(lv * rv);
+        case TIR::Op::Div:
+            if (rv == 0.0) throw std::runtime_error("division by zero");
+            return TLValue::fromFloat(lv / rv);
+        default: break;
+        }
+    }
+
+    int lv = (l.tag==TLValue::Tag::Char) ? (int)(unsigned char)l.p.c : l.p.i;
+    int rv = (r.tag==TLValue::Tag::Char) ? (int)(unsigned char)r.p.c : r.p.i;
+    switch (op) {
+    case TIR::Op::Add: return TLValue::fromInt(lv + rv);
+    case TIR::Op::Sub: return TLValue::fromInt(lv - rv);
+    case TIR::Op::Mul: return TLValue::fromInt(lv * rv);
+    case TIR::Op::Div:
+        if (rv == 0) throw std::runtime_error("division by zero");
+        return TLValue::fromInt(lv / rv);
+    default: break;
+    }
+    throw std::runtime_error("unsupported arithmetic op");
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Comparison
+// ─────────────────────────────────────────────────────────────────────────────
+
+TLValue tlCompare(const TLValue& l, const TLValue& r, TIR::Op op) {
+    // String comparison by value
+    if (l.isStr() && r.isStr()) {
+        // Compare in place — views into a mapped file are not copied.
+        std::string_view ls = l.str(), rs = r.str();
+        if (op == TIR::Op::CmpEq) return TLValue::fromInt(ls==rs ? 1 : 0);
+        if (op == TIR::Op::CmpNe) return TLValue::fromInt(ls!=rs ? 1 : 0);
+        throw std::runtime_error("< / > not supported for strings");
+    }
+    if (l.isStr() || r.isStr()) {
+        std::string ls = tlToString(l), rs = tlToString(r);
+        if (op == TIR::Op::CmpEq) return TLValue::fromInt(ls==rs ? 1 : 0);
+        if (op == TIR::Op::CmpNe) return TLValue::fromInt(ls!=rs ? 1 : 0);
+        throw std::runtime_error("< / > not supported for strings");
+    }
+    // Object comparison by pointer identity
+    if (l.tag == TLValue::Tag::Obj || r.tag == TLValue::Tag::Obj) {
+        bool eq = (l.p.obj == r.p.obj);
+        if (op == TIR::Op::CmpEq) return TLValue::fromInt(eq  ? 1 : 0);
+        if (op == TIR::Op::CmpNe) return TLValue::fromInt(!eq ? 1 : 0);
+        throw std::runtime_error("< / > not supported for objects");
+    }
+    if (l.tag == TLValue::Tag::Char && r.tag == TLValue::Tag::Char) {
+        if (op == TIR::Op::CmpEq) return TLValue::fromInt(l.p.c==r.p.c ? 1 : 0);
+        if (op == TIR::Op::CmpNe) return TLValue::fromInt(l.p.c!=r.p.c ? 1 : 0);
+        if (op == TIR::Op::CmpLt) return TLValue::fromInt(l.p.c< r.p.c ? 1 : 0);
+        if (op == TIR::Op::CmpGt) return TLValue::fromInt(l.p.c> r.p.c ? 1 : 0);
+    }
+    bool isFloat = (l.tag==TLValue::Tag::F64 || r.tag==TLValue::Tag::F64);
+    if (isFloat) {
+        double lv = (l.tag==TLValue::Tag::F64) ? l.p.d : (double)l.p.i;
+        double rv = (r.tag==TLValue::Tag::F64) ? r.p.d : (double)r.p.i;
+        if (op == TIR::Op::CmpEq) return TLValue::fromInt(lv==rv ? 1 : 0);
+        if (op == TIR::Op::CmpNe) return TLValue::fromInt(lv!=rv ? 1 : 0);
+        if (op == TIR::Op::CmpLt) return TLValue::fromInt(lv< rv ? 1 : 0);
+        if (op == TIR::Op::CmpGt) return TLValue::fromInt(lv> rv ? 1 : 0);
+    } else {
+        if (op == TIR::Op::CmpEq) return TLValue::fromInt(l.p.i==r.p.i ? 1 : 0);
+        if (op == TIR::Op::CmpNe) return TLValue::fromInt(l.p.i!=r.p.i ? 1 : 0);
+        if (op == TIR::Op::CmpLt) return TLValue::fromInt(l.p.i< r.p.i ? 1 : 0);
+        if (op == TIR::Op::CmpGt) return TLValue::fromInt(l.p.i> r.p.i ? 1 : 0);
+    }
+    throw std::runtime_error("unsupported comparison op");
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Casts and print
+// ─────────────────────────────────────────────────────────────────────────────
+
+TLValue tlCast(const TLValue& v, TIR::Op op) {
+    switch (op) {
+    case TIR::Op::CastI32: {
+        int iv = (v.tag==TLValue::Tag::F64)  ? (int)v.p.d
+               : (v.tag==TLValue::Tag::Char)  ? (int)(unsigned char)v.p.c
+               : v.isStr()                    ? (v.str().empty() ? 0 : (int)v.str()[0])
+               : v.p.i;
+        return TLValue::fromInt(iv);
+    }
+    case TIR::Op::CastF64: {
+        double dv = (v.tag==TLValue::Tag::F64)  ? v.p.d
+                  : (v.tag==TLValue::Tag::Char)  ? (double)(unsigned char)v.p.c
+                  : (double)v.p.i;
+        return TLValue::fromFloat(dv);
+    }
+    case TIR::Op::CastChar:
+        return TLValue::fromChar((v.tag==TLValue::Tag::Char) ? v.p.c : (char)v.p.i);
+    case TIR::Op::CastI1:
+        return TLValue::fromInt(v.isTruthy() ? 1 : 0);
+    case TIR::Op::CastStr:
+        return v.isStr() ? v : TLValue::fromStr(tlToString(v));
+    default:
+        throw std::runtime_error("unsupported cast op");
+    }
+}
+
+void tlPrint(const TLValue& v) {
+    OutBuf& out = OutBuf::instance();
+    switch (v.tag) {
+    case TLValue::Tag::Str:
+    case TLValue::Tag::StrView: out.str(v.str()); break;
+    case TLValue::Tag::F64:     out.f64(v.p.d);   break;
+    case TLValue::Tag::Char:    out.ch(v.p.c);    break;
+    default:                    out.i32(v.p.i);   break;
+    }
+    out.newline();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Sorting helpers
+// ─────────────────────────────────────────────────────────────────────────────
+
+// LSD radix sort, one byte per pass over the sign-flipped keys; a pass whose
+// byte is equal in every key is skipped, so small ranges take one or two.
+static void radixSortI32(std::vector<int32_t>& keys) {
+    size_t n = keys.size();
+    if (n < 64) { std::sort(keys.begin(), keys.end()); return; }
+    std::vector<uint32_t> a(n), b(n);
+    for (size_t i = 0; i < n; ++i) a[i] = (uint32_t)keys[i] ^ 0x80000000u;
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t count[257] = {0};
+        for (uint32_t k : a) ++count[((k >> shift) & 0xFF) + 1];
+        if (count[((a[0] >> shift) & 0xFF) + 1] == n) continue;
+        for (int i = 0; i < 256; ++i) count[i + 1] += count[i];
+        for (uint32_t k : a) b[count[(k >> shift) & 0xFF]++] = k;
+        a.swap(b);
+    }
+    for (size_t i = 0; i < n; ++i) keys[i] = (int32_t)(a[i] ^ 0x80000000u);
+}
+
+static double numKey(const TLValue& v) {
+    return v.tag == TLValue::Tag::F64 ? v.p.d : (double)v.p.i;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Native collections
+// ─────────────────────────────────────────────────────────────────────────────
+// Each collection is a TLArray tagged by elemType whose elements hold all of
+// its keys and values, so the GC traces it like any other array:
+//   "vec"    values in order;
+//   "map"    entries k0 v0 k1 v1 … in insertion order, hashed by index->slots;
+//   "set"    entries k0 k1 …, likewise;
+//   "deque"  ring buffer, front at index->head, index->count live;
+//   "pq"     binary min-heap.
+// Keys compare by text when both are strings, numerically when both are
+// numbers, by identity when both are objects or arrays; nil is a key of its
+// own, and keys of different kinds are never equal.
+
+enum class KeyKind { Nil, Num, Str, Ref };
+
+static KeyKind keyKind(const TLValue& v) {
+    switch (v.tag) {
+    case TLValue::Tag::Nil:     return KeyKind::Nil;
+    case TLValue::Tag::Str:
+    case TLValue::Tag::StrView: return KeyKind::Str;
+    case TLValue::Tag::Obj:
+    case TLValue::Tag::Arr:     return KeyKind::Ref;
+    default:                    return KeyKind::Num;
+    }
+}
+
+static const void* keyRef(const TLValue& v) {
+    return v.tag == TLValue::Tag::Obj ? (const void*)v.p.obj : (const void*)v.p.arr;
+}
+
+static bool keyEq(const TLValue& a, const TLValue& b) {
+    KeyKind k = keyKind(a);
+    if (k != keyKind(b)) return false;
+    switch (k) {
+    case KeyKind::Nil: return true;
+    case KeyKind::Str: return a.str() == b.str();
+    case KeyKind::Ref: return keyRef(a) == keyRef(b);
+    default:           return numKey(a) == numKey(b);
+    }
+}
+
+// Integral keys hash by value, so 3 and 3.0 land in the same slot.
+static size_t keyHash(const TLValue& v) {
+    uint64_t x;
+    switch (keyKind(v)) {
+    case KeyKind::Nil: x = 0x6E696Cull; break;
+    case KeyKind::Str: return std::hash<std::string_view>{}(v.str());
+    case KeyKind::Ref: x = (uint64_t)(uintptr_t)keyRef(v); break;
+    default: {
+        double d = numKey(v);
+        x = (d > -9e18 && d < 9e18 && d == (double)(int64_t)d)
+                ? (uint64_t)(int64_t)d : std::hash<double>{}(d);
+    }
+    }
+    x *= 0x9E3779B97F4A7C15ull;
+    return (size_t)(x ^ (x >> 32));
+}
+
+// nil < numbers < strings < objects and arrays (by address).
+static bool keyLess(const TLValue& a, const TLValue& b) {
+    KeyKind ka = keyKind(a), kb = keyKind(b);
+    if (ka != kb) return ka < kb;
+    switch (ka) {
+    case KeyKind::Nil: return false;
+    case KeyKind::Str: return a.str() < b.str();
+    case KeyKind::Ref: return std::less<const void*>{}(keyRef(a), keyRef(b));
+    default:           return numKey(a) < numKey(b);
+    }
+}
+
+// Open-addressing (linear probing) index over a map (stride 2) or set
+// (stride 1).  Slots hold entry numbers; the table is kept at most half
+// full.
+class HashColl {
+public:
+    HashColl(TLArray* arr, size_t stride)
+        : el_(arr->elements), ix_(*arr->index), stride_(stride) {}
+
+    size_t count() const { return el_.size() / stride_; }
+
+    // Entry number of key, or -1.
+    int32_t find(const TLValue& key) const { return ix_.slots[probe(key)]; }
+
+    // Adds key (with *val for a map) unless present, in which case a map
+    // entry's value is replaced.  Returns true when the key was added.
+    bool put(const TLValue& key, const TLValue* val) {
+        size_t i = probe(key);
+        if (ix_.slots[i] >= 0) {
+            if (val) el_[ix_.slots[i] * stride_ + 1] = *val;
+            return false;
+        }
+        ix_.slots[i] = (int32_t)count();
+        el_.push_back(key);
+        if (val) el_.push_back(*val);
+        if (count() * 2 > ix_.slots.size()) rehash(ix_.slots.size() * 2);
+        return true;
+    }
+
+    bool erase(const TLValue& key) {
+        size_t i = probe(key);
+        int32_t e = ix_.slots[i];
+        if (e < 0) return false;
+        // Backward-shift deletion: pull later chain members into the hole
+        // unless their home slot lies in (i, j], so no tombstones are needed.
+        size_t m = ix_.slots.size() - 1;
+        for (size_t j = (i + 1) & m; ix_.slots[j] >= 0; j = (j + 1) & m) {
+            size_t home = keyHash(el_[ix_.slots[j] * stride_]) & m;
+            if (((j - home) & m) >= ((j - i) & m)) {
+                ix_.slots[i] = ix_.slots[j];
+                i = j;
+            }
+        }
+        ix_.slots[i] = -1;
+        // Keep entries dense: the last entry moves into the freed one.
+        size_t last = count() - 1;
+        if ((size_t)e != last) {
+            ix_.slots[probe(el_[last * stride_])] = e;
+            std::move(el_.begin() + last * stride_, el_.end(), el_.begin() + e * stride_);
+        }
+        el_.resize(last * stride_);
+        return true;
+    }
+
+    void clear() {
+        el_.clear();
+        std::fill(ix_.slots.begin(), ix_.slots.end(), -1);
+    }
+
+    void rehash(size_t nslots) {
+        ix_.slots.assign(nslots, -1);
+        for (size_t e = 0; e < count(); ++e)
+            ix_.slots[probe(el_[e * stride_])] = (int32_t)e;
+    }
+
+private:
+    std::vector<TLValue>& el_;
+    TLCollIndex&          ix_;
+    size_t                stride_;
+
+    // Slot holding key, or the empty slot where it would go.
+    size_t probe(const TLValue& key) const {
+        size_t m = ix_.slots.size() - 1;
+        for (size_t i = keyHash(key) & m;; i = (i + 1) & m) {
+            int32_t e = ix_.slots[i];
+            if (e < 0 || keyEq(el_[e * stride_], key)) return i;
+        }
+    }
+};
+
+static TLValue& dequeAt(TLArray* dq, size_t i) {
+    return dq->elements[(dq->index->head + i) % dq->elements.size()];
+}
+
+// Makes room for one more element, doubling the ring when it is full.
+static void dequeReserve(TLArray* dq) {
+    TLCollIndex& ix = *dq->index;
+    if (ix.count < dq->elements.size()) return;
+    std::vector<TLValue> grown;
+    grown.reserve(std::max<size_t>(8, dq->elements.size() * 2));
+    for (size_t i = 0; i < ix.count; ++i) grown.push_back(std::move(dequeAt(dq, i)));
+    grown.resize(grown.capacity(), TLValue::nil());
+    dq->elements.swap(grown);
+    ix.head = 0;
+}
+
+static void heapSiftUp(std::vector<TLValue>& h, size_t i) {
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!keyLess(h[i], h[parent])) break;
+        std::swap(h[i], h[parent]);
+        i = parent;
+    }
+}
+
+static void heapSiftDown(std::vector<TLValue>& h, size_t i) {
+    for (;;) {
+        size_t l = 2 * i + 1, r = l + 1, min = i;
+        if (l < h.size() && keyLess(h[l], h[min])) min = l;
+        if (r < h.size() && keyLess(h[r], h[min])) min = r;
+        if (min == i) return;
+        std::swap(h[i], h[min]);
+        i = min;
+    }
+}
+
+bool NativeLib::isCollection(const std::string& name) {
+    if (name.size() < 9) return false;
+    const char* k = name.c_str() + 5;   // past "__tl_"
+    return std::strncmp(k, "vec_", 4) == 0 || std::strncmp(k, "map_", 4) == 0 ||
+           std::strncmp(k, "set_", 4) == 0 || std::strncmp(k, "pq_", 3) == 0 ||
+           std::strncmp(k, "deque_", 6) == 0 || std::strncmp(k, "ring_", 5) == 0;
+}
+
+TLValue NativeLib::callCollection(const std::string& name, const std::vector<TLValue>& args) {
+    auto arg = [&](size_t i) -> const TLValue& {
+        static const TLValue nil;
+        return i < args.size() ? args[i] : nil;
+    };
+    auto coll = [&](const char* kind) -> TLArray* {
+        if (args.empty() || !args[0].isArr() || args[0].p.arr->elemType != kind)
+            throw std::runtime_error(std::string("expected a native ") + kind +
+                                     " in " + name);
+        return args[0].p.arr;
+    };
+    auto index = [&](const TLValue& v) { return (long long)numKey(v); };
+    auto i32_0 = [&]() {
+        if (args.empty()) return 0;
+        if (args[0].tag != TLValue::Tag::I32)
+            throw std::runtime_error(name + ": capacity must be an int, got " +
+                                     tlToString(args[0]));
+        return args[0].p.i;
+    };
+    // __tl_<kind>_new(capacity): capacity is a hint, all collections grow.
+    auto make = [&](const char* kind) -> TLArray* {
+        size_t cap = (size_t)std::max(0, i32_0());
+        maybeCollect();
+        TLArray* arr = heap_.allocArray(kind);
+        if (std::strcmp(kind, "vec") == 0 || std::strcmp(kind, "pq") == 0) {
+            arr->elements.reserve(cap);
+            return arr;
+        }
+        arr->index = std::make_unique<TLCollIndex>();
+        if (std::strcmp(kind, "ring") == 0) {
+            arr->elements.resize(std::max<size_t>(cap, 1), TLValue::nil());
+        } else if (std::strcmp(kind, "deque") == 0) {
+            arr->elements.resize(std::max<size_t>(cap, 8), TLValue::nil());
+        } else {
+            size_t slots = 8;
+            while (slots < cap * 2) slots *= 2;
+            arr->index->slots.assign(slots, -1);
+            arr->elements.reserve(cap * (std::strcmp(kind, "map") == 0 ? 2 : 1));
+        }
+        return arr;
+    };
+
+    // ── Vec ───────────────────────────────────────────────────────────────
+    if (name == "__tl_vec_new") return TLValue::fromArr(make("vec"));
+    if (name == "__tl_vec_push") {
+        coll("vec")->elements.push_back(arg(1));
+        return TLValue::nil();
+    }
+    if (name == "__tl_vec_pop") {
+        auto& el = coll("vec")->elements;
+        if (el.empty()) return TLValue::nil();
+        TLValue v = std::move(el.back());
+        el.pop_back();
+        return v;
+    }
+    if (name == "__tl_vec_get") {
+        auto& el = coll("vec")->elements;
+        long long i = index(arg(1));
+        return i >= 0 && i < (long long)el.size() ? el[i] : TLValue::nil();
+    }
+    if (name == "__tl_vec_set") {
+        auto& el = coll("vec")->elements;
+        long long i = index(arg(1));
+        if (i >= 0 && i < (long long)el.size()) el[i] = arg(2);
+        return TLValue::nil();
+    }
+    if (name == "__tl_vec_len")   return TLValue::fromInt((int)coll("vec")->elements.size());
+    if (name == "__tl_vec_clear") { coll("vec")->elements.clear(); return TLValue::nil(); }
+
+    // ── HashMap ───────────────────────────────────────────────────────────
+    if (name == "__tl_map_new") return TLValue::fromArr(make("map"));
+    if (name == "__tl_map_put") {
+        HashColl(coll("map"), 2).put(arg(1), &arg(2));
+        return TLValue::nil();
+    }
+    // get returns nil for a missing key, get_or its third argument.
+    if (name == "__tl_map_get" || name == "__tl_map_get_or") {
+        TLArray* m = coll("map");
+        int32_t e = HashColl(m, 2).find(arg(1));
+        return e >= 0 ? m->elements[e * 2 + 1] : arg(2);
+    }
+    if (name == "__tl_map_has")
+        return TLValue::fromInt(HashColl(coll("map"), 2).find(arg(1)) >= 0 ? 1 : 0);
+    if (name == "__tl_map_remove")
+        return TLValue::fromInt(HashColl(coll("map"), 2).erase(arg(1)) ? 1 : 0);
+    if (name == "__tl_map_len")   return TLValue::fromInt((int)coll("map")->elements.size() / 2);
+    if (name == "__tl_map_clear") { HashColl(coll("map"), 2).clear(); return TLValue::nil(); }
+    // Entry i in insertion order (removal moves the last entry into the gap).
+    if (name == "__tl_map_key_at" || name == "__tl_map_val_at") {
+        auto& el = coll("map")->elements;
+        long long i = index(arg(1));
+        if (i < 0 || i >= (long long)el.size() / 2) return TLValue::nil();
+        return el[i * 2 + (name == "__tl_map_val_at" ? 1 : 0)];
+    }
+
+    // ── HashSet ───────────────────────────────────────────────────────────
+    if (name == "__tl_set_new") return TLValue::fromArr(make("set"));
+    if (name == "__tl_set_add")
+        return TLValue::fromInt(HashColl(coll("set"), 1).put(arg(1), nullptr) ? 1 : 0);
+    if (name == "__tl_set_has")
+        return TLValue::fromInt(HashColl(coll("set"), 1).find(arg(1)) >= 0 ? 1 : 0);
+    if (name == "__tl_set_remove")
+        return TLValue::fromInt(HashColl(coll("set"), 1).erase(arg(1)) ? 1 : 0);
+    if (name == "__tl_set_len")   return TLValue::fromInt((int)coll("set")->elements.size());
+    if (name == "__tl_set_clear") { HashColl(coll("set"), 1).clear(); return TLValue::nil(); }
+    if (name == "__tl_set_at") {
+        auto& el = coll("set")->elements;
+        long long i = index(arg(1));
+        return i >= 0 && i < (long long)el.size() ? el[i] : TLValue::nil();
+    }
+
+    // ── Deque ─────────────────────────────────────────────────────────────
+    if (name == "__tl_deque_new") return TLValue::fromArr(make("deque"));
+    if (name == "__tl_deque_push_back" || name == "__tl_deque_push_front") {
+        TLArray* dq = coll("deque");
+        dequeReserve(dq);
+        TLCollIndex& ix = *dq->index;
+        if (name == "__tl_deque_push_front") {
+            ix.head = (ix.head + dq->elements.size() - 1) % dq->elements.size();
+            dq->elements[ix.head] = arg(1);
+        } else {
+            dequeAt(dq, ix.count) = arg(1);
+        }
+        ++ix.count;
+        return TLValue::nil();
+    }
+    // Pops clear the vacated slot so the GC can free what it held.
+    if (name == "__tl_deque_pop_front" || name == "__tl_deque_pop_back") {
+        TLArray* dq = coll("deque");
+        TLCollIndex& ix = *dq->index;
+        if (ix.count == 0) return TLValue::nil();
+        bool front = name == "__tl_deque_pop_front";
+        TLValue& slot = dequeAt(dq, front ? 0 : ix.count - 1);
+        TLValue v = std::move(slot);
+        slot = TLValue::nil();
+        if (front) ix.head = (ix.head + 1) % dq->elements.size();
+        --ix.count;
+        return v;
+    }
+    if (name == "__tl_deque_get") {
+        TLArray* dq = coll("deque");
+        long long i = index(arg(1));
+        if (i < 0 || i >= (long long)dq->index->count) return TLValue::nil();
+        return dequeAt(dq, (size_t)i);
+    }
+    if (name == "__tl_deque_len") return TLValue::fromInt((int)coll("deque")->index->count);
+
+    // ── Ring buffer ───────────────────────────────────────────────────────
+    // Same layout as a deque, but the capacity is fixed at __tl_ring_new.
+    // push_back/push_front overwrite the opposite end when full and return
+    // the evicted value (nil otherwise) — a sliding window; offer_back and
+    // offer_front refuse instead and return 0 — a bounded queue.
+    if (name == "__tl_ring_new") return TLValue::fromArr(make("ring"));
+    if (name == "__tl_ring_push_back" || name == "__tl_ring_push_front" ||
+        name == "__tl_ring_offer_back" || name == "__tl_ring_offer_front") {
+        TLArray* rb = coll("ring");
+        TLCollIndex& ix = *rb->index;
+        size_t cap = rb->elements.size();
+        bool offer = name.compare(10, 6, "offer_") == 0;
+        bool front = name.back() == 't';
+        TLValue evicted;
+        if (ix.count == cap) {
+            if (offer) return TLValue::fromInt(0);
+            TLValue& slot = dequeAt(rb, front ? cap - 1 : 0);
+            evicted = std::move(slot);
+            slot = TLValue::nil();
+            if (!front) ix.head = (ix.head + 1) % cap;
+            --ix.count;
+        }
+        if (front) {
+            ix.head = (ix.head + cap - 1) % cap;
+            rb->elements[ix.head] = arg(1);
+        } else {
+            dequeAt(rb, ix.count) = arg(1);
+        }
+        ++ix.count;
+        return offer ? TLValue::fromInt(1) : evicted;
+    }
+    if (name == "__tl_ring_pop_front" || name == "__tl_ring_pop_back") {
+        TLArray* rb = coll("ring");
+        TLCollIndex& ix = *rb->index;
+        if (ix.count == 0) return TLValue::nil();
+        bool front = name == "__tl_ring_pop_front";
+        TLValue& slot = dequeAt(rb, front ? 0 : ix.count - 1);
+        TLValue v = std::move(slot);
+        slot = TLValue::nil();
+        if (front) ix.head = (ix.head + 1) % rb->elements.size();
+        --ix.count;
+        return v;
+    }
+    if (name == "__tl_ring_get") {
+        TLArray* rb = coll("ring");
+        long long i = index(arg(1));
+        if (i < 0 || i >= (long long)rb->index->count) return TLValue::nil();
+        return dequeAt(rb, (size_t)i);
+    }
+    if (name == "__tl_ring_len")  return TLValue::fromInt((int)coll("ring")->index->count);
+    if (name == "__tl_ring_cap")  return TLValue::fromInt((int)coll("ring")->elements.size());
+    if (name == "__tl_ring_full") {
+        TLArray* rb = coll("ring");
+        return TLValue::fromInt(rb->index->count == rb->elements.size() ? 1 : 0);
+    }
+    if (name == "__tl_ring_clear") {
+        TLArray* rb = coll("ring");
+        std::fill(rb->elements.begin(), rb->elements.end(), TLValue::nil());
+        rb->index->head = rb->index->count = 0;
+        return TLValue::nil();
+    }
+
+    // ── Priority queue (min-heap) ─────────────────────────────────────────
+    if (name == "__tl_pq_new") return TLValue::fromArr(make("pq"));
+    if (name == "__tl_pq_push") {
+        auto& h = coll("pq")->elements;
+        h.push_back(arg(1));
+        heapSiftUp(h, h.size() - 1);
+        return TLValue::nil();
+    }
+    if (name == "__tl_pq_pop") {
+        auto& h = coll("pq")->elements;
+        if (h.empty()) return TLValue::nil();
+        TLValue top = std::move(h.front());
+        h.front() = std::move(h.back());
+        h.pop_back();
+        if (!h.empty()) heapSiftDown(h, 0);
+        return top;
+    }
+    if (name == "__tl_pq_peek") {
+        auto& h = coll("pq")->elements;
+        return h.empty() ? TLValue::nil() : h.front();
+    }
+    if (name == "__tl_pq_len") return TLValue::fromInt((int)coll("pq")->elements.size());
+
+    throw std::runtime_error("unknown native function: " + name);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Math
+// ─────────────────────────────────────────────────────────────────────────────
+// __tl_math_<fn>(x...) returns a float; int arguments are widened.  The LLVM
+// backend lowers the scalar forms to intrinsics (llvmgen.cpp), so results
+// match libm on both paths.  __tl_math_map_<fn>(arr) applies a unary fn to
+// every element and returns a new float array.
+
+using MathFn = double (*)(double);
+
+static MathFn unaryMath(std::string_view fn) {
+    static const std::pair<std::string_view, MathFn> table[] = {
+        {"sqrt",  [](double x) { return std::sqrt(x); }},
+        {"exp",   [](double x) { return std::exp(x); }},
+        {"log",   [](double x) { return std::log(x); }},
+        {"sin",   [](double x) { return std::sin(x); }},
+        {"cos",   [](double x) { return std::cos(x); }},
+        {"floor", [](double x) { return std::floor(x); }},
+        {"abs",   [](double x) { return std::fabs(x); }},
+    };
+    for (auto& [n, f] : table)
+        if (n == fn) return f;
+    return nullptr;
+}
+
+TLValue NativeLib::callMath(const std::string& name, const std::vector<TLValue>& args) {
+    std::string_view fn = std::string_view(name).substr(10);   // past "__tl_math_"
+    auto num = [&](size_t i) { return i < args.size() ? numKey(args[i]) : 0.0; };
+
+    if (fn.compare(0, 4, "map_") == 0) {
+        MathFn f = unaryMath(fn.substr(4));
+        if (!f) throw std::runtime_error("unknown native function: " + name);
+        maybeCollect();   // args[0] is rooted by the caller
+        TLArray* out = heap_.allocArray("float");
+        if (!args.empty() && args[0].isArr()) {
+            const auto& in = args[0].p.arr->elements;
+            out->elements.reserve(in.size());
+            for (const auto& v : in) out->elements.push_back(TLValue::fromFloat(f(numKey(v))));
+        }
+        return TLValue::fromArr(out);
+    }
+    if (fn == "pow") return TLValue::fromFloat(std::pow(num(0), num(1)));
+    if (fn == "min") return TLValue::fromFloat(std::fmin(num(0), num(1)));
+    if (fn == "max") return TLValue::fromFloat(std::fmax(num(0), num(1)));
+    if (MathFn f = unaryMath(fn)) return TLValue::fromFloat(f(num(0)));
+    throw std::runtime_error("unknown native function: " + name);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Native built-in function dispatch (names beginning with "__tl_")
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Next entry name from d, skipping dot files, or nullptr at the end.
+// readdir() refills from getdents64 in large batches, so a full scan costs
+// a handful of syscalls however many entries there are.
+static const char* nextDirEntry(DIR* d) {
+    while (struct dirent* e = readdir(d))
+        if (e->d_name[0] != '.') return e->d_name;
+    return nullptr;
+}
+
+DIR* NativeLib::dirFor(int handle) {
+    if (handle < 1 || handle > (int)dirs_.size() || !dirs_[handle - 1])
+        throw std::runtime_error("invalid directory handle: " +
+                                 std::to_string(handle));
+    return dirs_[handle - 1].get();
+}
+
+LineReader& NativeLib::readerFor(int handle) {
+    if (handle < 1 || handle > (int)readers_.size() || !readers_[handle - 1])
+        throw std::runtime_error("invalid reader handle: " +
+                                 std::to_string(handle));
+    return *readers_[handle - 1];
+}
+
+std::shared_ptr<SpscQueue> NativeLib::spscQueue(int handle) {
+    if (handle < 1 || handle > (int)spsc_.size() || !spsc_[handle - 1])
+        throw std::runtime_error("invalid spsc queue handle: " +
+                                 std::to_string(handle));
+    return spsc_[handle - 1];
+}
+
+int NativeLib::addSpscQueue(std::shared_ptr<SpscQueue> q) {
+    auto slot = std::find(spsc_.begin(), spsc_.end(), nullptr);
+    if (slot == spsc_.end()) slot = spsc_.insert(slot, nullptr);
+    *slot = std::move(q);
+    return (int)(slot - spsc_.begin()) + 1;
+}
+
+TLValue NativeLib::call(const std::string& name, const std::vector<TLValue>& args) {
+    // Collection and math ops dominate the scripts that use them; route
+    // them before the long name chain below.
+    if (isCollection(name)) return callCollection(name, args);
+    if (name.compare(0, 10, "__tl_math_") == 0) return callMath(name, args);
+
+    // str*() hand out std::string for the generic ops, copying only when the
+    // argument is a view; sv*() read owned strings and views without a copy.
+    std::string own0, own1;
+    auto str0 = [&]() -> const std::string& {
+        static const std::string empty;
+        if (args.empty()) return empty;
+        if (args[0].tag != TLValue::Tag::StrView) return args[0].sval;
+        return own0 = std::string(args[0].str());
+    };
+    auto str1 = [&]() -> const std::string& {
+        static const std::string empty;
+        if (args.size() < 2) return empty;
+        if (args[1].tag != TLValue::Tag::StrView) return args[1].sval;
+        return own1 = std::string(args[1].str());
+    };
+    auto sv0 = [&]() { return args.empty()    ? std::string_view() : args[0].str(); };
+    auto sv1 = [&]() { return args.size() < 2 ? std::string_view() : args[1].str(); };
+    // Substring of args[0]: a view stays a view (no byte copy), an owned
+    // string is copied as before.
+    auto slice0 = [&](size_t off, size_t len) -> TLValue {
+        if (args.empty() || args[0].tag != TLValue::Tag::StrView)
+            return TLValue::fromStr(std::string(sv0().substr(off, len)));
+        maybeCollect();   // args[0] is rooted by the caller
+        const TLStrView* v = args[0].p.view;
+        len = std::min(len, v->len - std::min(off, v->len));
+        return TLValue::fromView(heap_.allocView(v->base, v->off + off, len));
+    };
+    auto i32_0 = [&]() { return args.empty() ? 0 : args[0].p.i; };
+    auto i32_1 = [&]() { return args.size() < 2 ? 0 : args[1].p.i; };
+    auto i32_2 = [&]() { return args.size() < 3 ? 0 : args[2].p.i; };
+
+    // ── Print (already handled by Op::Print, but support as function too) ──
+    OutBuf& out = OutBuf::instance();
+    if (name == "__tl_print_i32")  { out.i32(i32_0());      out.newline(); return TLValue::nil(); }
+    if (name == "__tl_print_f64")  { out.f64(args[0].p.d);  out.newline(); return TLValue::nil(); }
+    if (name == "__tl_print_str")  { out.str(sv0());        out.newline(); return TLValue::nil(); }
+    if (name == "__tl_print_bool") { out.str(i32_0() ? "true" : "false"); out.newline(); return TLValue::nil(); }
+    if (name == "__tl_print_char") { out.ch((char)i32_0()); out.newline(); return TLValue::nil(); }
+
+    // ── Conversion ────────────────────────────────────────────────────────
+    if (name == "__tl_i32_to_str")  return TLValue::fromStr(std::to_string(i32_0()));
+    if (name == "__tl_f64_to_str") {
+        std::ostringstream ss; ss << args[0].p.d; return TLValue::fromStr(ss.str());
+    }
+    if (name == "__tl_bool_to_str") return TLValue::fromStr(i32_0() ? "true" : "false");
+    if (name == "__tl_str_concat")  return TLValue::fromStr(str0() + str1());
+    if (name == "__tl_str_eq")      return TLValue::fromInt(sv0() == sv1() ? 1 : 0);
+
+    // ── String ────────────────────────────────────────────────────────────
+    if (name == "__tl_str_len")
+        return TLValue::fromInt((int)sv0().size());
+
+    if (name == "__tl_str_sub") {
+        std::string_view s = sv0();
+        int start = i32_1(), len = i32_2();
+        if (start < 0) start = 0;
+        if (start >= (int)s.size()) return TLValue::fromStr("");
+        return slice0(start, std::max(0, len));
+    }
+
+    if (name == "__tl_str_upper") {
+        std::string r = str0();
+        for (char& c : r) c = (char)std::toupper((unsigned char)c);
+        return TLValue::fromStr(r);
+    }
+    if (name == "__tl_str_lower") {
+        std::string r = str0();
+        for (char& c : r) c = (char)std::tolower((unsigned char)c);
+        return TLValue::fromStr(r);
+    }
+    if (name == "__tl_str_trim") {
+        std::string_view s = sv0();
+        size_t l = s.find_first_not_of(" \t\n\r\f\v");
+        if (l == std::string_view::npos) return TLValue::fromStr("");
+        size_t r = s.find_last_not_of(" \t\n\r\f\v");
+        return slice0(l, r - l + 1);
+    }
+    if (name == "__tl_str_contains")
+        return TLValue::fromInt(sv0().find(sv1()) != std::string_view::npos ? 1 : 0);
+
+    if (name == "__tl_str_starts_with") {
+        std::string_view s = sv0(), p = sv1();
+        return TLValue::fromInt(s.size() >= p.size() && s.compare(0, p.size(), p) == 0 ? 1 : 0);
+    }
+    if (name == "__tl_str_ends_with") {
+        std::string_view s = sv0(), p = sv1();
+        return TLValue::fromInt(s.size() >= p.size() &&
+                                s.compare(s.size() - p.size(), p.size(), p) == 0 ? 1 : 0);
+    }
+    if (name == "__tl_str_index_of") {
+        auto pos = sv0().find(sv1());
+        return TLValue::fromInt(pos == std::string_view::npos ? -1 : (int)pos);
+    }
+    if (name == "__tl_str_replace") {
+        std::string s = str0();
+        const std::string& from = str1();
+        const std::string  to   = args.size() < 3 ? "" : std::string(args[2].str());
+        if (from.empty()) return TLValue::fromStr(s);
+        std::string out;
+        size_t pos = 0;
+        while (true) {
+            size_t f = s.find(from, pos);
+            if (f == std::string::npos) { out += s.substr(pos); break; }
+            out += s.substr(pos, f - pos) + to;
+            pos = f + from.size();
+        }
+        return TLValue::fromStr(out);
+    }
+    if (name == "__tl_str_to_int") {
+        try { return TLValue::fromInt(std::stoi(str0())); }
+        catch (...) { return TLValue::fromInt(0); }
+    }
+    if (name == "__tl_str_to_float") {
+        try { return TLValue::fromFloat(std::stod(str0())); }
+        catch (...) { return TLValue::fromFloat(0.0); }
+    }
+    if (name == "__tl_str_char_at") {
+        std::string_view s = sv0(); int i = i32_1();
+        if (i < 0 || i >= (int)s.size()) return TLValue::fromInt(0);
+        return TLValue::fromInt((unsigned char)s[i]);
+    }
+
+    // ── Split / join ─────────────────────────────────────────────────────
+    // Pieces of a mapped string are views into the same mapping (no byte
+    // copy); pieces of an owned string are copies.  The collection check
+    // runs once up front because the result array is unrooted while filling.
+    if (name == "__tl_str_split" || name == "__tl_str_split_lines") {
+        bool lines = name == "__tl_str_split_lines";
+        std::string_view s = sv0();
+        std::string_view sep = lines ? std::string_view("\n") : sv1();
+        const TLStrView* view = (!args.empty() && args[0].tag == TLValue::Tag::StrView)
+                                    ? args[0].p.view : nullptr;
+        maybeCollect();
+        TLArray* arr = heap_.allocArray("string");
+        auto piece = [&](size_t off, size_t len) {
+            if (lines && len > 0 && s[off + len - 1] == '\r') --len;
+            arr->elements.push_back(view
+                ? TLValue::fromView(heap_.allocView(view->base, view->off + off, len))
+                : TLValue::fromStr(std::string(s.substr(off, len))));
+        };
+        size_t pos = 0;
+        // An empty separator leaves the string whole.
+        while (!sep.empty()) {
+            size_t f = std::string_view::npos;
+            if (sep.size() == 1) {
+                if (auto* hit = (const char*)std::memchr(s.data() + pos, sep[0], s.size() - pos))
+                    f = hit - s.data();
+            } else {
+                f = s.find(sep, pos);
+            }
+            if (f == std::string_view::npos) break;
+            piece(pos, f - pos);
+            pos = f + sep.size();
+        }
+        // split_lines drops the empty piece after a final newline.
+        if (!lines || pos < s.size()) piece(pos, s.size() - pos);
+        return TLValue::fromArr(arr);
+    }
+    if (name == "__tl_str_join") {
+        std::string out;
+        if (!args.empty() && args[0].isArr()) {
+            const auto& el = args[0].p.arr->elements;
+            std::string_view sep = sv1();
+            size_t total = el.empty() ? 0 : sep.size() * (el.size() - 1);
+            for (const auto& v : el) total += v.isStr() ? v.str().size() : 0;
+            out.reserve(total);
+            for (size_t i = 0; i < el.size(); ++i) {
+                if (i > 0) out.append(sep);
+                if (el[i].isStr()) out.append(el[i].str());
+                else               out.append(tlToString(el[i]));
+            }
+        }
+        return TLValue::fromStr(std::move(out));
+    }
+
+    // ── Array helpers (used by Vec/Map stdlib classes) ────────────────────
+    // Allocate a new array of given capacity pre-filled with default values.
+    if (name == "__tl_alloc_arr") {
+        // Collect first: the new array is not rooted until the caller
+        // stores the returned value.
+        maybeCollect();
+        int cap = i32_0();
+        TLArray* arr = heap_.allocArray("any");
+        arr->elements.resize(cap > 0 ? cap : 0, TLValue::nil());
+        return TLValue::fromArr(arr);
+    }
+    if (name == "__tl_arr_len") {
+        if (args.empty() || !args[0].isArr()) return TLValue::fromInt(0);
+        return TLValue::fromInt((int)args[0].p.arr->elements.size());
+    }
+    if (name == "__tl_load_arr") {
+        if (args.size() < 2 || !args[0].isArr()) return TLValue::nil();
+        TLArray* arr = args[0].p.arr;
+        int idx = i32_1();
+        if (idx < 0 || idx >= (int)arr->elements.size()) return TLValue::nil();
+        return arr->elements[idx];
+    }
+    if (name == "__tl_store_arr") {
+        // args: (arr, idx, val)
+        if (args.size() < 3 || !args[0].isArr()) return TLValue::nil();
+        TLArray* arr = args[0].p.arr;
+        int idx = i32_1();
+        if (idx >= 0 && idx < (int)arr->elements.size())
+            arr->elements[idx] = args[2];
+        return TLValue::nil();
+    }
+    // Resize an array: copies existing elements, pads with nil.
+    if (name == "__tl_arr_resize") {
+        if (args.empty() || !args[0].isArr()) return TLValue::nil();
+        TLArray* arr = args[0].p.arr;
+        int newCap = i32_1();
+        arr->elements.resize(newCap > 0 ? newCap : 0, TLValue::nil());
+        return TLValue::fromArr(arr);
+    }
+
+    // ── String builders ──────────────────────────────────────────────────
+    // A builder is a one-element "sb" array holding the buffer string, so
+    // the GC owns it; appends grow the std::string geometrically.
+    auto sbBuf = [&]() -> std::string& {
+        if (args.empty() || !args[0].isArr() ||
+            args[0].p.arr->elemType != "sb" || args[0].p.arr->elements.empty())
+            throw std::runtime_error("invalid string builder");
+        return args[0].p.arr->elements[0].sval;
+    };
+    if (name == "__tl_sb_new") {
+        maybeCollect();
+        TLArray* sb = heap_.allocArray("sb");
+        std::string buf;
+        buf.reserve(std::max(0, i32_0()));
+        sb->elements.push_back(TLValue::fromStr(std::move(buf)));
+        return TLValue::fromArr(sb);
+    }
+    if (name == "__tl_sb_append") {
+        std::string& buf = sbBuf();
+        buf.append(args.size() < 2 ? std::string_view() : sv1());
+        return TLValue::nil();
+    }
+    if (name == "__tl_sb_append_int") {
+        std::string& buf = sbBuf();
+        char tmp[16];
+        int n = std::snprintf(tmp, sizeof tmp, "%d", i32_1());
+        buf.append(tmp, n);
+        return TLValue::nil();
+    }
+    if (name == "__tl_sb_append_char") {
+        std::string& buf = sbBuf();
+        if (args.size() > 1)
+            buf.push_back(args[1].tag == TLValue::Tag::Char ? args[1].p.c
+                                                              : (char)args[1].p.i);
+        return TLValue::nil();
+    }
+    if (name == "__tl_sb_len")
+        return TLValue::fromInt((int)sbBuf().size());
+    if (name == "__tl_sb_to_str")
+        return TLValue::fromStr(sbBuf());
+
+    // ── Sort / search / partition over the first n elements ──────────────
+    // args: (arr, n, ...).  Elements past n (unused Vec capacity) are left
+    // alone.
+    auto prefix = [&]() -> std::pair<std::vector<TLValue>::iterator,
+                                     std::vector<TLValue>::iterator> {
+        if (args.empty() || !args[0].isArr()) return {};
+        auto& el = args[0].p.arr->elements;
+        size_t n = std::min((size_t)std::max(0, i32_1()), el.size());
+        return {el.begin(), el.begin() + n};
+    };
+    if (name == "__tl_arr_sort_i32") {
+        auto [first, last] = prefix();
+        std::vector<int32_t> keys;
+        keys.reserve(last - first);
+        for (auto it = first; it != last; ++it) keys.push_back(it->p.i);
+        radixSortI32(keys);
+        for (int32_t k : keys) *first++ = TLValue::fromInt(k);
+        return TLValue::nil();
+    }
+    if (name == "__tl_arr_sort_f64") {
+        auto [first, last] = prefix();
+        // NaN sorts last, so the comparator stays a strict weak ordering
+        // (tinyrt's tl_cmp_f64 uses the same rule).
+        std::sort(first, last, [](const TLValue& a, const TLValue& b) {
+            double x = numKey(a), y = numKey(b);
+            if (std::isnan(x)) return false;
+            return std::isnan(y) || x < y;
+        });
+        return TLValue::nil();
+    }
+    if (name == "__tl_arr_sort_str") {
+        auto [first, last] = prefix();
+        std::sort(first, last, [](const TLValue& a, const TLValue& b) {
+            return a.str() < b.str();
+        });
+        return TLValue::nil();
+    }
+    // Index of the first element equal to key in an ascending prefix, or -1.
+    if (name == "__tl_arr_bsearch") {
+        auto [first, last] = prefix();
+        int key = i32_2();
+        auto it = std::lower_bound(first, last, key,
+            [](const TLValue& v, int k) { return v.p.i < k; });
+        return TLValue::fromInt(it != last && it->p.i == key ? (int)(it - first) : -1);
+    }
+    if (name == "__tl_arr_bsearch_str") {
+        auto [first, last] = prefix();
+        std::string_view key = args.size() < 3 ? std::string_view() : args[2].str();
+        auto it = std::lower_bound(first, last, key,
+            [](const TLValue& v, std::string_view k) { return v.str() < k; });
+        return TLValue::fromInt(it != last && it->str() == key ? (int)(it - first) : -1);
+    }
+    // Moves elements < pivot to the front; returns how many there are.
+    if (name == "__tl_arr_partition") {
+        auto [first, last] = prefix();
+        int pivot = i32_2();
+        auto mid = std::partition(first, last,
+            [pivot](const TLValue& v) { return v.p.i < pivot; });
+        return TLValue::fromInt((int)(mid - first));
+    }
+
+    // ── File ─────────────────────────────────────────────────────────────
+    if (name == "__tl_file_exists") {
+        std::ifstream f(str0());
+        return TLValue::fromInt(f.good() ? 1 : 0);
+    }
+    if (name == "__tl_file_read_all") {
+        std::string content;
+        AsyncIO::readFile(str0(), content);
+        return TLValue::fromStr(std::move(content));
+    }
+    if (name == "__tl_file_write_all") {
+        std::ofstream f(str0());
+        if (!f.is_open()) return TLValue::fromInt(0);
+        f << str1();
+        return TLValue::fromInt(f.good() ? 1 : 0);
+    }
+    if (name == "__tl_file_append") {
+        std::ofstream f(str0(), std::ios::app);
+        if (!f.is_open()) return TLValue::fromInt(0);
+        f << str1();
+        return TLValue::fromInt(f.good() ? 1 : 0);
+    }
+    if (name == "__tl_file_delete") {
+        return TLValue::fromInt(std::remove(str0().c_str()) == 0 ? 1 : 0);
+    }
+
+    // ── Streaming readers ────────────────────────────────────────────────
+    if (name == "__tl_reader_open") {
+        auto rd = std::make_unique<LineReader>();
+        if (!rd->open(str0())) return TLValue::fromInt(0);
+        auto slot = std::find(readers_.begin(), readers_.end(), nullptr);
+        if (slot == readers_.end()) slot = readers_.insert(slot, nullptr);
+        *slot = std::move(rd);
+        return TLValue::fromInt((int)(slot - readers_.begin()) + 1);
+    }
+    if (name == "__tl_reader_read_line") {
+        std::string line;
+        readerFor(i32_0()).readLine(line);
+        return TLValue::fromStr(std::move(line));
+    }
+    if (name == "__tl_reader_read_chunk")
+        return TLValue::fromStr(readerFor(i32_0()).readChunk(std::max(0, i32_1())));
+    if (name == "__tl_reader_eof")
+        return TLValue::fromInt(readerFor(i32_0()).eof() ? 1 : 0);
+    if (name == "__tl_reader_close") {
+        readerFor(i32_0());   // validates the handle
+        readers_[i32_0() - 1].reset();
+        return TLValue::nil();
+    }
+
+    // ── Bulk stdin ───────────────────────────────────────────────────────
+    // Both read through InBuf, so they interleave correctly with input().
+    if (name == "__tl_read_ints") {
+        maybeCollect();
+        int n = std::max(0, i32_0());
+        TLArray* arr = heap_.allocArray("int");
+        arr->elements.reserve(n);
+        InBuf& in = InBuf::instance();
+        for (int i = 0; i < n; ++i)
+            arr->elements.push_back(TLValue::fromInt(in.nextInt()));
+        return TLValue::fromArr(arr);
+    }
+    if (name == "__tl_read_line") {
+        std::string line;
+        InBuf::instance().readLine(line);
+        return TLValue::fromStr(std::move(line));
+    }
+
+    // ── Memory-mapped files ──────────────────────────────────────────────
+    // Returns an immutable view over a read-only mmap of the file.  Slices
+    // (__tl_str_sub, __tl_str_trim) share the mapping; it is unmapped once
+    // the GC finds no view referencing it.
+    if (name == "__tl_file_map") {
+        int fd = ::open(str0().c_str(), O_RDONLY);
+        if (fd < 0) return TLValue::fromStr("");
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return TLValue::fromStr("");
+        }
+        size_t size = (size_t)st.st_size;
+        const char* data = nullptr;
+        if (size > 0) {
+            void* m = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m == MAP_FAILED) { ::close(fd); return TLValue::fromStr(""); }
+            data = static_cast<const char*>(m);
+        }
+        ::close(fd);
+        maybeCollect();
+        TLMapping* map = heap_.allocMapping(data, size);
+        return TLValue::fromView(heap_.allocView(map, 0, size));
+    }
+
+    // ── Async file I/O ───────────────────────────────────────────────────
+    // Submit returns a handle at once; the read/write runs on asyncIO_'s
+    // worker pool.  poll() is non-blocking, await_*() blocks and releases.
+    if (name == "__tl_file_read_async")
+        return TLValue::fromInt(asyncIO_.submit(AsyncIO::Kind::Read, str0()));
+    if (name == "__tl_file_write_async")
+        return TLValue::fromInt(asyncIO_.submit(AsyncIO::Kind::Write, str0(), str1()));
+    if (name == "__tl_file_append_async")
+        return TLValue::fromInt(asyncIO_.submit(AsyncIO::Kind::Append, str0(), str1()));
+    if (name == "__tl_async_poll")
+        return TLValue::fromInt(asyncIO_.poll(i32_0()) ? 1 : 0);
+    if (name == "__tl_async_await_str" || name == "__tl_async_await_i32") {
+        std::string out;
+        int status = 0;
+        if (!asyncIO_.await(i32_0(), out, status))
+            throw std::runtime_error("invalid async handle: " +
+                                     std::to_string(i32_0()));
+        if (name == "__tl_async_await_str") return TLValue::fromStr(std::move(out));
+        return TLValue::fromInt(status);
+    }
+
+    // ── Directory operations ───────────────────────────────────────────────
+    if (name == "__tl_dir_exists") {
+        std::error_code ec;
+        return TLValue::fromInt(
+            std::filesystem::is_directory(str0(), ec) ? 1 : 0);
+    }
+    if (name == "__tl_dir_create") {
+        std::error_code ec;
+        return TLValue::fromInt(
+            std::filesystem::create_directories(str0(), ec) ? 1 : 0);
+    }
+    if (name == "__tl_dir_delete") {
+        std::error_code ec;
+        std::filesystem::remove_all(str0(), ec);
+        return TLValue::fromInt(ec ? 0 : 1);
+    }
+    // __tl_dir_list is the older name of __tl_dir_list_all.
+    if (name == "__tl_dir_list_all" || name == "__tl_dir_list") {
+        // Returns a TLArray of string entries (filenames only, no path).
+        maybeCollect();
+        auto* arr = heap_.allocArray("str");
+        if (DIR* d = opendir(str0().c_str())) {
+            while (const char* n = nextDirEntry(d))
+                arr->elements.push_back(TLValue::fromStr(n));
+            closedir(d);
+        }
+        return TLValue::fromArr(arr);
+    }
+    if (name == "__tl_dir_list_count") {
+        int count = 0;
+        if (DIR* d = opendir(str0().c_str())) {
+            while (nextDirEntry(d)) ++count;
+            closedir(d);
+        }
+        return TLValue::fromInt(count);
+    }
+    // Rescans from the start on every call; prefer the iterator or
+    // __tl_dir_list_all for walking a whole directory.
+    if (name == "__tl_dir_list_entry") {
+        int idx = i32_1();
+        std::string found;
+        if (DIR* d = opendir(str0().c_str())) {
+            int i = 0;
+            while (const char* n = nextDirEntry(d))
+                if (i++ == idx) { found = n; break; }
+            closedir(d);
+        }
+        return TLValue::fromStr(std::move(found));
+    }
+
+    // ── Directory iterators (handles are ints, 0 = failed to open) ───────
+    if (name == "__tl_dir_open") {
+        DIR* d = opendir(str0().c_str());
+        if (!d) return TLValue::fromInt(0);
+        auto slot = std::find(dirs_.begin(), dirs_.end(), nullptr);
+        if (slot == dirs_.end()) slot = dirs_.insert(slot, nullptr);
+        slot->reset(d);
+        return TLValue::fromInt((int)(slot - dirs_.begin()) + 1);
+    }
+    // Next entry name, or "" once the directory is exhausted.
+    if (name == "__tl_dir_next") {
+        const char* n = nextDirEntry(dirFor(i32_0()));
+        return TLValue::fromStr(n ? n : "");
+    }
+    if (name == "__tl_dir_close") {
+        dirFor(i32_0());   // validates the handle
+        dirs_[i32_0() - 1].reset();
+        return TLValue::nil();
+    }
+
+    // ── SPSC queues ──────────────────────────────────────────────────────
+    // Int-only and lock-free (spsc.hpp); the script is one end, an embedder
+    // thread (see spscQueue()) or the script itself the other.
+    if (name == "__tl_spsc_new")
+        return TLValue::fromInt(addSpscQueue(
+            std::make_shared<SpscQueue>((size_t)std::max(1, i32_0()))));
+    if (name == "__tl_spsc_push")
+        return TLValue::fromInt(spscQueue(i32_0())->push(i32_1()) ? 1 : 0);
+    // pop_or returns at once; take waits for a value until the queue is
+    // closed.  Both return the second argument when there is none.
+    if (name == "__tl_spsc_pop_or" || name == "__tl_spsc_take") {
+        auto q = spscQueue(i32_0());
+        int32_t v;
+        bool got = name == "__tl_spsc_take" ? q->take(v) : q->pop(v);
+        return TLValue::fromInt(got ? v : i32_1());
+    }
+    if (name == "__tl_spsc_len")    return TLValue::fromInt((int)spscQueue(i32_0())->size());
+    if (name == "__tl_spsc_closed") return TLValue::fromInt(spscQueue(i32_0())->closed() ? 1 : 0);
+    if (name == "__tl_spsc_close") {
+        spscQueue(i32_0())->close();
+        return TLValue::nil();
+    }
+    if (name == "__tl_spsc_free") {
+        spscQueue(i32_0());   // validates the handle
+        spsc_[i32_0() - 1].reset();
+        return TLValue::nil();
+    }
+
+    throw std::runtime_error("unknown native function: " + name);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "tir.hpp"
+#include "object.hpp"
+#include "asyncio.hpp"
+#include "linereader.hpp"
+#include "spsc.hpp"
+
+#include <dirent.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Runtime services shared by the TLValue interpreters (TIRVM and the
+// tree-walking engine):
+//   • value helpers — arithmetic, comparison, casts, formatting, print —
+//     so both engines give identical results for the same program;
+//   • NativeLib — the "__tl_*" built-in functions (strings, arrays,
+//     collections, ring buffers, SPSC queues, math, files, readers, stdin,
+//     mmap, async I/O, directories).
+// ---------------------------------------------------------------------------
+
+TLValue     tlDefault(const TIR::Type& ty);
+std::string tlToString(const TLValue& v);
+TLValue     tlArith  (const TLValue& l, const TLValue& r, TIR::Op op);  // Add..Div
+TLValue     tlCompare(const TLValue& l, const TLValue& r, TIR::Op op);  // CmpEq..CmpGt
+TLValue     tlCast   (const TLValue& v, TIR::Op op);                    // CastI32..CastStr
+void        tlPrint  (const TLValue& v);
+
+class NativeLib {
+public:
+    // collect runs a full mark-and-sweep of heap.  NativeLib only triggers it
+    // before allocating, while the caller still roots every argument.
+    NativeLib(TLHeap& heap, std::function<void()> collect)
+        : heap_(heap), collect_(std::move(collect)) {}
+
+    static bool isNative(const std::string& name) {
+        return name.size() >= 5 && name.compare(0, 5, "__tl_") == 0;
+    }
+
+    // Throws std::runtime_error for an unknown name.
+    TLValue call(const std::string& name, const std::vector<TLValue>& args);
+
+    // Embedder access to the __tl_spsc_* queues.  Call both from the
+    // interpreter's thread (e.g. before run()); the returned queue itself may
+    // then be pushed to from one other thread.  A queue registered with
+    // addSpscQueue gets the next free handle, 1 for the first.
+    std::shared_ptr<SpscQueue> spscQueue(int handle);
+    int addSpscQueue(std::shared_ptr<SpscQueue> q);
+
+private:
+    TLHeap&               heap_;
+    std::function<void()> collect_;
+
+    // Background file I/O for the __tl_*_async builtins.
+    AsyncIO               asyncIO_;
+
+    // Open __tl_reader_* handles; handle h lives in readers_[h - 1], closed
+    // slots are null and reused.
+    std::vector<std::unique_ptr<LineReader>> readers_;
+    LineReader& readerFor(int handle);
+
+    // Open __tl_dir_* iterators, same handle scheme as readers_.
+    struct DirCloser { void operator()(DIR* d) const { closedir(d); } };
+    std::vector<std::unique_ptr<DIR, DirCloser>> dirs_;
+    DIR* dirFor(int handle);
+
+    // __tl_spsc_* queues, same handle scheme as readers_; shared so that an
+    // embedder's producer thread keeps its queue alive after __tl_spsc_free.
+    std::vector<std::shared_ptr<SpscQueue>> spsc_;
+
+    // Native collections (__tl_vec_* / map_* / set_* / deque_* / pq_* /
+    // ring_*).
+    static bool isCollection(const std::string& name);
+    TLValue callCollection(const std::string& name, const std::vector<TLValue>& args);
+    TLValue callMath(const std::string& name, const std::vector<TLValue>& args);   // __tl_math_*
+
+    void maybeCollect() { if (heap_.shouldCollect()) collect_(); }
+};
@@ -0,0 +1,76 @@
+#include "outbuf.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+OutBuf& OutBuf::instance() {
+    static OutBuf out;
+    return out;
+}
+
+OutBuf::OutBuf() : tty_(::isatty(STDOUT_FILENO) != 0) {}
+
+OutBuf::~OutBuf() { flush(); }
+
+void OutBuf::writeAll(const char* p, size_t n) {
+    while (n > 0) {
+        ssize_t w = ::write(STDOUT_FILENO, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return;   // stdout closed — drop output like stdio would
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+}
+
+void OutBuf::flush() {
+    // Anything the driver wrote through iostreams/stdio must come first.
+    std::cout.flush();
+    std::fflush(stdout);
+    writeAll(buf_, len_);
+    len_ = 0;
+}
+
+void OutBuf::str(std::string_view s) {
+    if (len_ + s.size() > CAP) {
+        flush();
+        if (s.size() > CAP) { writeAll(s.data(), s.size()); return; }
+    }
+    std::memcpy(buf_ + len_, s.data(), s.size());
+    len_ += s.size();
+}
+
+void OutBuf::ch(char c) {
+    if (len_ == CAP) flush();
+    buf_[len_++] = c;
+}
+
+void OutBuf::i32(int32_t v) {
+    if (len_ + 16 > CAP) flush();
+    len_ = std::to_chars(buf_ + len_, buf_ + CAP, v).ptr - buf_;
+}
+
+void OutBuf::f64(double v) {
+    if (len_ + 32 > CAP) flush();
+    if (v >= -1e15 && v <= 1e15 && (double)(long long)v == v) {
+        len_ = std::to_chars(buf_ + len_, buf_ + CAP, (long long)v).ptr - buf_;
+        return;
+    }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    len_ = std::to_chars(buf_ + len_, buf_ + CAP, v,
+                         std::chars_format::general, 6).ptr - buf_;
+#else
+    // Standard libraries without floating-point to_chars.
+    len_ += (size_t)std::snprintf(buf_ + len_, CAP - len_, "%g", v);
+#endif
+}
+
+void OutBuf::newline() {
+    ch('\n');
+    if (tty_) flush();
+}
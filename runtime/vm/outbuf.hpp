@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// ---------------------------------------------------------------------------
+// OutBuf – buffered stdout for the interpreters (TIRVM and IRVM).
+//
+// Design notes:
+//   • Bypasses iostreams/stdio: values are formatted with std::to_chars into
+//     a fixed buffer and written with write(2).
+//   • Flushes when the buffer is full, on newline when stdout is a terminal,
+//     before reading stdin, when a VM run ends, and at process exit.
+//   • Number formatting matches tinyrt.c byte for byte: integral doubles in
+//     ±1e15 print as integers, everything else as printf("%g").
+// ---------------------------------------------------------------------------
+
+class OutBuf {
+public:
+    static OutBuf& instance();
+
+    void str(std::string_view s);
+    void i32(int32_t v);
+    void f64(double v);
+    void ch(char c);
+
+    // Append '\n'; flushes immediately when stdout is a terminal.
+    void newline();
+
+    void flush();
+
+    ~OutBuf();
+
+private:
+    OutBuf();
+    OutBuf(const OutBuf&)            = delete;
+    OutBuf& operator=(const OutBuf&) = delete;
+
+    static constexpr size_t CAP = 64 * 1024;
+
+    char   buf_[CAP];
+    size_t len_ = 0;
+    bool   tty_ = false;
+
+    void writeAll(const char* p, size_t n);
+};
+
+// Flushes OutBuf when a VM run ends — also when it ends by exception, so
+// program output precedes any error the driver then prints to stderr.
+struct OutFlushGuard {
+    ~OutFlushGuard() { OutBuf::instance().flush(); }
+};
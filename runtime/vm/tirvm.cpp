@@ -1,11 +1,9 @@
 #include "tirvm.hpp"
-#include <iostream>
+#include "outbuf.hpp"
+#include "inbuf.hpp"
 #include <fstream>
-#include <sstream>
 #include <stdexcept>
 #include <algorithm>
-#include <cctype>
-#include <filesystem>
 
 // ─────────────────────────────────────────────────────────────────────────────
 // Mark-and-sweep GC
@@ -25,18 +23,6 @@ void TIRVM::runGC() {
     heap_.sweep();
 }
 
-// ─────────────────────────────────────────────────────────────────────────────
-// Default value for a given TIR type
-// ─────────────────────────────────────────────────────────────────────────────
-
-TLValue TIRVM::defaultValue(TIR::Type ty) {
-    if (ty.isI32() || ty.isI1()) return TLValue::fromInt(0);
-    if (ty.isF64())               return TLValue::fromFloat(0.0);
-    if (ty.isChar())              return TLValue::fromChar('\0');
-    if (ty.isStr())               return TLValue::fromStr("");
-    return TLValue::nil();
-}
-
 // ─────────────────────────────────────────────────────────────────────────────
 // Evaluate a Val operand → TLValue
 // ─────────────────────────────────────────────────────────────────────────────
@@ -57,114 +43,6 @@ TLValue TIRVM::evalVal(const TIR::Val& v, const TIRFrame& frame) const {
     throw std::runtime_error("TIRVM: undefined register %" + std::to_string(v.reg));
 }
 
-// ─────────────────────────────────────────────────────────────────────────────
-// Value → string (for print and string concatenation)
-// ─────────────────────────────────────────────────────────────────────────────
-
-std::string TIRVM::valueToString(const TLValue& v) const {
-    switch (v.tag) {
-    case TLValue::Tag::Bool:
-    case TLValue::Tag::I32:  return std::to_string(v.p.i);
-    case TLValue::Tag::F64: {
-        std::string s = std::to_string(v.p.d);
-        s.erase(s.find_last_not_of('0') + 1);
-        if (s.back() == '.') s.pop_back();
-        return s;
-    }
-    case TLValue::Tag::Char: return std::string(1, v.p.c);
-    case TLValue::Tag::Str:  return v.sval;
-    case TLValue::Tag::Obj:  return v.p.obj ? "[" + v.p.obj->className + "]" : "null";
-    case TLValue::Tag::Arr:  return "[array]";
-    default:                 return "nil";
-    }
-}
-
-// ─────────────────────────────────────────────────────────────────────────────
-// Arithmetic
-// ─────────────────────────────────────────────────────────────────────────────
-
-TLValue TIRVM::arith(const TLValue& l, const TLValue& r, TIR::Op op) const {
-    // String concatenation via +
-    if (op == TIR::Op::Add &&
-        (l.tag == TLValue::Tag::Str || r.tag == TLValue::Tag::Str))
-        return TLValue::fromStr(valueToString(l) + valueToString(r));
-
-    // Float promotion
-    bool isFloat = (l.tag == TLValue::Tag::F64 || r.tag == TLValue::Tag::F64);
-    if (isFloat) {
-        double lv = (l.tag==TLValue::Tag::F64)  ? l.p.d
-                  : (l.tag==TLValue::Tag::Char) ? (double)(unsigned char)l.p.c
-                  : (double)l.p.i;
-        double rv = (r.tag==TLValue::Tag::F64)  ? r.p.d
-                  : (r.tag==TLValue::Tag::Char) ? (double)(unsigned char)r.p.c
-                  : (double)r.p.i;
-        switch (op) {
-        case TIR::Op::Add: return TLValue::fromFloat(lv + rv);
-        case TIR::Op::Sub: return TLValue::fromFloat(lv - rv);
-        case TIR::Op::Mul: return TLValue::fromFloat(lv * rv);
-        case TIR::Op::Div:
-            if (rv == 0.0) throw std::runtime_error("TIRVM: division by zero");
-            return TLValue::fromFloat(lv / rv);
-        default: break;
-        }
-    }
-
-    int lv = (l.tag==TLValue::Tag::Char) ? (int)(unsigned char)l.p.c : l.p.i;
-    int rv = (r.tag==TLValue::Tag::Char) ? (int)(unsigned char)r.p.c : r.p.i;
-    switch (op) {
-    case TIR::Op::Add: return TLValue::fromInt(lv + rv);
-    case TIR::Op::Sub: return TLValue::fromInt(lv - rv);
-    case TIR::Op::Mul: return TLValue::fromInt(lv * rv);
-    case TIR::Op::Div:
-        if (rv == 0) throw std::runtime_error("TIRVM: division by zero");
-        return TLValue::fromInt(lv / rv);
-    default: break;
-    }
-    throw std::runtime_error("TIRVM: unsupported arithmetic op");
-}
-
-// ─────────────────────────────────────────────────────────────────────────────
-// Comparison
-// ─────────────────────────────────────────────────────────────────────────────
-
-TLValue TIRVM::compare(const TLValue& l, const TLValue& r, TIR::Op op) const {
-    // String comparison by value
-    if (l.tag == TLValue::Tag::Str || r.tag == TLValue::Tag::Str) {
-        std::string ls = valueToString(l), rs = valueToString(r);
-        if (op == TIR::Op::CmpEq) return TLValue::fromInt(ls==rs ? 1 : 0);
-        if (op == TIR::Op::CmpNe) return TLValue::fromInt(ls!=rs ? 1 : 0);
-        throw std::runtime_error("TIRVM: < / > not supported for strings");
-    }
-    // Object comparison by pointer identity
-    if (l.tag == TLValue::Tag::Obj || r.tag == TLValue::Tag::Obj) {
-        bool eq = (l.p.obj == r.p.obj);
-        if (op == TIR::Op::CmpEq) return TLValue::fromInt(eq  ? 1 : 0);
-        if (op == TIR::Op::CmpNe) return TLValue::fromInt(!eq ? 1 : 0);
-        throw std::runtime_error("TIRVM: < / > not supported for objects");
-    }
-    if (l.tag == TLValue::Tag::Char && r.tag == TLValue::Tag::Char) {
-        if (op == TIR::Op::CmpEq) return TLValue::fromInt(l.p.c==r.p.c ? 1 : 0);
-        if (op == TIR::Op::CmpNe) return TLValue::fromInt(l.p.c!=r.p.c ? 1 : 0);
-        if (op == TIR::Op::CmpLt) return TLValue::fromInt(l.p.c< r.p.c ? 1 : 0);
-        if (op == TIR::Op::CmpGt) return TLValue::fromInt(l.p.c> r.p.c ? 1 : 0);
-    }
-    bool isFloat = (l.tag==TLValue::Tag::F64 || r.tag==TLValue::Tag::F64);
-    if (isFloat) {
-        double lv = (l.tag==TLValue::Tag::F64) ? l.p.d : (double)l.p.i;
-        double rv = (r.tag==TLValue::Tag::F64) ? r.p.d : (double)r.p.i;
-        if (op == TIR::Op::CmpEq) return TLValue::fromInt(lv==rv ? 1 : 0);
-        if (op == TIR::Op::CmpNe) return TLValue::fromInt(lv!=rv ? 1 : 0);
-        if (op == TIR::Op::CmpLt) return TLValue::fromInt(lv< rv ? 1 : 0);
-        if (op == TIR::Op::CmpGt) return TLValue::fromInt(lv> rv ? 1 : 0);
-    } else {
-        if (op == TIR::Op::CmpEq) return TLValue::fromInt(l.p.i==r.p.i ? 1 : 0);
-        if (op == TIR::Op::CmpNe) return TLValue::fromInt(l.p.i!=r.p.i ? 1 : 0);
-        if (op == TIR::Op::CmpLt) return TLValue::fromInt(l.p.i< r.p.i ? 1 : 0);
-        if (op == TIR::Op::CmpGt) return TLValue::fromInt(l.p.i> r.p.i ? 1 : 0);
-    }
-    throw std::runtime_error("TIRVM: unsupported comparison op");
-}
-
 // ─────────────────────────────────────────────────────────────────────────────
 // Object / class helpers
 // ─────────────────────────────────────────────────────────────────────────────
@@ -186,12 +64,16 @@ void TIRVM::collectAllFields(const std::string& cls,
 }
 
 void TIRVM::initObjectFields(const std::string& cls, TLObject* obj) {
-    std::vector<std::pair<TIR::Type,std::string>> allFields;
-    collectAllFields(cls, allFields);
-    obj->fieldDefs = std::move(allFields);
-    obj->fields.resize(obj->fieldDefs.size());
-    for (int i = 0; i < (int)obj->fieldDefs.size(); ++i)
-        obj->fields[i] = defaultValue(obj->fieldDefs[i].first);
+    auto& layout = layoutCache_[cls];
+    if (!layout) {
+        auto l = std::make_shared<TLLayout>();
+        collectAllFields(cls, l->defs);
+        layout = std::move(l);
+    }
+    obj->layout = layout;
+    obj->fields.resize(layout->defs.size());
+    for (int i = 0; i < (int)layout->defs.size(); ++i)
+        obj->fields[i] = tlDefault(layout->defs[i].first);
 }
 
 const TIR::Func* TIRVM::findMethod(const std::string& cls,
@@ -243,7 +125,7 @@ TIRVM::ExecResult TIRVM::execBlock(const TIR::Block& block,
 
         // ── Memory model ───────────────────────────────────────────────────
         case TIR::Op::Alloc:
-            frame.mem[ins.dest] = defaultValue(ins.type);
+            frame.mem[ins.dest] = tlDefault(ins.type);
             break;
 
         case TIR::Op::Load: {
@@ -278,7 +160,7 @@ TIRVM::ExecResult TIRVM::execBlock(const TIR::Block& block,
         case TIR::Op::Mul: case TIR::Op::Div: {
             TLValue l = evalVal(ins.args[0], frame);
             TLValue r = evalVal(ins.args[1], frame);
-            frame.regs[ins.dest] = arith(l, r, ins.op);
+            frame.regs[ins.dest] = tlArith(l, r, ins.op);
             break;
         }
         case TIR::Op::Neg: {
@@ -293,7 +175,7 @@ TIRVM::ExecResult TIRVM::execBlock(const TIR::Block& block,
         case TIR::Op::CmpLt: case TIR::Op::CmpGt: {
             TLValue l = evalVal(ins.args[0], frame);
             TLValue r = evalVal(ins.args[1], frame);
-            frame.regs[ins.dest] = compare(l, r, ins.op);
+            frame.regs[ins.dest] = tlCompare(l, r, ins.op);
             break;
         }
 
@@ -317,54 +199,17 @@ TIRVM::ExecResult TIRVM::execBlock(const TIR::Block& block,
         }
 
         // ── Casts ──────────────────────────────────────────────────────────
-        case TIR::Op::CastI32: {
-            TLValue v = evalVal(ins.args[0], frame);
-            int iv = (v.tag==TLValue::Tag::F64)  ? (int)v.p.d
-                   : (v.tag==TLValue::Tag::Char)  ? (int)(unsigned char)v.p.c
-                   : (v.tag==TLValue::Tag::Str)   ? (v.sval.empty() ? 0 : (int)v.sval[0])
-                   : v.p.i;
-            frame.regs[ins.dest] = TLValue::fromInt(iv);
-            break;
-        }
-        case TIR::Op::CastF64: {
-            TLValue v = evalVal(ins.args[0], frame);
-            double dv = (v.tag==TLValue::Tag::F64)  ? v.p.d
-                      : (v.tag==TLValue::Tag::Char)  ? (double)(unsigned char)v.p.c
-                      : (double)v.p.i;
-            frame.regs[ins.dest] = TLValue::fromFloat(dv);
+        case TIR::Op::CastI32: case TIR::Op::CastF64: case TIR::Op::CastChar:
+        case TIR::Op::CastI1:  case TIR::Op::CastStr:
+            frame.regs[ins.dest] = tlCast(evalVal(ins.args[0], frame), ins.op);
             break;
-        }
-        case TIR::Op::CastChar: {
-            TLValue v = evalVal(ins.args[0], frame);
-            char cv = (v.tag==TLValue::Tag::Char) ? v.p.c : (char)v.p.i;
-            frame.regs[ins.dest] = TLValue::fromChar(cv);
-            break;
-        }
-        case TIR::Op::CastI1: {
-            TLValue v = evalVal(ins.args[0], frame);
-            frame.regs[ins.dest] = TLValue::fromInt(v.isTruthy() ? 1 : 0);
-            break;
-        }
-        case TIR::Op::CastStr: {
-            TLValue v = evalVal(ins.args[0], frame);
-            frame.regs[ins.dest] = TLValue::fromStr(valueToString(v));
-            break;
-        }
 
         // ── I/O ────────────────────────────────────────────────────────────
-        case TIR::Op::Print: {
-            TLValue v = evalVal(ins.args[0], frame);
-            switch (v.tag) {
-            case TLValue::Tag::Str:  std::cout << v.sval    << "\n"; break;
-            case TLValue::Tag::F64:  std::cout << v.p.d     << "\n"; break;
-            case TLValue::Tag::Char: std::cout << v.p.c     << "\n"; break;
-            default:                 std::cout << v.p.i     << "\n"; break;
-            }
+        case TIR::Op::Print:
+            tlPrint(evalVal(ins.args[0], frame));
             break;
-        }
         case TIR::Op::Input: {
-            int val; std::cin >> val;
-            frame.regs[ins.dest] = TLValue::fromInt(val);
+            frame.regs[ins.dest] = TLValue::fromInt(InBuf::instance().nextInt());
             break;
         }
         case TIR::Op::ReadFile: {
@@ -473,7 +318,7 @@ TIRVM::ExecResult TIRVM::execBlock(const TIR::Block& block,
                 for (auto& a : ins.args) arr->elements.push_back(evalVal(a, frame));
             } else {
                 int sz = evalVal(ins.args[0], frame).p.i;
-                arr->elements.resize(sz, defaultValue(TIR::Type::i32()));
+                arr->elements.resize(sz, tlDefault(TIR::Type::i32()));
             }
             frame.regs[ins.dest] = TLValue::fromArr(arr);
             if (heap_.shouldCollect()) runGC();
@@ -547,8 +392,8 @@ TLValue TIRVM::callFunc(const std::string& funcKey,
                          TLObject* thisObj,
                          const std::string& className) {
     // Dispatch native built-ins (names starting with "__tl_").
-    if (funcKey.size() >= 5 && funcKey.compare(0, 5, "__tl_") == 0)
-        return callNative(funcKey, args);
+    if (NativeLib::isNative(funcKey))
+        return natives_.call(funcKey, args);
 
     auto it = prog_->funcs.find(funcKey);
     if (it == prog_->funcs.end())
@@ -588,6 +433,7 @@ TLValue TIRVM::callFunc(const std::string& funcKey,
 // ─────────────────────────────────────────────────────────────────────────────
 
 void TIRVM::run(const TIR::Program& prog) {
+    OutFlushGuard flushOnExit;
     prog_ = &prog;
     const TIR::Func& gi = prog.globalInit;
     if (gi.blocks.empty()) return;
@@ -625,232 +471,3 @@ void runTIR(const TIR::Program& prog) {
     TIRVM vm;
     vm.run(prog);
 }
-
-// ─────────────────────────────────────────────────────────────────────────────
-// Native built-in function dispatch (names beginning with "__tl_")
-// ─────────────────────────────────────────────────────────────────────────────
-
-TLValue TIRVM::callNative(const std::string& name, const std::vector<TLValue>& args) {
-    auto str0 = [&]() -> const std::string& {
-        static const std::string empty;
-        return args.empty() ? empty : args[0].sval;
-    };
-    auto str1 = [&]() -> const std::string& {
-        static const std::string empty;
-        return args.size() < 2 ? empty : args[1].sval;
-    };
-    auto i32_0 = [&]() { return args.empty() ? 0 : args[0].p.i; };
-    auto i32_1 = [&]() { return args.size() < 2 ? 0 : args[1].p.i; };
-    auto i32_2 = [&]() { return args.size() < 3 ? 0 : args[2].p.i; };
-
-    // ── Print (already handled by Op::Print, but support as function too) ──
-    if (name == "__tl_print_i32")  { std::cout << i32_0()    << "\n"; return TLValue::nil(); }
-    if (name == "__tl_print_f64")  { std::cout << args[0].p.d << "\n"; return TLValue::nil(); }
-    if (name == "__tl_print_str")  { std::cout << str0()     << "\n"; return TLValue::nil(); }
-    if (name == "__tl_print_bool") { std::cout << (i32_0() ? "true" : "false") << "\n"; return TLValue::nil(); }
-    if (name == "__tl_print_char") { std::cout << (char)i32_0() << "\n"; return TLValue::nil(); }
-
-    // ── Conversion ────────────────────────────────────────────────────────
-    if (name == "__tl_i32_to_str")  return TLValue::fromStr(std::to_string(i32_0()));
-    if (name == "__tl_f64_to_str") {
-        std::ostringstream ss; ss << args[0].p.d; return TLValue::fromStr(ss.str());
-    }
-    if (name == "__tl_bool_to_str") return TLValue::fromStr(i32_0() ? "true" : "false");
-    if (name == "__tl_str_concat")  return TLValue::fromStr(str0() + str1());
-    if (name == "__tl_str_eq")      return TLValue::fromInt(str0() == str1() ? 1 : 0);
-
-    // ── String ────────────────────────────────────────────────────────────
-    if (name == "__tl_str_len")
-        return TLValue::fromInt((int)str0().size());
-
-    if (name == "__tl_str_sub") {
-        const std::string& s = str0();
-        int start = i32_1(), len = i32_2();
-        if (start < 0) start = 0;
-        if (start >= (int)s.size()) return TLValue::fromStr("");
-        return TLValue::fromStr(s.substr(start, std::max(0, len)));
-    }
-
-    if (name == "__tl_str_upper") {
-        std::string r = str0();
-        for (char& c : r) c = (char)std::toupper((unsigned char)c);
-        return TLValue::fromStr(r);
-    }
-    if (name == "__tl_str_lower") {
-        std::string r = str0();
-        for (char& c : r) c = (char)std::tolower((unsigned char)c);
-        return TLValue::fromStr(r);
-    }
-    if (name == "__tl_str_trim") {
-        const std::string& s = str0();
-        size_t l = s.find_first_not_of(" \t\n\r\f\v");
-        if (l == std::string::npos) return TLValue::fromStr("");
-        size_t r = s.find_last_not_of(" \t\n\r\f\v");
-        return TLValue::fromStr(s.substr(l, r - l + 1));
-    }
-    if (name == "__tl_str_contains")
-        return TLValue::fromInt(str0().find(str1()) != std::string::npos ? 1 : 0);
-
-    if (name == "__tl_str_starts_with") {
-        const std::string& s = str0(), &p = str1();
-        return TLValue::fromInt(s.size() >= p.size() && s.compare(0, p.size(), p) == 0 ? 1 : 0);
-    }
-    if (name == "__tl_str_ends_with") {
-        const std::string& s = str0(), &p = str1();
-        return TLValue::fromInt(s.size() >= p.size() &&
-                                s.compare(s.size() - p.size(), p.size(), p) == 0 ? 1 : 0);
-    }
-    if (name == "__tl_str_index_of") {
-        auto pos = str0().find(str1());
-        return TLValue::fromInt(pos == std::string::npos ? -1 : (int)pos);
-    }
-    if (name == "__tl_str_replace") {
-        std::string s = str0();
-        const std::string& from = str1();
-        const std::string& to   = args.size() < 3 ? "" : args[2].sval;
-        if (from.empty()) return TLValue::fromStr(s);
-        std::string out;
-        size_t pos = 0;
-        while (true) {
-            size_t f = s.find(from, pos);
-            if (f == std::string::npos) { out += s.substr(pos); break; }
-            out += s.substr(pos, f - pos) + to;
-            pos = f + from.size();
-        }
-        return TLValue::fromStr(out);
-    }
-    if (name == "__tl_str_to_int") {
-        try { return TLValue::fromInt(std::stoi(str0())); }
-        catch (...) { return TLValue::fromInt(0); }
-    }
-    if (name == "__tl_str_to_float") {
-        try { return TLValue::fromFloat(std::stod(str0())); }
-        catch (...) { return TLValue::fromFloat(0.0); }
-    }
-    if (name == "__tl_str_len") // duplicate guard
-        return TLValue::fromInt((int)str0().size());
-    if (name == "__tl_str_char_at") {
-        const std::string& s = str0(); int i = i32_1();
-        if (i < 0 || i >= (int)s.size()) return TLValue::fromInt(0);
-        return TLValue::fromInt((unsigned char)s[i]);
-    }
-
-    // ── Array helpers (used by Vec/Map stdlib classes) ────────────────────
-    // Allocate a new array of given capacity pre-filled with default values.
-    if (name == "__tl_alloc_arr") {
-        int cap = i32_0();
-        TLArray* arr = heap_.allocArray("any");
-        arr->elements.resize(cap > 0 ? cap : 0, TLValue::nil());
-        if (heap_.shouldCollect()) runGC();
-        return TLValue::fromArr(arr);
-    }
-    if (name == "__tl_arr_len") {
-        if (args.empty() || !args[0].isArr()) return TLValue::fromInt(0);
-        return TLValue::fromInt((int)args[0].p.arr->elements.size());
-    }
-    if (name == "__tl_load_arr") {
-        if (args.size() < 2 || !args[0].isArr()) return TLValue::nil();
-        TLArray* arr = args[0].p.arr;
-        int idx = i32_1();
-        if (idx < 0 || idx >= (int)arr->elements.size()) return TLValue::nil();
-        return arr->elements[idx];
-    }
-    if (name == "__tl_store_arr") {
-        // args: (arr, idx, val)
-        if (args.size() < 3 || !args[0].isArr()) return TLValue::nil();
-        TLArray* arr = args[0].p.arr;
-        int idx = i32_1();
-        if (idx >= 0 && idx < (int)arr->elements.size())
-            arr->elements[idx] = args[2];
-        return TLValue::nil();
-    }
-    // Resize an array: copies existing elements, pads with nil.
-    if (name == "__tl_arr_resize") {
-        if (args.empty() || !args[0].isArr()) return TLValue::nil();
-        TLArray* arr = args[0].p.arr;
-        int newCap = i32_1();
-        arr->elements.resize(newCap > 0 ? newCap : 0, TLValue::nil());
-        return TLValue::fromArr(arr);
-    }
-
-    // ── File ─────────────────────────────────────────────────────────────
-    if (name == "__tl_file_exists") {
-        std::ifstream f(str0());
-        return TLValue::fromInt(f.good() ? 1 : 0);
-    }
-    if (name == "__tl_file_read_all") {
-        std::ifstream f(str0());
-        if (!f.is_open()) return TLValue::fromStr("");
-        std::ostringstream ss; ss << f.rdbuf();
-        return TLValue::fromStr(ss.str());
-    }
-    if (name == "__tl_file_write_all") {
-        std::ofstream f(str0());
-        if (!f.is_open()) return TLValue::fromInt(0);
-        f << str1();
-        return TLValue::fromInt(f.good() ? 1 : 0);
-    }
-    if (name == "__tl_file_append") {
-        std::ofstream f(str0(), std::ios::app);
-        if (!f.is_open()) return TLValue::fromInt(0);
-        f << str1();
-        return TLValue::fromInt(f.good() ? 1 : 0);
-    }
-    if (name == "__tl_file_delete") {
-        return TLValue::fromInt(std::remove(str0().c_str()) == 0 ? 1 : 0);
-    }
-
-    // ── Directory operations ───────────────────────────────────────────────
-    if (name == "__tl_dir_exists") {
-        std::error_code ec;
-        return TLValue::fromInt(
-            std::filesystem::is_directory(str0(), ec) ? 1 : 0);
-    }
-    if (name == "__tl_dir_create") {
-        std::error_code ec;
-        return TLValue::fromInt(
-            std::filesystem::create_directories(str0(), ec) ? 1 : 0);
-    }
-    if (name == "__tl_dir_delete") {
-        std::error_code ec;
-        std::filesystem::remove_all(str0(), ec);
-        return TLValue::fromInt(ec ? 0 : 1);
-    }
-    if (name == "__tl_dir_list") {
-        // Returns a TLArray of string entries (filenames only, no path).
-        auto* arr = heap_.allocArray("str");
-        std::error_code ec;
-        std::filesystem::path dirPath(str0());
-        if (std::filesystem::is_directory(dirPath, ec)) {
-            for (const auto& entry :
-                 std::filesystem::directory_iterator(dirPath, ec)) {
-                if (entry.path().filename().string()[0] == '.') continue;
-                arr->elements.push_back(
-                    TLValue::fromStr(entry.path().filename().string()));
-            }
-        }
-        return TLValue::fromArr(arr);
-    }
-    if (name == "__tl_dir_list_count") {
-        std::error_code ec;
-        int count = 0;
-        for (const auto& entry :
-             std::filesystem::directory_iterator(str0(), ec))
-            if (entry.path().filename().string()[0] != '.') ++count;
-        return TLValue::fromInt(ec ? 0 : count);
-    }
-    if (name == "__tl_dir_list_entry") {
-        std::error_code ec;
-        int idx = (args.size() > 1) ? args[1].p.i : 0;
-        int i = 0;
-        for (const auto& entry :
-             std::filesystem::directory_iterator(str0(), ec)) {
-            if (entry.path().filename().string()[0] == '.') continue;
-            if (i++ == idx)
-                return TLValue::fromStr(entry.path().filename().string());
-        }
-        return TLValue::fromStr("");
-    }
-
-    throw std::runtime_error("TIRVM: unknown native function: " + name);
-}
@@ -1,7 +1,9 @@
 #pragma once
 #include "tir.hpp"
 #include "object.hpp"
+#include "natives.hpp"
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -32,6 +34,9 @@ class TIRVM {
 public:
     void run(const TIR::Program& prog);
 
+    // Embedder hook, e.g. natives().addSpscQueue(q) before run().
+    NativeLib& natives() { return natives_; }
+
 private:
     const TIR::Program*      prog_ = nullptr;
     TLHeap                   heap_;
@@ -39,6 +44,9 @@ private:
 
     std::unordered_map<std::string, const TIR::Func*> methodCache_;
 
+    // "__tl_*" built-ins; collects through runGC().
+    NativeLib                natives_{heap_, [this] { runGC(); }};
+
     // RAII guard: pushes frame on entry, pops on any exit (return or exception).
     struct FrameGuard {
         std::vector<TIRFrame*>& stack;
@@ -50,12 +58,6 @@ private:
     // Mark all roots reachable from callStack_, then sweep the heap.
     void runGC();
 
-    // ── Native function dispatch ──────────────────────────────────────────
-    // Called by callFunc() when funcKey starts with "__tl_".
-    // Implements built-in string, array, and file operations in C++
-    // so the interpreter path works without linking tinyrt.c.
-    TLValue callNative(const std::string& name, const std::vector<TLValue>& args);
-
     // ── Evaluation ────────────────────────────────────────────────────────
     TLValue evalVal(const TIR::Val& v, const TIRFrame& frame) const;
 
@@ -78,19 +80,14 @@ private:
     void collectAllFields(const std::string& cls,
                           std::vector<std::pair<TIR::Type, std::string>>& out) const;
     void initObjectFields(const std::string& cls, TLObject* obj);
+    // Per-class field layouts, shared by every instance.
+    std::unordered_map<std::string, std::shared_ptr<const TLLayout>> layoutCache_;
     void resyncFieldSlots(TIRFrame& frame, TLObject* obj);
 
     const TIR::Func* findMethod(const std::string& cls,
                                 const std::string& method) const;
     const TIR::Func* findMethodCached(const std::string& cls,
                                       const std::string& method);
-
-    // ── Value helpers ─────────────────────────────────────────────────────
-    std::string valueToString(const TLValue& v) const;
-    TLValue arith  (const TLValue& l, const TLValue& r, TIR::Op op) const;
-    TLValue compare(const TLValue& l, const TLValue& r, TIR::Op op) const;
-
-    static TLValue defaultValue(TIR::Type ty);
 };
 
 void runTIR(const TIR::Program& prog);
@@ -0,0 +1,491 @@
+#include "treewalk.hpp"
+#include "outbuf.hpp"
+#include "inbuf.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Mark-and-sweep GC
+// ─────────────────────────────────────────────────────────────────────────────
+
+void TreeWalker::runGC() {
+    for (auto* f : callStack_) {
+        if (f->thisObj) heap_.markObject(f->thisObj);
+        for (auto& [name, val] : f->vars) heap_.markValue(val);
+        heap_.markValue(f->ret);
+    }
+    for (auto& v : temps_) heap_.markValue(v);
+    heap_.sweep();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Variables
+//
+// Lookup walks the frame's variables innermost-first; inside a method an
+// unbound name falls back to a field of `this`.
+// ─────────────────────────────────────────────────────────────────────────────
+
+void TreeWalker::declare(const std::string& name, TLValue v) {
+    frame().vars.emplace_back(&name, std::move(v));
+}
+
+TLValue* TreeWalker::findVar(const std::string& name) {
+    auto& vars = frame().vars;
+    for (auto it = vars.rbegin(); it != vars.rend(); ++it)
+        if (*it->first == name) return &it->second;
+    return nullptr;
+}
+
+TLValue TreeWalker::load(const std::string& name) {
+    if (TLValue* v = findVar(name)) return *v;
+    if (TLObject* obj = frame().thisObj) {
+        int idx = obj->fieldIndex(name);
+        if (idx >= 0) return obj->fields[idx];
+    }
+    throw std::runtime_error("tree-walk: undefined variable: " + name);
+}
+
+void TreeWalker::store(const std::string& name, TLValue v) {
+    if (TLValue* slot = findVar(name)) { *slot = std::move(v); return; }
+    if (TLObject* obj = frame().thisObj) {
+        int idx = obj->fieldIndex(name);
+        if (idx >= 0) { obj->fields[idx] = std::move(v); return; }
+    }
+    throw std::runtime_error("tree-walk: undefined variable: " + name);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Classes, objects and arrays
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Same mapping as TIRGen::tyFromStr.
+TIR::Type TreeWalker::tyFromStr(const std::string& s) const {
+    if (s == "int"  || s == "bool") return TIR::Type::i32();
+    if (s == "float")               return TIR::Type::f64();
+    if (s == "char")                return TIR::Type::char_();
+    if (s == "string")              return TIR::Type::str();
+    if (!s.empty() && classes_.count(s))
+        return TIR::Type::obj(s);
+    if (s.size() > 2 && s.substr(s.size()-2) == "[]")
+        return TIR::Type::arr(s.substr(0, s.size()-2));
+    return TIR::Type::void_();
+}
+
+// Flattened (type, name) field list, base class first; built on first use.
+const std::shared_ptr<const TLLayout>& TreeWalker::layout(const std::string& cls) {
+    auto cached = layoutCache_.find(cls);
+    if (cached != layoutCache_.end()) return cached->second;
+
+    auto l = std::make_shared<TLLayout>();
+    auto& out = l->defs;
+    auto it = classes_.find(cls);
+    if (it != classes_.end()) {
+        if (!it->second->baseClass.empty()) out = layout(it->second->baseClass)->defs;
+        for (auto& [fty, fname] : it->second->fields) {
+            auto fi = std::find_if(out.begin(), out.end(),
+                                   [&fname = fname](const auto& x){ return x.second == fname; });
+            if (fi != out.end()) fi->first = tyFromStr(fty);
+            else                 out.emplace_back(tyFromStr(fty), fname);
+        }
+    }
+    return layoutCache_[cls] = std::move(l);
+}
+
+TLObject* TreeWalker::newObject(const std::string& cls) {
+    maybeCollect();
+    const auto& l = layout(cls);
+    TLObject* obj = heap_.allocObject(cls);
+    obj->layout = l;
+    obj->fields.reserve(l->defs.size());
+    for (auto& f : l->defs) obj->fields.push_back(tlDefault(f.first));
+    return obj;
+}
+
+TLArray* TreeWalker::newArray(const std::string& elemType) {
+    maybeCollect();
+    return heap_.allocArray(elemType);
+}
+
+TreeWalker::Method TreeWalker::findMethod(const std::string& cls,
+                                          const std::string& method) {
+    std::string key = cls + "::" + method;
+    auto cached = methodCache_.find(key);
+    if (cached != methodCache_.end()) return cached->second;
+
+    Method found;
+    for (std::string cur = cls; !cur.empty() && !found.fn; ) {
+        auto ci = classes_.find(cur);
+        if (ci == classes_.end()) break;
+        for (auto& m : ci->second->methods)
+            if (m->name == method) { found = {m.get(), ci->second}; break; }
+        cur = ci->second->baseClass;
+    }
+    return methodCache_[key] = found;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Calls
+// ─────────────────────────────────────────────────────────────────────────────
+
+std::vector<TLValue> TreeWalker::evalArgs(const std::vector<std::unique_ptr<Expr>>& args) {
+    size_t base = temps_.size();
+    for (auto& a : args) {
+        TLValue v = eval(a.get());
+        temps_.push_back(std::move(v));
+    }
+    return std::vector<TLValue>(temps_.begin() + base, temps_.end());
+}
+
+TLValue TreeWalker::callFunction(const std::string& name, const std::vector<TLValue>& args) {
+    if (NativeLib::isNative(name)) return natives_.call(name, args);
+    auto it = funcs_.find(name);
+    if (it == funcs_.end())
+        throw std::runtime_error("tree-walk: undefined function: " + name);
+    return invoke(it->second, nullptr, args, nullptr);
+}
+
+TLValue TreeWalker::callMethod(const Method& m, const std::vector<TLValue>& args,
+                               TLObject* thisObj) {
+    return invoke(m.fn, m.cls, args, thisObj);
+}
+
+TLValue TreeWalker::invoke(const FunctionDef* fn, const ClassDef* cls,
+                           const std::vector<TLValue>& args, TLObject* thisObj) {
+    if (args.size() < fn->params.size())
+        throw std::runtime_error("tree-walk: " + fn->name + " expects " +
+                                 std::to_string(fn->params.size()) + " argument(s), got " +
+                                 std::to_string(args.size()));
+    TWFrame f;
+    f.thisObj = thisObj;
+    f.cls     = cls;
+    f.vars.reserve(fn->params.size() + 8);
+    for (size_t i = 0; i < fn->params.size(); ++i)
+        f.vars.emplace_back(&fn->params[i].second, args[i]);
+
+    FrameGuard guard(callStack_, &f);
+    execBlock(fn->body);
+    return f.ret;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Statements
+// ─────────────────────────────────────────────────────────────────────────────
+
+TreeWalker::Flow TreeWalker::execBlock(const std::vector<std::unique_ptr<Statement>>& body) {
+    ScopeGuard scope(frame());
+    for (auto& st : body)
+        if (exec(st.get()) == Flow::Return) return Flow::Return;
+    return Flow::Next;
+}
+
+TreeWalker::Flow TreeWalker::exec(const Statement* stmt) {
+    // Definitions were registered up front; nested ones are ignored as in TIRGen.
+    if (dynamic_cast<const FunctionDef*>(stmt))     return Flow::Next;
+    if (dynamic_cast<const ClassDef*>(stmt))        return Flow::Next;
+    if (dynamic_cast<const ImportStatement*>(stmt)) return Flow::Next;
+
+    if (auto pr = dynamic_cast<const Print*>(stmt)) {
+        tlPrint(eval(pr->value.get()));
+        return Flow::Next;
+    }
+
+    if (auto ret = dynamic_cast<const Return*>(stmt)) {
+        frame().ret = ret->value ? eval(ret->value.get()) : TLValue::nil();
+        return Flow::Return;
+    }
+
+    if (auto asgn = dynamic_cast<const Assignment*>(stmt)) {
+        execAssign(asgn);
+        return Flow::Next;
+    }
+
+    if (auto es = dynamic_cast<const ExprStatement*>(stmt)) {
+        eval(es->expr.get());
+        return Flow::Next;
+    }
+
+    if (auto ifs = dynamic_cast<const IfStatement*>(stmt)) {
+        bool taken = eval(ifs->condition.get()).isTruthy();
+        return execBlock(taken ? ifs->thenBranch : ifs->elseBranch);
+    }
+
+    if (auto ws = dynamic_cast<const WhileStatement*>(stmt)) {
+        while (eval(ws->condition.get()).isTruthy())
+            if (execBlock(ws->body) == Flow::Return) return Flow::Return;
+        return Flow::Next;
+    }
+
+    if (auto fs = dynamic_cast<const ForStatement*>(stmt)) {
+        ScopeGuard scope(frame());
+        if (fs->initializer && exec(fs->initializer.get()) == Flow::Return)
+            return Flow::Return;
+        while (!fs->condition || eval(fs->condition.get()).isTruthy()) {
+            if (execBlock(fs->body) == Flow::Return) return Flow::Return;
+            if (fs->increment && exec(fs->increment.get()) == Flow::Return)
+                return Flow::Return;
+        }
+        return Flow::Next;
+    }
+
+    // ── Counter c(0); ──────────────────────────────────────────────────────
+    if (auto oi = dynamic_cast<const ObjectInstantiation*>(stmt)) {
+        TempMark mark(temps_);
+        std::vector<TLValue> args = evalArgs(oi->arguments);
+        TLObject* obj = newObject(oi->className);
+        TLValue   objVal = TLValue::fromObj(obj);
+        temps_.push_back(objVal);
+        if (!args.empty()) {
+            Method ctor = findMethod(oi->className, "init");
+            if (!ctor.fn) ctor = findMethod(oi->className, oi->className);
+            if (ctor.fn) callMethod(ctor, args, obj);
+        }
+        declare(oi->varName, objVal);
+        return Flow::Next;
+    }
+
+    // ── arr[i] = val; ──────────────────────────────────────────────────────
+    if (auto aa = dynamic_cast<const ArrayAssignment*>(stmt)) {
+        TempMark mark(temps_);
+        TLValue arrVal = load(aa->arrayName);
+        temps_.push_back(arrVal);
+        int     idx = eval(aa->index.get()).p.i;
+        TLValue val = eval(aa->value.get());
+        if (!arrVal.isArr() || !arrVal.p.arr)
+            throw std::runtime_error("tree-walk: array store on null/non-array");
+        auto& elems = arrVal.p.arr->elements;
+        if (idx < 0 || idx >= (int)elems.size())
+            throw std::runtime_error("tree-walk: array index out of bounds: " +
+                                     std::to_string(idx));
+        elems[idx] = std::move(val);
+        return Flow::Next;
+    }
+
+    throw std::runtime_error("tree-walk: unsupported statement type");
+}
+
+// Declarations and assignments, in the same cases and order as TIRGen.
+void TreeWalker::execAssign(const Assignment* asgn) {
+    const std::string& type = asgn->type;
+
+    // "ClassName[] arr = size;"
+    if (type.size() > 2 && type.substr(type.size()-2) == "[]") {
+        std::string elemType = type.substr(0, type.size()-2);
+        int size = asgn->value ? eval(asgn->value.get()).p.i : 0;
+        TLArray* arr = newArray(elemType);
+        arr->elements.resize(std::max(size, 0), TLValue::fromInt(0));
+        declare(asgn->name, TLValue::fromArr(arr));
+        return;
+    }
+
+    // "Person p;" — no constructor call
+    if (!type.empty() && classes_.count(type) && !asgn->value) {
+        declare(asgn->name, TLValue::fromObj(newObject(type)));
+        return;
+    }
+
+    // "obj.field = value", "this.field = value", "arr[i].field = value"
+    size_t dot = asgn->name.find('.');
+    if (dot != std::string::npos) {
+        std::string objPart = asgn->name.substr(0, dot);
+        std::string field   = asgn->name.substr(dot + 1);
+        TempMark mark(temps_);
+        TLValue val = eval(asgn->value.get());
+        temps_.push_back(val);
+
+        TLValue objVal;
+        if (objPart == "this") {
+            objVal = TLValue::fromObj(frame().thisObj);
+        } else if (size_t lb = objPart.find('['); lb != std::string::npos) {
+            TLValue arrVal = load(objPart.substr(0, lb));
+            std::string idxStr = objPart.substr(lb+1, objPart.size()-lb-2);
+            int idx;
+            try { idx = std::stoi(idxStr); }
+            catch (...) { idx = load(idxStr).p.i; }
+            if (!arrVal.isArr() || !arrVal.p.arr ||
+                idx < 0 || idx >= (int)arrVal.p.arr->elements.size())
+                throw std::runtime_error("tree-walk: bad array element in " + asgn->name);
+            objVal = arrVal.p.arr->elements[idx];
+        } else {
+            objVal = load(objPart);
+        }
+        if (!objVal.isObj() || !objVal.p.obj)
+            throw std::runtime_error("tree-walk: field store on null/non-object");
+        objVal.p.obj->setField(field, val);
+        return;
+    }
+
+    // "int[] arr = {1, 2, 3};"
+    if (auto al = dynamic_cast<const ArrayLiteral*>(asgn->value.get())) {
+        std::string elemType = "int";
+        if (!type.empty() && type.back() == ']') elemType = type.substr(0, type.size()-2);
+        else if (!type.empty())                  elemType = type;
+        TempMark mark(temps_);
+        std::vector<TLValue> elems = evalArgs(al->elements);
+        TLArray* arr = newArray(elemType);
+        arr->elements = std::move(elems);
+        if (!type.empty()) declare(asgn->name, TLValue::fromArr(arr));
+        else               store(asgn->name, TLValue::fromArr(arr));
+        return;
+    }
+
+    TLValue rhs = asgn->value ? eval(asgn->value.get()) : tlDefault(tyFromStr(type));
+    if (!type.empty()) declare(asgn->name, std::move(rhs));
+    else               store(asgn->name, std::move(rhs));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Expressions
+// ─────────────────────────────────────────────────────────────────────────────
+
+TLValue TreeWalker::eval(const Expr* expr) {
+    if (auto n = dynamic_cast<const Number*>(expr))        return TLValue::fromInt(n->value);
+    if (auto v = dynamic_cast<const Variable*>(expr)) {
+        if (v->name == "this") return TLValue::fromObj(frame().thisObj);
+        return load(v->name);
+    }
+
+    if (auto bin = dynamic_cast<const BinaryExpr*>(expr)) {
+        TempMark mark(temps_);
+        temps_.push_back(eval(bin->left.get()));
+        TLValue r = eval(bin->right.get());
+        const TLValue& l = temps_.back();
+        switch (bin->op) {
+        case TokenType::PLUS:           return tlArith(l, r, TIR::Op::Add);
+        case TokenType::MINUS:          return tlArith(l, r, TIR::Op::Sub);
+        case TokenType::MULTIPLICATION: return tlArith(l, r, TIR::Op::Mul);
+        case TokenType::DIVISION:       return tlArith(l, r, TIR::Op::Div);
+        case TokenType::EQUALTO:        return tlCompare(l, r, TIR::Op::CmpEq);
+        case TokenType::NOTEQUALTO:     return tlCompare(l, r, TIR::Op::CmpNe);
+        case TokenType::LESSTHEN:       return tlCompare(l, r, TIR::Op::CmpLt);
+        case TokenType::GREATERTHEN:    return tlCompare(l, r, TIR::Op::CmpGt);
+        case TokenType::AND: return TLValue::fromInt(l.isTruthy() && r.isTruthy() ? 1 : 0);
+        case TokenType::OR:  return TLValue::fromInt(l.isTruthy() || r.isTruthy() ? 1 : 0);
+        default:
+            throw std::runtime_error("tree-walk: unsupported binary operator");
+        }
+    }
+
+    if (auto fl = dynamic_cast<const FloatLiteral*>(expr))  return TLValue::fromFloat(fl->value);
+    if (auto ch = dynamic_cast<const CharLiteral*>(expr))   return TLValue::fromChar(ch->value);
+    if (auto bl = dynamic_cast<const BoolLiteral*>(expr))   return TLValue::fromInt(bl->value ? 1 : 0);
+    if (auto sl = dynamic_cast<const StringLiteral*>(expr)) return TLValue::fromStr(sl->value);
+
+    if (dynamic_cast<const InputExpr*>(expr))
+        return TLValue::fromInt(InBuf::instance().nextInt());
+
+    if (auto re = dynamic_cast<const ReadExpr*>(expr)) {
+        std::ifstream f(re->filename);
+        if (!f.is_open())
+            throw std::runtime_error("tree-walk: cannot open file: " + re->filename);
+        int val; f >> val;
+        return TLValue::fromInt(val);
+    }
+
+    if (auto un = dynamic_cast<const UnaryExpr*>(expr)) {
+        TLValue v = eval(un->operand.get());
+        if (un->op == TokenType::MINUS)
+            return v.isFloat() ? TLValue::fromFloat(-v.p.d) : TLValue::fromInt(-v.p.i);
+        if (un->op == TokenType::NOT)
+            return TLValue::fromInt(v.isTruthy() ? 0 : 1);
+        throw std::runtime_error("tree-walk: unsupported unary operator");
+    }
+
+    if (auto ce = dynamic_cast<const CastExpr*>(expr)) {
+        TIR::Op op = ce->targetType == "int"   ? TIR::Op::CastI32
+                   : ce->targetType == "float" ? TIR::Op::CastF64
+                   : ce->targetType == "char"  ? TIR::Op::CastChar
+                   : ce->targetType == "bool"  ? TIR::Op::CastI1
+                   :                             TIR::Op::CastStr;
+        return tlCast(eval(ce->operand.get()), op);
+    }
+
+    if (auto call = dynamic_cast<const CallExpr*>(expr)) {
+        TempMark mark(temps_);
+        std::vector<TLValue> args = evalArgs(call->arguments);
+        return callFunction(call->callee, args);
+    }
+
+    if (auto aa = dynamic_cast<const ArrayAccess*>(expr)) {
+        TempMark mark(temps_);
+        TLValue arrVal = load(aa->arrayName);
+        temps_.push_back(arrVal);
+        int idx = eval(aa->index.get()).p.i;
+        if (!arrVal.isArr() || !arrVal.p.arr)
+            throw std::runtime_error("tree-walk: array load on null/non-array");
+        const auto& elems = arrVal.p.arr->elements;
+        if (idx < 0 || idx >= (int)elems.size())
+            throw std::runtime_error("tree-walk: array index out of bounds: " +
+                                     std::to_string(idx));
+        return elems[idx];
+    }
+
+    if (auto al = dynamic_cast<const ArrayLiteral*>(expr)) {
+        TempMark mark(temps_);
+        std::vector<TLValue> elems = evalArgs(al->elements);
+        TLArray* arr = newArray("int");
+        arr->elements = std::move(elems);
+        return TLValue::fromArr(arr);
+    }
+
+    if (auto oma = dynamic_cast<const ObjectMemberAccess*>(expr)) {
+        TLValue objVal = eval(oma->object.get());
+        if (!objVal.isObj() || !objVal.p.obj)
+            throw std::runtime_error("tree-walk: field load on null/non-object");
+        return objVal.p.obj->getField(oma->member);
+    }
+
+    if (auto omc = dynamic_cast<const ObjectMethodCall*>(expr)) {
+        TempMark mark(temps_);
+        Method    m;
+        TLObject* obj = nullptr;
+        auto* vv = dynamic_cast<const Variable*>(omc->object.get());
+        if (vv && vv->name == "super") {
+            const ClassDef* cls = frame().cls;
+            if (!cls || cls->baseClass.empty())
+                throw std::runtime_error("tree-walk: no parent class for super call");
+            m   = findMethod(cls->baseClass, omc->method);
+            obj = frame().thisObj;
+            if (!m.fn)
+                throw std::runtime_error("tree-walk: super method not found: " + omc->method);
+        } else {
+            TLValue objVal = eval(omc->object.get());
+            if (!objVal.isObj() || !objVal.p.obj)
+                throw std::runtime_error("tree-walk: method call on null/non-object");
+            temps_.push_back(objVal);
+            obj = objVal.p.obj;
+            m   = findMethod(obj->className, omc->method);
+            if (!m.fn)
+                throw std::runtime_error("tree-walk: method not found: " +
+                                         obj->className + "::" + omc->method);
+        }
+        std::vector<TLValue> args = evalArgs(omc->arguments);
+        return callMethod(m, args, obj);
+    }
+
+    throw std::runtime_error("tree-walk: unsupported expression type");
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Public entry point
+// ─────────────────────────────────────────────────────────────────────────────
+
+void TreeWalker::run(const std::vector<std::unique_ptr<Statement>>& program) {
+    OutFlushGuard flushOnExit;
+    for (auto& st : program) {
+        if (auto cls = dynamic_cast<const ClassDef*>(st.get()))
+            classes_[cls->name] = cls;
+        else if (auto fn = dynamic_cast<const FunctionDef*>(st.get()))
+            funcs_[fn->name] = fn;
+    }
+
+    TWFrame top;
+    FrameGuard guard(callStack_, &top);
+    for (auto& st : program)
+        if (exec(st.get()) == Flow::Return) return;
+}
+
+void runTreeWalk(const std::vector<std::unique_ptr<Statement>>& program) {
+    TreeWalker tw;
+    tw.run(program);
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "ast.hpp"
+#include "natives.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// ---------------------------------------------------------------------------
+// TreeWalker – runs the checked AST directly (`--tree-walk`).
+//
+// A baseline tier for tiny one-shot scripts: there is no TIR lowering,
+// pruning or block layout, so startup is parse + semantic analysis only.
+// Per-node dispatch makes it slower than TIRVM once a script runs for a
+// while; benchmarks/run.sh measures the crossover.
+//
+// Semantics follow TIRGen + TIRVM, and the value model, heap and "__tl_*"
+// natives are the shared ones (object.hpp, natives.hpp):
+//   • each call gets fresh scopes — functions do not see top-level variables;
+//   • `&&` / `||` evaluate both operands;
+//   • a constructor runs only when arguments are given.
+// Methods read and write the fields of `this` in place instead of through
+// fields-as-locals copies.
+//
+// GC roots: for every frame on callStack_, its variables and `this`, plus
+// temps_ — expression values held while evaluating operands that may
+// allocate (call arguments, left operands, receivers).  Collection only
+// runs just before an allocation.
+// ---------------------------------------------------------------------------
+
+struct TWFrame {
+    // Variables of all open scopes, innermost last; names point into the AST.
+    std::vector<std::pair<const std::string*, TLValue>> vars;
+    TLObject*       thisObj = nullptr;
+    const ClassDef* cls     = nullptr;   // class defining the running method
+    TLValue         ret;                 // set by `return`
+};
+
+class TreeWalker {
+public:
+    void run(const std::vector<std::unique_ptr<Statement>>& program);
+
+private:
+    struct Method {
+        const FunctionDef* fn  = nullptr;
+        const ClassDef*    cls = nullptr;   // defining class
+    };
+
+    std::unordered_map<std::string, const ClassDef*>    classes_;
+    std::unordered_map<std::string, const FunctionDef*> funcs_;
+    std::unordered_map<std::string, Method>             methodCache_;
+    std::unordered_map<std::string, std::shared_ptr<const TLLayout>> layoutCache_;
+
+    TLHeap                 heap_;
+    std::vector<TWFrame*>  callStack_;
+    std::vector<TLValue>   temps_;
+    NativeLib              natives_{heap_, [this] { runGC(); }};
+
+    enum class Flow { Next, Return };
+
+    // RAII guards for callStack_, temps_ and a frame's scope.
+    struct FrameGuard {
+        std::vector<TWFrame*>& stack;
+        FrameGuard(std::vector<TWFrame*>& s, TWFrame* f) : stack(s) { s.push_back(f); }
+        ~FrameGuard() { stack.pop_back(); }
+    };
+    struct TempMark {
+        std::vector<TLValue>& temps;
+        size_t                mark;
+        explicit TempMark(std::vector<TLValue>& t) : temps(t), mark(t.size()) {}
+        ~TempMark() { temps.resize(mark); }
+    };
+    struct ScopeGuard {
+        TWFrame& frame;
+        size_t   mark;
+        explicit ScopeGuard(TWFrame& f) : frame(f), mark(f.vars.size()) {}
+        ~ScopeGuard() { frame.vars.resize(mark); }
+    };
+
+    TWFrame& frame() { return *callStack_.back(); }
+
+    // ── GC ────────────────────────────────────────────────────────────────
+    void runGC();
+    void maybeCollect() { if (heap_.shouldCollect()) runGC(); }
+
+    // ── Variables ─────────────────────────────────────────────────────────
+    void     declare(const std::string& name, TLValue v);
+    TLValue* findVar(const std::string& name);
+    TLValue  load(const std::string& name);
+    void     store(const std::string& name, TLValue v);
+
+    // ── Classes / calls ───────────────────────────────────────────────────
+    TIR::Type tyFromStr(const std::string& s) const;
+    const std::shared_ptr<const TLLayout>& layout(const std::string& cls);
+    TLObject* newObject(const std::string& cls);
+    TLArray*  newArray(const std::string& elemType);
+    Method    findMethod(const std::string& cls, const std::string& method);
+
+    // Evaluates args onto temps_ (caller holds a TempMark) and returns a copy.
+    std::vector<TLValue> evalArgs(const std::vector<std::unique_ptr<Expr>>& args);
+    TLValue callFunction(const std::string& name, const std::vector<TLValue>& args);
+    TLValue callMethod(const Method& m, const std::vector<TLValue>& args, TLObject* thisObj);
+    TLValue invoke(const FunctionDef* fn, const ClassDef* cls,
+                   const std::vector<TLValue>& args, TLObject* thisObj);
+
+    // ── Execution ─────────────────────────────────────────────────────────
+    Flow    execBlock(const std::vector<std::unique_ptr<Statement>>& body);
+    Flow    exec(const Statement* stmt);
+    void    execAssign(const Assignment* asgn);
+    TLValue eval(const Expr* expr);
+};
+
+void runTreeWalk(const std::vector<std::unique_ptr<Statement>>& program);
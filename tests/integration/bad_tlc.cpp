@@ -0,0 +1,37 @@
+// Writes stack-IR .tlc files whose call / allocation counts are out of
+// range; `make test` checks that the loader rejects each one as corrupt
+// instead of allocating from the bad count.
+//
+//   bad_tlc <prefix>   →  <prefix>_<case>.tlc, one file per case
+
+#include "bytecode.hpp"
+#include <climits>
+#include <iostream>
+#include <string>
+
+static IRInstr op(IROp o, const std::string& s = "", int i = 0) { return IRInstr{o, s, i}; }
+
+int main(int argc, char** argv) {
+    if (argc != 2) { std::cerr << "usage: bad_tlc <prefix>\n"; return 1; }
+    const std::string prefix = argv[1];
+
+    struct Case { const char* name; IRInstr ins; };
+    const Case cases[] = {
+        {"call_neg",        op(IROp::CALL,        "f",   -1)},
+        {"call_huge",       op(IROp::CALL,        "f",   INT_MAX)},
+        {"method_neg",      op(IROp::CALL_METHOD, "m",   -3)},
+        {"method_huge",     op(IROp::CALL_METHOD, "m",   1 << 28)},
+        {"super_huge",      op(IROp::CALL_SUPER,  "m",   1 << 28)},
+        {"new_obj_neg",     op(IROp::NEW_OBJ,     "C",   -2)},
+        {"new_obj_huge",    op(IROp::NEW_OBJ,     "C",   1 << 28)},
+        {"new_array_neg",   op(IROp::NEW_ARRAY,   "int", -2)},
+        {"new_array_huge",  op(IROp::NEW_ARRAY,   "int", INT_MAX)},
+    };
+    for (const Case& c : cases) {
+        IRProgram prog;
+        prog.main = {op(IROp::PUSH_INT, "", 1), c.ins, op(IROp::PRINT)};
+        std::string path = prefix + "_" + c.name + ".tlc";
+        if (!writeBytecode(prog, path)) { std::cerr << "cannot write " << path << "\n"; return 1; }
+    }
+    return 0;
+}